@@ -0,0 +1,30 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace enginetool {
+	namespace benchmark {
+		// Median wall time of several runs, in milliseconds.
+		inline double Measure(const std::function<void()>& body, uint32_t repetitions = 7) {
+			std::vector<double> samples;
+			samples.reserve(repetitions);
+			for (uint32_t i = 0; i < repetitions; i++) {
+				auto start = std::chrono::steady_clock::now();
+				body();
+				auto stop = std::chrono::steady_clock::now();
+				samples.push_back(std::chrono::duration<double, std::milli>(stop - start).count());
+			}
+			std::sort(samples.begin(), samples.end());
+			return samples[samples.size() / 2];
+		}
+
+		inline void Report(const std::string& name, const std::string& variant, uint32_t parameter, double value, const char* unit = "ms") {
+			std::printf("%-28s %-16s %8u %12.3f %s\n", name.c_str(), variant.c_str(), parameter, value, unit);
+		}
+	}
+}
@@ -0,0 +1,91 @@
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "src/MotionKernels.cpp"
+#include "src/FrustumCulling.cpp"
+
+namespace {
+	const float visibilityDistance = 3000.0f;
+
+	// Characters spread over the test scene's landscape, six arrays of bounds as BoxArrays reads them
+	std::vector<float> Crowd(uint32_t count) {
+		std::mt19937 generator(count);
+		std::uniform_real_distribution<float> place(-6000.0f, 6000.0f);
+		std::vector<float> bounds(count * 6);
+		for (uint32_t i = 0; i < count; i++) {
+			const float x = place(generator), z = place(generator);
+			const float values[6] = { x - 10.0f, 0.0f, z - 10.0f, x + 10.0f, 71.0f, z + 10.0f };
+			for (int bound = 0; bound < 6; bound++) bounds[bound * count + i] = values[bound];
+		}
+		return bounds;
+	}
+
+	enginetool::BoxArrays Arrays(const std::vector<float>& bounds, uint32_t count) {
+		enginetool::BoxArrays arrays;
+		for (int axis = 0; axis < 3; axis++) {
+			arrays.min[axis] = &bounds[axis * count];
+			arrays.max[axis] = &bounds[(3 + axis) * count];
+		}
+		return arrays;
+	}
+
+	// The camera of the test scene a little above the ground looking along -z, 60 degree field of view, as glm::perspective
+	// and glm::lookAt build it for UpdateStaticUniformBuffer
+	enginetool::Frustum Camera() {
+		const float nearPlane = 0.1f, farPlane = 5000.0f, focal = 1.0f / std::tan(0.5f * 60.0f * 3.14159265f / 180.0f);
+		float viewProjection[16] = {};
+		viewProjection[0] = focal / (16.0f / 9.0f);
+		viewProjection[5] = -focal;
+		viewProjection[10] = farPlane / (nearPlane - farPlane);
+		viewProjection[11] = -1.0f;
+		// The view moves the world 100 units down, the projection then flips y for Vulkan
+		viewProjection[13] = focal * 100.0f;
+		viewProjection[14] = -(farPlane * nearPlane) / (farPlane - nearPlane);
+		return enginetool::ExtractFrustum(viewProjection);
+	}
+
+	// What Scene::CheckIfItIsVisible did: distance from the main character's position
+	double Distance(const std::vector<float>& bounds, uint32_t count, std::vector<uint8_t>& visible) {
+		return enginetool::benchmark::Measure([&]() {
+			for (uint32_t i = 0; i < count; i++) {
+				const float x = (bounds[i] + bounds[3 * count + i]) * 0.5f, z = (bounds[2 * count + i] + bounds[5 * count + i]) * 0.5f;
+				visible[i] = std::sqrt(x * x + z * z) <= visibilityDistance;
+			}
+		});
+	}
+
+	double Cull(enginetool::SimdLevel level, const std::vector<float>& bounds, uint32_t count, std::vector<uint8_t>& visible) {
+		const enginetool::Frustum frustum = Camera();
+		return enginetool::benchmark::Measure([&]() {
+			enginetool::CullBoxes(level, frustum, Arrays(bounds, count), count, visible.data());
+		});
+	}
+
+	uint32_t Count(const std::vector<uint8_t>& visible) {
+		uint32_t total = 0;
+		for (uint8_t v : visible) total += v;
+		return total;
+	}
+}
+
+int main(int argc, char* argv[]) {
+	uint32_t maxActors = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 1000000;
+
+	for (uint32_t actors = 1000; actors <= maxActors; actors *= 10) {
+		const std::vector<float> bounds = Crowd(actors);
+		std::vector<uint8_t> visible(actors);
+		enginetool::benchmark::Report("cull_actors", "distance", actors, Distance(bounds, actors, visible));
+		enginetool::benchmark::Report("cull_actors", "distance drawn", actors, Count(visible), "actors");
+		for (int level = 0; level <= static_cast<int>(enginetool::GetSupportedSimdLevel()); level++) {
+			const auto simd = static_cast<enginetool::SimdLevel>(level);
+			enginetool::benchmark::Report("cull_actors", std::string("frustum ") + enginetool::GetSimdLevelName(simd), actors, Cull(simd, bounds, actors, visible));
+		}
+		enginetool::benchmark::Report("cull_actors", "frustum drawn", actors, Count(visible), "actors");
+	}
+
+	return 0;
+}
\ No newline at end of file
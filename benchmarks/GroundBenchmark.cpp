@@ -0,0 +1,88 @@
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "src/AabbTree.cpp"
+#include "src/Heightfield.cpp"
+
+namespace {
+	const uint32_t probes = 10000;
+
+	// Landscape tiles of the test scene's plane size laid out as terraces, each a little higher or lower than the last
+	std::vector<float> Terraces(uint32_t tiles) {
+		std::mt19937 generator(tiles);
+		std::uniform_real_distribution<float> step(-2.0f, 2.0f);
+		const uint32_t side = static_cast<uint32_t>(std::sqrt(static_cast<float>(tiles)));
+		std::vector<float> bounds;
+		float height = 0.0f;
+		for (uint32_t i = 0; i < tiles; i++) {
+			const float x = static_cast<float>(i % side) * 40.0f, z = static_cast<float>(i / side) * 40.0f;
+			height += step(generator);
+			bounds.insert(bounds.end(), { x, height - 1.0f, z, x + 40.0f, height, z + 40.0f });
+		}
+		return bounds;
+	}
+
+	std::vector<float> Characters(uint32_t tiles) {
+		std::mt19937 generator(7);
+		const float side = std::sqrt(static_cast<float>(tiles)) * 40.0f;
+		std::uniform_real_distribution<float> place(0.0f, side);
+		std::vector<float> positions;
+		for (uint32_t i = 0; i < probes; i++) {
+			positions.insert(positions.end(), { place(generator), 500.0f, place(generator) });
+		}
+		return positions;
+	}
+
+	// What Actor::DetectGroundLevel did for static ground before: a downward ray through the tree
+	double Probe(uint32_t tiles) {
+		const std::vector<float> bounds = Terraces(tiles);
+		const std::vector<float> positions = Characters(tiles);
+		enginetool::AabbTree tree;
+		for (uint32_t i = 0; i < tiles; i++) tree.Insert(i, &bounds[i * 6], &bounds[i * 6 + 3]);
+		tree.Build();
+		float sum = 0.0f;
+		return enginetool::benchmark::Measure([&]() {
+			for (uint32_t i = 0; i < probes; i++) {
+				const enginetool::AabbTree::RayHit hit = tree.ProbeDown(&positions[i * 3], -20.0f);
+				sum += hit.distance;
+			}
+		});
+	}
+
+	// The heightfield, with the ray cast kept for the cells it leaves out
+	double Field(uint32_t tiles) {
+		const std::vector<float> bounds = Terraces(tiles);
+		const std::vector<float> positions = Characters(tiles);
+		enginetool::AabbTree tree;
+		enginetool::Heightfield field(8.0f);
+		for (uint32_t i = 0; i < tiles; i++) {
+			tree.Insert(i, &bounds[i * 6], &bounds[i * 6 + 3]);
+			field.Insert(&bounds[i * 6], &bounds[i * 6 + 3]);
+		}
+		tree.Build();
+		field.Build();
+		float sum = 0.0f;
+		return enginetool::benchmark::Measure([&]() {
+			for (uint32_t i = 0; i < probes; i++) {
+				float level;
+				if (!field.GroundLevel(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2], level)) {
+					level = tree.ProbeDown(&positions[i * 3], -20.0f).distance;
+				}
+				sum += level;
+			}
+		});
+	}
+}
+
+int main(int argc, char* argv[]) {
+	uint32_t maxTiles = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 100000;
+
+	for (uint32_t tiles = 100; tiles <= maxTiles; tiles *= 10) {
+		enginetool::benchmark::Report("ground_10000_characters", "ray", tiles, Probe(tiles));
+		enginetool::benchmark::Report("ground_10000_characters", "heightfield", tiles, Field(tiles));
+	}
+
+	return 0;
+}
\ No newline at end of file
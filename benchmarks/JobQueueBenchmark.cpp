@@ -0,0 +1,96 @@
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "Benchmark.hpp"
+#include "headers/Threads.hpp"
+
+// The queue the workers used before: a deque behind one mutex, and a condition variable signalled for every job.
+namespace legacy {
+	class JobQueue {
+	public:
+		void Push(enginetool::Job&& job) {
+			std::lock_guard<std::mutex> lock(queueMutex);
+			jobQueue.push_back(std::move(job));
+			condition.notify_one();
+		}
+
+		bool TryPop(enginetool::Job& job) {
+			std::lock_guard<std::mutex> lock(queueMutex);
+			if (jobQueue.empty()) {
+				return false;
+			}
+			job = std::move(jobQueue.front());
+			jobQueue.pop_front();
+			return true;
+		}
+
+	private:
+		std::deque<enginetool::Job> jobQueue;
+		std::mutex queueMutex;
+		std::condition_variable condition;
+	};
+}
+
+namespace {
+	const uint32_t jobsPerProducer = 200000;
+
+	// Producers push empty jobs while the same number of consumers pop and run them, the result is the time to drain everything.
+	template<typename Push, typename Pop>
+	double Drain(uint32_t threadsPerSide, Push push, Pop pop) {
+		return enginetool::benchmark::Measure([&]() {
+			std::atomic<uint64_t> consumed{ 0 };
+			const uint64_t total = static_cast<uint64_t>(jobsPerProducer) * threadsPerSide;
+			std::vector<std::thread> threads;
+
+			for (uint32_t i = 0; i < threadsPerSide; i++) {
+				threads.emplace_back([&push]() {
+					for (uint32_t job = 0; job < jobsPerProducer; job++) {
+						push(enginetool::Job{ []() {}, nullptr });
+					}
+				});
+				threads.emplace_back([&pop, &consumed, total]() {
+					enginetool::Job job;
+					while (consumed.load(std::memory_order_relaxed) < total) {
+						if (pop(job)) {
+							job.function();
+							consumed.fetch_add(1, std::memory_order_relaxed);
+						}
+						else {
+							std::this_thread::yield();
+						}
+					}
+				});
+			}
+
+			for (auto& thread : threads) {
+				thread.join();
+			}
+		}, 3);
+	}
+}
+
+int main(int argc, char* argv[]) {
+	uint32_t maxThreads = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 8;
+
+	for (uint32_t threadsPerSide = 1; threadsPerSide <= maxThreads; threadsPerSide *= 2) {
+		const double jobs = static_cast<double>(jobsPerProducer) * threadsPerSide;
+
+		legacy::JobQueue mutexQueue;
+		double time = Drain(threadsPerSide,
+			[&mutexQueue](enginetool::Job&& job) { mutexQueue.Push(std::move(job)); },
+			[&mutexQueue](enginetool::Job& job) { return mutexQueue.TryPop(job); });
+		enginetool::benchmark::Report("enqueue/dequeue", "mutex deque", threadsPerSide, jobs / time / 1000.0, "Mjobs/s");
+
+		enginetool::BoundedQueue<enginetool::Job> ringQueue(1024);
+		time = Drain(threadsPerSide,
+			[&ringQueue](enginetool::Job&& job) { while (!ringQueue.TryPush(std::move(job))) std::this_thread::yield(); },
+			[&ringQueue](enginetool::Job& job) { return ringQueue.TryPop(job); });
+		enginetool::benchmark::Report("enqueue/dequeue", "lock-free ring", threadsPerSide, jobs / time / 1000.0, "Mjobs/s");
+	}
+
+	return 0;
+}
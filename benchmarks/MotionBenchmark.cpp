@@ -0,0 +1,111 @@
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "src/MotionKernels.cpp"
+
+// The per-actor path the scene used before: heap allocated actors updated through a virtual call, three Approach calls each.
+namespace legacy {
+	struct Vec3 {
+		float x, y, z;
+	};
+
+	class Actor {
+	public:
+		Actor(std::string name) : name(name) {}
+		virtual ~Actor() = default;
+
+		virtual void UpdatePosition(float dt) = 0;
+
+		float Approach(float goal, float current, float dt) {
+			float difference = goal - current;
+			if (difference > dt) return current + dt;
+			if (difference < -dt) return current - dt;
+			return goal;
+		}
+
+		std::string name;
+		Vec3 position = { 0.0f, 0.0f, 0.0f };
+		Vec3 movement = { 0.0f, 0.0f, 0.0f };
+		Vec3 movementGoal = { 0.0f, 0.0f, 0.0f };
+	};
+
+	class Character : public Actor {
+	public:
+		Character(std::string name) : Actor(name) {}
+
+		void UpdatePosition(float dt) override {
+			movement.x = Approach(movementGoal.x, movement.x, dt * 1000.0f);
+			movement.y = Approach(movementGoal.y, movement.y, dt * 1000.0f);
+			movement.z = Approach(movementGoal.z, movement.z, dt * 1000.0f);
+			position.x += movement.x * dt;
+			position.y += movement.y * dt;
+			position.z += movement.z * dt;
+		}
+	};
+}
+
+namespace {
+	const float dt = 1.0f / 60.0f;
+	const uint32_t ticks = 60;
+
+	std::vector<float> RandomGoals(uint32_t actors) {
+		std::mt19937 generator(actors);
+		std::uniform_real_distribution<float> distribution(-50.0f, 50.0f);
+		std::vector<float> goals(actors * 3);
+		for (auto& goal : goals) {
+			goal = distribution(generator);
+		}
+		return goals;
+	}
+
+	double Legacy(uint32_t actors) {
+		const std::vector<float> goals = RandomGoals(actors);
+		std::vector<std::shared_ptr<legacy::Actor>> scene;
+		for (uint32_t i = 0; i < actors; i++) {
+			auto character = std::make_shared<legacy::Character>("character_" + std::to_string(i));
+			character->movementGoal = { goals[i * 3], goals[i * 3 + 1], goals[i * 3 + 2] };
+			scene.push_back(character);
+		}
+
+		return enginetool::benchmark::Measure([&]() {
+			for (uint32_t tick = 0; tick < ticks; tick++) {
+				for (auto& actor : scene) {
+					actor->UpdatePosition(dt);
+				}
+			}
+		});
+	}
+
+	double Kernel(enginetool::SimdLevel level, uint32_t actors) {
+		const std::vector<float> goals = RandomGoals(actors);
+		std::vector<float> positions(actors * 3, 0.0f);
+		std::vector<float> movements(actors * 3, 0.0f);
+
+		return enginetool::benchmark::Measure([&]() {
+			for (uint32_t tick = 0; tick < ticks; tick++) {
+				enginetool::ApproachAndIntegrate(level, positions.data(), movements.data(), goals.data(), positions.size(), dt * 1000.0f, dt);
+			}
+		});
+	}
+}
+
+int main(int argc, char* argv[]) {
+	uint32_t maxActors = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 100000;
+	const enginetool::SimdLevel levels[] = { enginetool::SimdLevel::Scalar, enginetool::SimdLevel::SSE2, enginetool::SimdLevel::AVX2 };
+
+	for (uint32_t actors = 1000; actors <= maxActors; actors *= 10) {
+		enginetool::benchmark::Report("update_positions_60_ticks", "legacy", actors, Legacy(actors));
+		for (auto level : levels) {
+			if (level > enginetool::GetSupportedSimdLevel()) {
+				continue;
+			}
+			enginetool::benchmark::Report("update_positions_60_ticks", enginetool::GetSimdLevelName(level), actors, Kernel(level, actors));
+		}
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "src/Narrowphase.cpp"
+#include "src/SpatialHash.cpp"
+#include "src/Threads.cpp"
+
+namespace {
+	const uint32_t characters = 50000;
+
+	// Characters of the test scene crowded on a landscape, a few hundred of them close enough to touch
+	std::vector<float> Crowd() {
+		std::mt19937 generator(24);
+		std::uniform_real_distribution<float> place(-6000.0f, 6000.0f);
+		std::vector<float> boxes;
+		for (uint32_t i = 0; i < characters; i++) {
+			const float x = place(generator), z = place(generator);
+			boxes.insert(boxes.end(), { x - 10.0f, 0.0f, z - 10.0f, x + 10.0f, 71.0f, z + 10.0f });
+		}
+		return boxes;
+	}
+
+	// What Actor::CheckCollisions did for every character in turn: a broadphase query and an overlap test per candidate
+	double PerActor(const enginetool::SpatialHash& broadphase, const std::vector<float>& boxes) {
+		std::vector<uint32_t> candidates;
+		size_t contacts = 0;
+		return enginetool::benchmark::Measure([&]() {
+			for (uint32_t i = 0; i < characters; i++) {
+				const float* box = &boxes[i * 6];
+				candidates.clear();
+				broadphase.Query(box, box + 3, candidates);
+				for (uint32_t other : candidates) {
+					const float* b = &boxes[other * 6];
+					if (other != i && box[3] >= b[0] && box[0] <= b[3] && box[4] >= b[1] && box[1] <= b[4] && box[5] >= b[2] && box[2] <= b[5]) contacts++;
+				}
+			}
+		});
+	}
+
+	double Contacts(enginetool::ThreadPool* pool, const enginetool::SpatialHash& broadphase, const std::vector<float>& boxes) {
+		enginetool::Narrowphase narrowphase;
+		std::vector<enginetool::Narrowphase::Contact> contacts;
+		return enginetool::benchmark::Measure([&]() {
+			contacts.clear();
+			narrowphase.FindContacts(pool, broadphase, boxes.data(), contacts);
+		});
+	}
+}
+
+int main(int argc, char* argv[]) {
+	uint32_t maxThreads = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 16;
+
+	const std::vector<float> boxes = Crowd();
+	enginetool::SpatialHash broadphase(64.0f);
+	for (uint32_t i = 0; i < characters; i++) broadphase.Insert(i, &boxes[i * 6], &boxes[i * 6 + 3]);
+	broadphase.Build();
+
+	enginetool::benchmark::Report("contacts_50000_characters", "per-actor", 1, PerActor(broadphase, boxes));
+	enginetool::benchmark::Report("contacts_50000_characters", "narrowphase", 1, Contacts(nullptr, broadphase, boxes));
+	// The calling thread works as well, so a pool of threadCount - 1 workers uses threadCount cores
+	for (uint32_t threadCount = 2; threadCount <= maxThreads; threadCount *= 2) {
+		enginetool::ThreadPool pool;
+		pool.SetThreadCount(threadCount - 1);
+		enginetool::benchmark::Report("contacts_50000_characters", "narrowphase", threadCount, Contacts(&pool, broadphase, boxes));
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "src/AabbTree.cpp"
+#include "src/MotionKernels.cpp"
+#include "src/RayKernels.cpp"
+
+namespace {
+	const uint32_t rays = 1000;
+
+	// Actor sized boxes spread over a square kilometre, as six arrays
+	std::vector<float> RandomBoxes(uint32_t boxes) {
+		std::mt19937 generator(boxes);
+		std::uniform_real_distribution<float> place(-5000.0f, 5000.0f);
+		std::uniform_real_distribution<float> size(4.0f, 70.0f);
+		std::vector<float> bounds(boxes * 6);
+		for (uint32_t i = 0; i < boxes; i++) {
+			for (int axis = 0; axis < 3; axis++) {
+				bounds[axis * boxes + i] = place(generator) * ((axis == 1) ? 0.01f : 1.0f);
+				bounds[(3 + axis) * boxes + i] = bounds[axis * boxes + i] + size(generator);
+			}
+		}
+		return bounds;
+	}
+
+	enginetool::BoxArrays Arrays(const std::vector<float>& bounds, uint32_t boxes) {
+		enginetool::BoxArrays arrays;
+		for (int axis = 0; axis < 3; axis++) {
+			arrays.min[axis] = &bounds[axis * boxes];
+			arrays.max[axis] = &bounds[(3 + axis) * boxes];
+		}
+		return arrays;
+	}
+
+	// Picking rays from above, looking down at the scene
+	std::vector<float> RandomRays() {
+		std::mt19937 generator(7);
+		std::uniform_real_distribution<float> place(-5000.0f, 5000.0f);
+		std::uniform_real_distribution<float> turn(-0.5f, 0.5f);
+		std::vector<float> origins, dirFracs;
+		for (uint32_t i = 0; i < rays; i++) {
+			origins.insert(origins.end(), { place(generator), 2000.0f, place(generator) });
+			dirFracs.insert(dirFracs.end(), { 1.0f / turn(generator), -1.0f, 1.0f / turn(generator) });
+		}
+		origins.insert(origins.end(), dirFracs.begin(), dirFracs.end());
+		return origins;
+	}
+
+	// One ray at a time through every box, what picking did before the tree
+	double Linear(enginetool::SimdLevel level, uint32_t boxes) {
+		const std::vector<float> bounds = RandomBoxes(boxes);
+		const std::vector<float> ray = RandomRays();
+		size_t hits = 0;
+		return enginetool::benchmark::Measure([&]() {
+			for (uint32_t i = 0; i < rays; i++) {
+				float distance;
+				hits += enginetool::NearestRayBox(level, &ray[i * 3], &ray[(rays + i) * 3], Arrays(bounds, boxes), boxes, 1.0e6f, distance) != boxes;
+			}
+		});
+	}
+
+	// The same rays through an AabbTree, for scale
+	double Tree(uint32_t boxes) {
+		const std::vector<float> bounds = RandomBoxes(boxes);
+		const std::vector<float> ray = RandomRays();
+		enginetool::AabbTree tree;
+		for (uint32_t i = 0; i < boxes; i++) {
+			const float min[3] = { bounds[i], bounds[boxes + i], bounds[2 * boxes + i] };
+			const float max[3] = { bounds[3 * boxes + i], bounds[4 * boxes + i], bounds[5 * boxes + i] };
+			tree.Insert(i, min, max);
+		}
+		tree.Build();
+		size_t hits = 0;
+		return enginetool::benchmark::Measure([&]() {
+			for (uint32_t i = 0; i < rays; i++) {
+				const float* dirFrac = &ray[(rays + i) * 3];
+				const float direction[3] = { 1.0f / dirFrac[0], 1.0f / dirFrac[1], 1.0f / dirFrac[2] };
+				hits += tree.Raycast(&ray[i * 3], direction, 1.0e6f).id != enginetool::AabbTree::RayHit().id;
+			}
+		});
+	}
+}
+
+int main(int argc, char* argv[]) {
+	uint32_t maxBoxes = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 100000;
+	const enginetool::SimdLevel levels[] = { enginetool::SimdLevel::Scalar, enginetool::SimdLevel::SSE2, enginetool::SimdLevel::AVX2 };
+
+	for (uint32_t boxes = 1000; boxes <= maxBoxes; boxes *= 10) {
+		for (auto level : levels) {
+			if (level > enginetool::GetSupportedSimdLevel()) {
+				continue;
+			}
+			enginetool::benchmark::Report("nearest_hit_1000_rays", enginetool::GetSimdLevelName(level), boxes, Linear(level, boxes));
+		}
+		enginetool::benchmark::Report("nearest_hit_1000_rays", "tree", boxes, Tree(boxes));
+	}
+
+	return 0;
+}
\ No newline at end of file
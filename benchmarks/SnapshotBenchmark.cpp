@@ -0,0 +1,179 @@
+#include <array>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "headers/Handle.hpp"
+#include "headers/ObjectPool.hpp"
+#include "src/NameTable.cpp"
+#include "src/SceneSnapshot.cpp"
+
+// Engine actors pull in Vulkan through their mesh and texture types, so both paths build a stand-in scene with the same
+// per-actor work as Scene: name interning, mesh and material lookups, a pooled actor, a handle and a bucket entry.
+namespace {
+	struct Part {};
+	struct Material {};
+
+	struct Actor {
+		Actor(enginetool::NameId name, enginetool::NameId description, const float* position) : name(name), description(description) {
+			for (int i = 0; i < 3; i++) this->position[i] = position[i];
+		}
+
+		enginetool::NameId name;
+		enginetool::NameId description;
+		float position[3];
+		Part* mesh = nullptr;
+		Material* material = nullptr;
+		uint32_t maxHealth = 0;
+		int32_t currentHealth = 0;
+		enginetool::Handle<Actor> handle;
+	};
+
+	struct Scene {
+		Scene() {
+			for (const char* mesh : { "box", "coin", "human", "plane", "sphere", "teapot" }) meshes[mesh];
+			for (const char* material : { "character", "chrome", "default", "gold", "plastic", "rust" }) materials[material];
+		}
+
+		Actor* Create(enginetool::NameId name, enginetool::NameId description, const float* position, Part& mesh, Material& material) {
+			auto actor = pool.MakeShared(name, description, position);
+			actor->mesh = &mesh;
+			actor->material = &material;
+			actor->handle = handles.Insert(actor.get());
+			bucket.push_back(actor.get());
+			actors.push_back(std::move(actor));
+			return bucket.back();
+		}
+
+		// Scene::CreateLandscape, called once per line of LoadAssets
+		void CreateLandscape(std::string name, std::string description, const float* position, Part& mesh, Material& material) {
+			Create(names.Intern(name), names.Intern(description), position, mesh, material)->maxHealth = 1000;
+		}
+
+		// Scene::LoadSnapshot
+		bool LoadSnapshot(const std::string& path) {
+			enginetool::SceneSnapshot snapshot;
+			if (!snapshot.Open(path)) {
+				return false;
+			}
+			const enginetool::snapshot::Header& header = snapshot.GetHeader();
+			const enginetool::snapshot::ActorRecord* records = snapshot.GetActors();
+
+			std::vector<Part*> resolvedMeshes(header.stringCount, nullptr);
+			std::vector<Material*> resolvedMaterials(header.stringCount, nullptr);
+			for (uint32_t i = 0; i < header.actorCount; i++) {
+				if (resolvedMeshes[records[i].mesh] == nullptr) {
+					auto mesh = meshes.find(snapshot.GetString(records[i].mesh));
+					resolvedMeshes[records[i].mesh] = (mesh != meshes.end()) ? &mesh->second : nullptr;
+				}
+				if (resolvedMaterials[records[i].material] == nullptr) {
+					auto material = materials.find(snapshot.GetString(records[i].material));
+					resolvedMaterials[records[i].material] = (material != materials.end()) ? &material->second : nullptr;
+				}
+				if (resolvedMeshes[records[i].mesh] == nullptr || resolvedMaterials[records[i].material] == nullptr) {
+					return false;
+				}
+			}
+
+			std::vector<enginetool::NameId> ids(header.stringCount);
+			for (uint32_t i = 0; i < header.stringCount; i++) {
+				ids[i] = names.Intern(snapshot.GetString(i));
+			}
+
+			pool.Reserve(header.actorCount);
+			enginetool::ReserveMore(actors, header.actorCount);
+			enginetool::ReserveMore(bucket, header.actorCount);
+			for (uint32_t i = 0; i < header.actorCount; i++) {
+				const enginetool::snapshot::ActorRecord& record = records[i];
+				Actor* actor = Create(ids[record.name], ids[record.description], record.position, *resolvedMeshes[record.mesh], *resolvedMaterials[record.material]);
+				actor->maxHealth = record.maxHealth;
+				actor->currentHealth = record.currentHealth;
+			}
+			return true;
+		}
+
+		std::map<std::string, Part> meshes;
+		std::map<std::string, Material> materials;
+		enginetool::NameTable names;
+		enginetool::ObjectPool<Actor> pool;
+		enginetool::HandleTable<Actor> handles;
+		std::vector<std::shared_ptr<Actor>> actors;
+		std::vector<Actor*> bucket;
+	};
+
+	// A scene written out in code: every actor has a name of its own and the same few descriptions, meshes and materials
+	struct SceneSource {
+		explicit SceneSource(uint32_t actors) {
+			for (uint32_t i = 0; i < actors; i++) {
+				names.push_back("Test object plane" + std::to_string(i));
+				positions.push_back({ static_cast<float>(i % 1000) * 10.0f, -1.0f, static_cast<float>(i / 1000) * 40.0f });
+			}
+		}
+
+		std::vector<std::string> names;
+		std::vector<std::array<float, 3>> positions;
+		const char* description = "I am simple plane, boring";
+		const char* mesh = "plane";
+		const char* material = "default";
+	};
+
+	// Rebuilding from code, like LoadAssets. Names come in as string literals there, so they are passed as const char* here as well.
+	void Code(const SceneSource& source) {
+		const uint32_t actors = static_cast<uint32_t>(source.names.size());
+		const double milliseconds = enginetool::benchmark::Measure([&]() {
+			Scene scene;
+			for (uint32_t i = 0; i < actors; i++) {
+				scene.CreateLandscape(source.names[i].c_str(), source.description, source.positions[i].data(), scene.meshes[source.mesh], scene.materials[source.material]);
+			}
+		});
+		enginetool::benchmark::Report("scene_load", "code", actors, milliseconds);
+	}
+
+	// Loading the same scene from a snapshot. After the first run the file is in the page cache, as it is for a game restarted
+	// during development; a cold start adds one sequential read of the file.
+	void Snapshot(const SceneSource& source) {
+		const uint32_t actors = static_cast<uint32_t>(source.names.size());
+		const std::string path = "snapshotBenchmark.pscn";
+		enginetool::SceneSnapshotWriter writer;
+		for (uint32_t i = 0; i < actors; i++) {
+			enginetool::snapshot::ActorRecord record = {};
+			record.type = 1;
+			record.name = writer.AddString(source.names[i]);
+			record.description = writer.AddString(source.description);
+			record.mesh = writer.AddString(source.mesh);
+			record.material = writer.AddString(source.material);
+			for (int j = 0; j < 3; j++) record.position[j] = source.positions[i][j];
+			record.maxHealth = 1000;
+			record.currentHealth = 1000;
+			writer.AddActor(record);
+		}
+		if (!writer.Save(path)) {
+			std::printf("could not write %s\n", path.c_str());
+			return;
+		}
+
+		bool loaded = true;
+		const double milliseconds = enginetool::benchmark::Measure([&]() {
+			Scene scene;
+			loaded = scene.LoadSnapshot(path) && loaded;
+		});
+		std::remove(path.c_str());
+		if (!loaded) {
+			std::printf("could not load %s\n", path.c_str());
+			return;
+		}
+		enginetool::benchmark::Report("scene_load", "snapshot", actors, milliseconds);
+	}
+}
+
+int main() {
+	for (uint32_t actors : { 1000u, 10000u, 100000u, 1000000u }) {
+		const SceneSource source(actors);
+		Code(source);
+		Snapshot(source);
+	}
+	return 0;
+}
\ No newline at end of file
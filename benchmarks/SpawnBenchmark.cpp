@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define BOOST_PENDING_INTEGER_LOG2_HPP
+#include <boost/uuid/uuid.hpp>
+#include <boost/uuid/uuid_generators.hpp>
+#include <boost/uuid/uuid_io.hpp>
+
+#include "Benchmark.hpp"
+#include "headers/ActorRoster.hpp"
+
+// How Scene created actors before: one make_shared each, a random UUID in the constructor and arrays grown one push at a time.
+// The "Actor created" log line is left out, it would only measure the terminal.
+namespace legacy {
+	class Actor {
+	public:
+		Actor(std::string name, std::string description, glm::vec3 position) : name(name), description(description), position(position) {
+			id = boost::uuids::to_string(boost::uuids::random_generator()());
+		}
+		virtual ~Actor() = default;
+
+		std::string id;
+		std::string name;
+		std::string description;
+		glm::vec3 position;
+		glm::vec3 movement = glm::vec3(0.0f, 0.0f, 0.0f);
+		glm::vec3 movementGoal = glm::vec3(0.0f, 0.0f, 0.0f);
+	};
+
+	struct Scene {
+		void Spawn(const std::vector<glm::vec3>& positions) {
+			for (const auto& position : positions) {
+				auto actor = std::make_shared<Actor>("character", "Bulk spawned", position);
+				actors.push_back(actor);
+				bucket.push_back(actor.get());
+			}
+		}
+
+		void DespawnAll() {
+			bucket.clear();
+			actors.clear();
+		}
+
+		std::vector<std::shared_ptr<Actor>> actors;
+		std::vector<Actor*> bucket;
+	};
+}
+
+namespace {
+	std::vector<glm::vec3> Positions(uint32_t actors) {
+		std::vector<glm::vec3> positions(actors);
+		for (uint32_t i = 0; i < actors; i++) {
+			positions[i] = glm::vec3(static_cast<float>(i % 1000), 0.0f, static_cast<float>(i / 1000));
+		}
+		return positions;
+	}
+
+	double ActorsPerSecond(uint32_t actors, double milliseconds) {
+		return actors / (milliseconds / 1000.0);
+	}
+
+	// Actors per second through a whole spawn and despawn of the batch
+	void Legacy(uint32_t actors) {
+		const std::vector<glm::vec3> positions = Positions(actors);
+		legacy::Scene scene;
+		const double milliseconds = enginetool::benchmark::Measure([&]() {
+			scene.Spawn(positions);
+			scene.DespawnAll();
+		});
+		enginetool::benchmark::Report("spawn_despawn", "legacy", actors, ActorsPerSecond(actors, milliseconds), "actors/s");
+	}
+
+	// The roster Scene spawns and despawns through, with real characters: pooled, handles, motion slots, buckets and wake queue
+	void Pooled(uint32_t actors) {
+		const std::vector<glm::vec3> positions = Positions(actors);
+		enginetool::ScenePart mesh;
+		enginetool::SceneMaterial material;
+		enginetool::ActorRoster roster;
+		std::vector<enginetool::Handle<Actor>> spawned;
+		// The first run grows the pool and arrays, later runs reuse them the way a running game does
+		const double milliseconds = enginetool::benchmark::Measure([&]() {
+			spawned.clear();
+			roster.Spawn(ActorType::Character, "character", positions, mesh, material, spawned);
+			roster.Despawn(spawned);
+		});
+		enginetool::benchmark::Report("spawn_despawn", "pooled", actors, ActorsPerSecond(actors, milliseconds), "actors/s");
+	}
+}
+
+int main() {
+	for (uint32_t actors : { 1000u, 10000u, 100000u, 1000000u }) {
+		Legacy(actors);
+		Pooled(actors);
+	}
+	return 0;
+}
\ No newline at end of file
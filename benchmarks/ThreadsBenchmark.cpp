@@ -0,0 +1,117 @@
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <queue>
+
+#include "Benchmark.hpp"
+#include "headers/Threads.hpp"
+
+// Copy of the previous pool (one mutex/condition queue per thread, round-robin submission, Hold waits on each thread in turn), kept as the baseline.
+namespace legacy {
+	class Thread {
+	public:
+		Thread() { worker = std::thread(&Thread::QueueLoop, this); }
+		~Thread() {
+			Wait();
+			{
+				std::lock_guard<std::mutex> lock(queueMutex);
+				destroying = true;
+				condition.notify_one();
+			}
+			worker.join();
+		}
+
+		void AddJob(std::function<void()> function) {
+			std::lock_guard<std::mutex> lock(queueMutex);
+			jobQueue.push(std::move(function));
+			condition.notify_one();
+		}
+
+		void Wait() {
+			std::unique_lock<std::mutex> lock(queueMutex);
+			condition.wait(lock, [this]() { return jobQueue.empty(); });
+		}
+
+	private:
+		bool destroying = false;
+		std::thread worker;
+		std::queue<std::function<void()>> jobQueue;
+		std::mutex queueMutex;
+		std::condition_variable condition;
+
+		void QueueLoop() {
+			while (true) {
+				std::function<void()> job;
+				{
+					std::unique_lock<std::mutex> lock(queueMutex);
+					condition.wait(lock, [this] { return !jobQueue.empty() || destroying; });
+					if (destroying) {
+						break;
+					}
+					job = jobQueue.front();
+				}
+				job();
+				{
+					std::lock_guard<std::mutex> lock(queueMutex);
+					jobQueue.pop();
+					condition.notify_one();
+				}
+			}
+		}
+	};
+}
+
+namespace {
+	std::atomic<uint64_t> sink{ 0 };
+
+	void Spin(uint32_t iterations) {
+		double value = 1.0;
+		for (uint32_t i = 0; i < iterations; i++) {
+			value = std::sqrt(value + i);
+		}
+		sink.fetch_add(static_cast<uint64_t>(value), std::memory_order_relaxed);
+	}
+
+	// Frame-like workload: many small jobs and every 16th one is 40 times heavier, like UpdateDynamicUniformBuffer next to the light updates.
+	uint32_t JobCost(uint32_t job) {
+		return (job % 16 == 0) ? 40000 : 1000;
+	}
+
+	const uint32_t jobsPerStage = 512;
+}
+
+int main(int argc, char* argv[]) {
+	uint32_t maxThreads = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 32;
+
+	for (uint32_t threadCount = 1; threadCount <= maxThreads; threadCount *= 2) {
+		{
+			std::vector<std::unique_ptr<legacy::Thread>> threads;
+			for (uint32_t i = 0; i < threadCount; i++) {
+				threads.push_back(std::make_unique<legacy::Thread>());
+			}
+			double time = enginetool::benchmark::Measure([&threads]() {
+				for (uint32_t job = 0; job < jobsPerStage; job++) {
+					threads[job % threads.size()]->AddJob([job]() { Spin(JobCost(job)); });
+				}
+				for (const std::unique_ptr<legacy::Thread>& thread : threads) {
+					thread->Wait();
+				}
+			});
+			enginetool::benchmark::Report("skewed stage", "round-robin", threadCount, time);
+		}
+		{
+			enginetool::ThreadPool pool;
+			pool.SetThreadCount(threadCount);
+			double time = enginetool::benchmark::Measure([&pool]() {
+				enginetool::JobCounter stage;
+				for (uint32_t job = 0; job < jobsPerStage; job++) {
+					pool.Submit([job]() { Spin(JobCost(job)); }, stage);
+				}
+				pool.Wait(stage);
+			});
+			enginetool::benchmark::Report("skewed stage", "work-stealing", threadCount, time);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace enginetool {
+	// Bounding volume hierarchy over axis aligned boxes for ray queries. Built with the surface area heuristic and refit in place
+	// when boxes move; refitting loosens the tree, so NeedsRebuild reports when a fresh build would pay off.
+	// Boxes are given as three floats of min and three of max and keep the index they were inserted with.
+	// Ray tests match ScenePart::RayIntersection: a box is hit when the ray line enters it at tmin <= tmax with tmax >= 0, so a box
+	// around the origin is hit at a negative distance. Queries are read only and may run on several threads at once.
+	class AabbTree {
+	public:
+		static constexpr uint32_t none = 0xffffffff;
+
+		struct RayHit {
+			uint32_t id = none;
+			float distance = 0.0f; // along the direction, the hit point is origin + direction * distance
+		};
+
+		// Finer test of what is inside box id, such as the triangles of a mesh. Called with the distance the ray enters the box at
+		// and the nearest hit so far; returns true and sets distance, no nearer than enter, when the ray hits the contents by limit.
+		// A view of the caller's callable rather than a copy, so a capturing lambda costs no allocation; it must outlive the query.
+		class ExactTest {
+		public:
+			template<typename Test, typename = typename std::enable_if<!std::is_same<typename std::decay<Test>::type, ExactTest>::value>::type>
+			ExactTest(Test&& callable) : test(const_cast<void*>(static_cast<const void*>(&callable))), call(&Call<typename std::remove_reference<Test>::type>) {}
+
+			bool operator()(uint32_t id, float enter, float limit, float& distance) const { return call(test, id, enter, limit, distance); }
+
+		private:
+			template<typename Test>
+			static bool Call(void* test, uint32_t id, float enter, float limit, float& distance) {
+				return (*static_cast<Test*>(test))(id, enter, limit, distance);
+			}
+
+			void* test;
+			bool (*call)(void*, uint32_t, float, float, float&);
+		};
+
+		size_t GetCount() const { return ids.size(); }
+
+		void Clear();
+		void Insert(uint32_t id, const float* min, const float* max);
+		void Build();
+		void UpdateBox(uint32_t index, const float* min, const float* max);
+		void Refit();
+		// Refits only the nodes above the given boxes, for when few of them were updated; stops climbing where bounds stay the same
+		void Refit(const std::vector<uint32_t>& indices);
+		// True once refitting has made the tree much more costly to traverse than it was when built
+		bool NeedsRebuild() const;
+
+		// Nearest box along the ray within maxDistance, skipping the box with id ignore
+		RayHit Raycast(const float* origin, const float* direction, float maxDistance, uint32_t ignore = none) const;
+		// Whether any box but ignore is hit within maxDistance, stops at the first one found
+		bool RaycastAny(const float* origin, const float* direction, float maxDistance, uint32_t ignore = none) const;
+		// Highest box straight below origin and above floor, the ground an actor standing at origin would land on
+		RayHit ProbeDown(const float* origin, float floor, uint32_t ignore = none) const;
+		// The same, but a box only counts where exact hits its contents, and the distance is exact's
+		RayHit Raycast(const float* origin, const float* direction, float maxDistance, uint32_t ignore, ExactTest exact) const;
+		RayHit ProbeDown(const float* origin, float floor, uint32_t ignore, ExactTest exact) const;
+
+	private:
+		struct Box {
+			float min[3];
+			float max[3];
+		};
+
+		// Children of an inner node are the next node and right; a leaf holds count boxes from first in order
+		struct Node {
+			Box bounds;
+			uint32_t right;
+			uint32_t first;
+			uint32_t count;
+		};
+
+		static constexpr uint32_t maxLeafSize = 4;
+		static constexpr uint32_t binCount = 16;
+
+		void BuildNode(uint32_t first, uint32_t count);
+		// Bounds of the node from its boxes or children; false when they came out as they were
+		bool RefitNode(uint32_t index);
+		float Cost() const;
+		template<typename Visit>
+		void Traverse(const float* origin, const float* direction, float maxDistance, Visit visit) const;
+
+		std::vector<uint32_t> ids;
+		std::vector<Box> boxes;
+		std::vector<float> centroids; // three per box, only used while building
+		std::vector<uint32_t> order; // box indices, grouped by leaf
+		std::vector<Node> nodes; // depth first, a parent comes before its children
+		std::vector<uint32_t> parents; // by node, none for the root
+		std::vector<uint32_t> leaves; // by box, the node holding it
+		float nodeArea = 0.0f; // sum of Cost's terms, kept up to date by refitting
+		float builtCost = 0.0f;
+	};
+}
\ No newline at end of file
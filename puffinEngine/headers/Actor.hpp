@@ -4,6 +4,12 @@
 
 #include "src/MeshLayout.cpp"
 #include "src/LoadTexture.cpp"
+#include "AabbTree.hpp"
+#include "Handle.hpp"
+#include "Heightfield.hpp"
+#include "MotionStore.hpp"
+#include "NameTable.hpp"
+#include "SpatialHash.hpp"
 
 enum class ActorType {
     Actor, Landscape, SphereLight, RectangularLight, Skybox, DomeLight, Character, Camera, Sea, Cloud, MainCharacter
@@ -15,26 +21,62 @@ enum class ActorState {
 
 class Actor {
 public:
-	Actor(std::string name, std::string description, glm::vec3 position, ActorType type, std::vector<std::shared_ptr<Actor>>& actors);
+	Actor(enginetool::NameId name, enginetool::NameId description, glm::vec3 position, ActorType type, std::vector<std::shared_ptr<Actor>>& actors, enginetool::MotionStore& motionStore);
 	virtual ~Actor();
 
+	Actor(const Actor&) = delete;
+	Actor& operator=(const Actor&) = delete;
+
+	// ------------ Motion data in the store ------------ //
+
+	glm::vec3& Position() { return motion->positions[motionSlot]; }
+	const glm::vec3& Position() const { return motion->positions[motionSlot]; }
+	glm::vec3& PreviousPosition() { return motion->previousPositions[motionSlot]; }
+	glm::vec3& RenderPosition() { return motion->renderPositions[motionSlot]; }
+	const glm::vec3& RenderPosition() const { return motion->renderPositions[motionSlot]; }
+	glm::vec3& Movement() { return motion->movements[motionSlot]; }
+	glm::vec3& MovementGoal() { return motion->movementGoals[motionSlot]; }
+	glm::vec3& Velocity() { return motion->velocities[motionSlot]; }
+	enginetool::ScenePart::AABB& CurrentAabb() { return motion->aabbs[motionSlot]; }
+	const enginetool::ScenePart::AABB& CurrentAabb() const { return motion->aabbs[motionSlot]; }
+	uint32_t GetMotionSlot() const { return motionSlot; }
+
+	// ---------------- Sleeping ------------------------ //
+
+	// Actors with a wake queue fall asleep once their motion has converged: no per-tick work, cached AABB kept.
+	// SetState, ChangePosition, manual control and position changes wake them and append them to the queue.
+	void EnableSleeping(std::vector<Actor*>& wakeQueue);
+	bool IsSleeping() const { return !motion->IsAwake(motionSlot); }
+	bool TrySleep();
+	void Wake();
+
 	// ---------------- Main functions ------------------ //
 
-	std::string GetId() const;
+	uint64_t GetId() const;
+	enginetool::NameId GetDescription() const;
 	virtual ActorType GetType();//const!
 	
 	float Approach(float, float, float);
+	// UpdatePosition without the approach and integration in between, for buckets that run those through the motion kernel.
+	// Not virtual: buckets hold the concrete type, so a subclass that moves differently hides them and calls still bind statically.
+	void BeginMove();
+	void EndMove();
 	virtual glm::vec3 CalculateSelectionIndicatorColor() = 0;
 	void ChangePosition();
 	void CheckCollisions();
 	void CheckIfInTheDestination();
 	float DetectGroundLevel();
+	// Where the ray meets the mesh, for a ray entering CurrentAabb at enter; a distance in [enter, limit] or false.
+	// Actors without mesh triangles are their box, the hit is at enter.
+	bool RayHitsMesh(const glm::vec3& origin, const glm::vec3& direction, float enter, float limit, float& distance) const;
 	void Dolly(float);
+	virtual void Interpolate(float alpha);
 	void offManualControl();
 	void onManualControl();
-	void SaveToFile();
+	virtual void SenseSurroundings();
 	void SetPosition(glm::vec3 lightColor);
 	void SetState(ActorState state);
+	virtual void StoreTickState();
 	void Pedestal(float);
 	void Strafe(float);
 	void ResetPosition();
@@ -42,36 +84,41 @@ public:
 	void UpdateAABB();
 	virtual void UpdatePosition(float)=0;
 
-	bool visible = true;
 	bool collider = false;
 	bool manualControl = false;
 	bool inAir = false;
 	
 	ActorState state;
 	
-	enginetool::ScenePart* assignedMesh;
+	enginetool::ScenePart* assignedMesh = nullptr;
 	enginetool::SceneMaterial* assignedMaterial;
 	
-	enginetool::ScenePart::AABB currentAabb;
 	std::vector<std::shared_ptr<Actor>>* interactActors;
+	const enginetool::SpatialHash* broadphase = nullptr; // over interactActors, ids are their indices; without one every actor is tested
+	const enginetool::SpatialHash* restingBroadphase = nullptr; // sleeping interactActors, searched as well when set
+	bool inRestingBroadphase = false; // this actor's box in restingBroadphase is current; cleared once it wakes
+	const enginetool::AabbTree* rayTree = nullptr; // over interactActors like the broadphase, for ground probes
+	uint32_t rayTreeId = enginetool::AabbTree::none; // this actor's box in rayTree, none when it has no box there
+	const enginetool::Heightfield* heightfield = nullptr; // static ground; when set, groundTree holds the actors it leaves out
+	const enginetool::AabbTree* groundTree = nullptr;
+	enginetool::Handle<Actor> handle; // set by the scene that registered the actor
 	
-	std::string name;
+	enginetool::NameId name; // in the name table of the scene
 	
-	glm::vec3 position;
 	glm::vec3 initPosition;
 	glm::vec3 destinationPoint;
 	glm::vec3 direction;
 	glm::vec3 foward;
-	glm::vec3 movement = glm::vec3(0.0f, 0.0f, 0.0f);
-	glm::vec3 movementGoal = glm::vec3(0.0f, 0.0f, 0.0f);
-	glm::vec3 velocity = glm::vec3(30.0f, 30.0f, 30.0f);
 	glm::vec3 freeFallVelocity = glm::vec3(0.0f, -1340.0f, 0.0f);
 	
 	float walkVelocity = 150.0f;
 	float groundLevel;
 
 private:
-	std::string CreateId();
+	static uint64_t CreateId();
+	// Calls body for every other actor whose AABB may overlap the box: all of interactActors, or what the broadphase finds
+	template<typename F>
+	void ForEachCandidate(const glm::vec3& min, const glm::vec3& max, F body);
 	void StartCrouch();
 	void StartFall();
 	void StartIdle();
@@ -82,7 +129,11 @@ private:
 	void StartWalkLeft();
 	void StartWalkRight();
 
-	std::string description;
-	std::string id;
+	enginetool::NameId description;
+	uint64_t id;
 	ActorType type = ActorType::Actor;
+
+	enginetool::MotionStore* motion;
+	uint32_t motionSlot; // kept up to date by the store
+	std::vector<Actor*>* wakeQueue = nullptr;
 };
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Character.hpp"
+#include "Handle.hpp"
+#include "Landscape.hpp"
+#include "Light.hpp"
+#include "MotionStore.hpp"
+#include "NameTable.hpp"
+#include "ObjectPool.hpp"
+
+namespace enginetool {
+	// The queries actors of one scene sense and stand on. Null members leave that query out.
+	struct ActorWorld {
+		const SpatialHash* broadphase = nullptr;
+		const SpatialHash* restingBroadphase = nullptr;
+		const AabbTree* rayTree = nullptr;
+		const AabbTree* groundTree = nullptr;
+		const Heightfield* heightfield = nullptr;
+
+		void Attach(Actor& actor) const;
+	};
+
+	// Who owns the actors and every list they are in: pools, handles, motion stores, update buckets and wake queues.
+	// It makes no Vulkan calls, so the scene spawns and despawns through it and so does the spawn benchmark.
+	class ActorRoster {
+	public:
+		// Creates one pooled actor per position, for crowds, projectiles and the like. Landscape, SphereLight and Character
+		// can be spawned; their handles are appended to spawned.
+		void Spawn(ActorType type, const std::string& name, const std::vector<glm::vec3>& positions, ScenePart& mesh, SceneMaterial& material, std::vector<Handle<Actor>>& spawned);
+		// Removes all live actors among handles with one pass over the actor lists. Returns how many were removed.
+		// views and owners are the caller's lists of actors, compacted along with the roster's own.
+		size_t Despawn(const std::vector<Handle<Actor>>& handles, std::initializer_list<std::vector<Actor*>*> views = {}, std::initializer_list<std::vector<std::shared_ptr<Actor>>*> owners = {});
+
+		// Motion stores are declared before the actors, so they outlive them. Each bucketed actor type has a store of its own,
+		// so its motion data is contiguous; cameras, the main character, scenery and unbucketed types share motionStore.
+		MotionStore motionStore;
+		MotionStore landscapeMotion;
+		MotionStore sphereLightMotion;
+		MotionStore characterMotion;
+
+		// Names and descriptions of all actors, which only store ids into it
+		NameTable actorNames;
+
+		// Storage of the actor types that can be spawned in bulk, also declared before the actors
+		ObjectPool<Landscape> landscapePool;
+		ObjectPool<SphereLight> sphereLightPool;
+		ObjectPool<Character> characterPool;
+
+		std::vector<std::shared_ptr<Actor>> actors;
+
+	protected:
+		void AddActor(std::shared_ptr<Actor> actor);
+		// The type tag says which class the actor is, so the buckets take it without a dynamic cast. False for unbucketed types.
+		bool AddToBucket(Actor* actor);
+		MotionStore& MotionStoreFor(ActorType type);
+		template<typename T>
+		T* SpawnActor(ObjectPool<T>& pool, ActorType type, NameId name, NameId description, const glm::vec3& position, ScenePart& mesh, SceneMaterial& material, Handle<T>& handle);
+
+		ActorWorld world; // attached to every actor the roster adds
+
+		// Non-owning views of the awake actors in `actors`, grouped by ActorType, each updated by one non-virtual loop.
+		// Bucketed actors leave their bucket when they fall asleep and come back through wokenActors.
+		std::vector<Landscape*> landscapeBucket;
+		std::vector<SphereLight*> sphereLightBucket;
+		std::vector<Character*> characterBucket;
+		std::vector<Actor*> otherActors;
+		std::vector<Actor*> wokenActors;
+		std::vector<Actor*> settledActors; // fell asleep since the owner last collected them
+		bool actorsChanged = true; // actors were added or removed since the owner's ray queries were last built
+		bool restingChanged = true; // the same, for the owner's grid of sleeping actors
+
+		// Every actor the roster created, so hot paths resolve them in O(1) without casts or reference counting
+		HandleTable<Actor> actorHandles;
+	};
+
+	template<typename T>
+	T* ActorRoster::SpawnActor(ObjectPool<T>& pool, ActorType type, NameId name, NameId description, const glm::vec3& position, ScenePart& mesh, SceneMaterial& material, Handle<T>& handle) {
+		std::shared_ptr<T> actor = pool.MakeShared(name, description, position, type, actors, MotionStoreFor(type));
+		actor->assignedMesh = &mesh;
+		actor->assignedMaterial = &material;
+		handle = actorHandles.Insert(actor.get());
+		actor->handle = handle;
+		T* spawned = actor.get();
+		AddActor(std::move(actor));
+		return spawned;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+
+namespace enginetool {
+	// Building blocks of the little endian file formats: input recordings, name tables and instance files.
+	// Readers return false on a short or damaged stream instead of throwing, so callers can reject the file.
+	namespace binary {
+		// Longest piece a read allocates before the stream proved it holds that many bytes
+		const size_t readChunk = 1 << 16;
+
+		inline bool IsLittleEndian() {
+			const uint16_t probe = 1;
+			return *reinterpret_cast<const unsigned char*>(&probe) == 1;
+		}
+
+		template<typename T>
+		void WriteRaw(std::ostream& stream, T value) {
+			unsigned char bytes[sizeof(T)];
+			std::memcpy(bytes, &value, sizeof(T));
+			unsigned char ordered[sizeof(T)];
+			const bool littleEndian = IsLittleEndian();
+			for (size_t i = 0; i < sizeof(T); i++) {
+				ordered[i] = littleEndian ? bytes[i] : bytes[sizeof(T) - 1 - i];
+			}
+			stream.write(reinterpret_cast<const char*>(ordered), sizeof(T));
+		}
+
+		template<typename T>
+		bool ReadRaw(std::istream& stream, T& value) {
+			unsigned char ordered[sizeof(T)];
+			if (!stream.read(reinterpret_cast<char*>(ordered), sizeof(T))) {
+				return false;
+			}
+			unsigned char bytes[sizeof(T)];
+			const bool littleEndian = IsLittleEndian();
+			for (size_t i = 0; i < sizeof(T); i++) {
+				bytes[i] = littleEndian ? ordered[i] : ordered[sizeof(T) - 1 - i];
+			}
+			std::memcpy(&value, bytes, sizeof(T));
+			return true;
+		}
+
+		inline void WriteVarint(std::ostream& stream, uint64_t value) {
+			while (value >= 0x80) {
+				stream.put(static_cast<char>((value & 0x7f) | 0x80));
+				value >>= 7;
+			}
+			stream.put(static_cast<char>(value));
+		}
+
+		inline bool ReadVarint(std::istream& stream, uint64_t& value) {
+			value = 0;
+			for (int shift = 0; shift < 64; shift += 7) {
+				const int byte = stream.get();
+				if (byte == std::char_traits<char>::eof()) {
+					return false;
+				}
+				value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+				if ((byte & 0x80) == 0) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		// Varint length, then the bytes
+		inline void WriteString(std::ostream& stream, const std::string& text) {
+			WriteVarint(stream, text.size());
+			stream.write(text.data(), text.size());
+		}
+
+		// Grows the string a chunk at a time, so a corrupt length fails at the end of the stream instead of in one huge allocation
+		inline bool ReadString(std::istream& stream, std::string& text) {
+			uint64_t length = 0;
+			if (!ReadVarint(stream, length)) {
+				return false;
+			}
+			text.clear();
+			while (text.size() < length) {
+				const size_t first = text.size();
+				const size_t count = static_cast<size_t>(std::min<uint64_t>(length - first, readChunk));
+				text.resize(first + count);
+				if (!stream.read(&text[first], count)) {
+					return false;
+				}
+			}
+			return true;
+		}
+	}
+}
\ No newline at end of file
@@ -6,9 +6,11 @@
 
 class Camera : public Actor {
 public:
-	Camera(std::string name, std::string description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors);
+	Camera(enginetool::NameId name, enginetool::NameId description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors, enginetool::MotionStore& motionStore);
 	virtual ~Camera();
 
+	void Interpolate(float alpha) override;
+	void StoreTickState() override;
 	void UpdatePosition(float) override;
 
 	virtual glm::vec3 CalculateSelectionIndicatorColor() override;
@@ -20,6 +22,8 @@ public:
 
 	glm::vec3 up;
 	glm::vec3 view;
+	glm::vec3 previousView;
+	glm::vec3 renderView;
 
 	float FOV;
 	float clippingNear;
@@ -4,15 +4,22 @@
 
 class Character : public Actor {
 public:
-	Character(std::string name, std::string description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors);
+	Character(enginetool::NameId name, enginetool::NameId description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors, enginetool::MotionStore& motionStore);
 	virtual ~Character();
 
 	enum class BodySlots {
 		LeftHand, RightHand, Head, Neck, Chest, Belt1, Belt2, Finger1, Finger2, Cloak, Shoes
 	};
 
+	static constexpr float approachRate = 1000.0f;
+
 	virtual glm::vec3 CalculateSelectionIndicatorColor() override;
+	// Hide Actor's: characters do not stop at their destination, and land or fall once moved
+	void BeginMove();
+	void EndMove();
 	void Init(unsigned int maxHealth, int currentHealth, unsigned int gold);
+	void SenseSurroundings() override;
+	void UpdatePosition(float) override;
 
 	unsigned int maxHealth;
 	int currentHealth;
@@ -20,7 +27,5 @@ public:
 	bool onGround = false;
 		
 private:
-	void UpdatePosition(float) override;
-
 	std::string albedoTexture;	
 };
\ No newline at end of file
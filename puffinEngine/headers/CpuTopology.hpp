@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace enginetool {
+	struct LogicalCpu {
+		uint32_t id = 0;
+		uint32_t core = 0; // physical core, unique across packages
+		uint32_t l3Domain = 0; // lowest cpu id sharing the same L3 cache
+	};
+
+	// Logical cpus the process may run on, grouped into physical cores and L3 domains.
+	class CpuTopology {
+	public:
+		static CpuTopology Detect(const std::string& sysfsPath = "/sys/devices/system/cpu");
+		static std::vector<uint32_t> ParseCpuList(const std::string& list);
+
+		void AddCpu(const LogicalCpu& cpu);
+		const LogicalCpu* FindCpu(uint32_t id) const;
+		const std::vector<LogicalCpu>& GetCpus() const { return cpus; }
+		uint32_t GetPhysicalCoreCount() const;
+		uint32_t GetL3DomainCount() const;
+
+		// One worker per physical core, minus the core of the thread that stays outside the pool.
+		uint32_t RecommendedWorkerCount(uint32_t reservedCpu) const;
+		// Cpus for count workers: whole cores sharing the reserved cpu's L3 first, then the other domains, SMT siblings only once every core is taken.
+		std::vector<uint32_t> PickWorkerCpus(uint32_t reservedCpu, uint32_t count) const;
+
+	private:
+		std::vector<LogicalCpu> cpus;
+	};
+
+	// Cpu the calling thread is running on right now, -1 when the platform cannot tell.
+	int GetCurrentCpu();
+	bool PinCurrentThreadToCpu(uint32_t cpu);
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace enginetool {
+	// Bump allocator for data that lives no longer than one frame. Deallocation is a no-op,
+	// everything is released at once when the arena is reset.
+	class FrameArena {
+	public:
+		explicit FrameArena(size_t blockSize = 64 * 1024);
+
+		FrameArena(const FrameArena&) = delete;
+		FrameArena& operator=(const FrameArena&) = delete;
+
+		void* Allocate(size_t size, size_t alignment);
+		// Frees everything; when a frame overflowed into extra blocks they are merged into one big enough for the next frame.
+		void Reset();
+
+		size_t GetUsedBytes() const { return usedBytes; }
+		size_t GetCapacity() const;
+		size_t GetBlockCount() const { return blocks.size(); }
+
+	private:
+		struct Block {
+			std::unique_ptr<char[]> memory;
+			size_t size = 0;
+		};
+
+		std::vector<Block> blocks;
+		size_t blockSize;
+		size_t currentBlock = 0;
+		size_t offset = 0;
+		size_t usedBytes = 0;
+
+		void AddBlock(size_t size);
+	};
+
+	// Arena of the calling thread. It is reset lazily on first use after NextFrame(),
+	// so workers never touch each other's memory and the main thread never waits for them.
+	FrameArena& GetFrameArena();
+	// Ends the frame for every thread. Memory handed out before this call must not be used afterwards.
+	void NextFrame();
+	uint64_t GetFrameIndex();
+
+	// STL adapter. A default constructed allocator stays bound to the arena of the thread that created it,
+	// so containers using it belong to that thread for the rest of the frame.
+	template<typename T>
+	class FrameAllocator {
+	public:
+		typedef T value_type;
+
+		FrameAllocator() noexcept : arena(&GetFrameArena()) {}
+		explicit FrameAllocator(FrameArena& arena) noexcept : arena(&arena) {}
+		template<typename U>
+		FrameAllocator(const FrameAllocator<U>& other) noexcept : arena(other.arena) {}
+
+		T* allocate(size_t count) {
+			if (count > SIZE_MAX / sizeof(T)) {
+				throw std::bad_alloc();
+			}
+			return static_cast<T*>(arena->Allocate(count * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T*, size_t) noexcept {}
+
+		template<typename U>
+		bool operator==(const FrameAllocator<U>& other) const noexcept { return arena == other.arena; }
+		template<typename U>
+		bool operator!=(const FrameAllocator<U>& other) const noexcept { return arena != other.arena; }
+
+	private:
+		template<typename U> friend class FrameAllocator;
+		FrameArena* arena;
+	};
+
+	template<typename T>
+	using FrameVector = std::vector<T, FrameAllocator<T>>;
+	using FrameString = std::basic_string<char, std::char_traits<char>, FrameAllocator<char>>;
+	using FrameStringStream = std::basic_ostringstream<char, std::char_traits<char>, FrameAllocator<char>>;
+}
\ No newline at end of file
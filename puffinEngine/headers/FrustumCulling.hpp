@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "MotionKernels.hpp"
+#include "RayKernels.hpp"
+
+namespace enginetool {
+	// What a camera sees: six planes a * x + b * y + c * z + d = 0, in the order left, right, bottom, top, near, far, with
+	// a * x + b * y + c * z + d >= 0 on the inner side. The planes are not normalized, only the side a point is on matters.
+	struct Frustum {
+		float planes[6][4];
+	};
+
+	// Frustum of a column major projection * view matrix like glm's, for Vulkan's clip space where depth runs from 0 to w
+	Frustum ExtractFrustum(const float* viewProjection);
+
+	// visible[i] is 1 unless box i lies wholly on the outer side of one of the planes, run on the level picked in
+	// MotionKernels. Boxes near an edge of the frustum but outside it can still pass, which only costs a draw.
+	// Every level gives the same results.
+	void CullBoxes(const Frustum& frustum, const BoxArrays& boxes, size_t count, uint8_t* visible);
+	void CullBoxes(SimdLevel level, const Frustum& frustum, const BoxArrays& boxes, size_t count, uint8_t* visible);
+}
\ No newline at end of file
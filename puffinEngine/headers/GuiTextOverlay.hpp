@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstring>
+#include <string>
+
 #include <glm/gtc/matrix_transform.hpp> 
 
 #include "ErrorCheck.hpp"
@@ -31,7 +34,9 @@ public:
 	
 	void createUniformBuffer(const VkCommandBuffer& commandBuffer);
 	void beginTextUpdate();
-	void renderText(const std::string& text, float x, float y, const TextAlignment& align);
+	void renderText(const char* text, size_t length, float x, float y, const TextAlignment& align);
+	void renderText(const char* text, float x, float y, const TextAlignment& align) { renderText(text, std::strlen(text), x, y, align); }
+	void renderText(const std::string& text, float x, float y, const TextAlignment& align) { renderText(text.data(), text.size(), x, y, align); }
 	void endTextUpdate();
 
 private:
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace enginetool {
+	// Weak typed reference: a slot index plus the generation the slot had when the object was inserted.
+	// Once the object is removed the slot's generation moves on, so old handles resolve to nullptr instead of dangling.
+	template<typename T>
+	struct Handle {
+		static constexpr uint32_t invalidIndex = UINT32_MAX;
+
+		uint32_t index = invalidIndex;
+		uint32_t generation = 0;
+
+		bool IsValid() const { return index != invalidIndex; }
+
+		// A handle to a derived type converts to a handle to its base, never the other way round.
+		template<typename U, typename = typename std::enable_if<std::is_base_of<U, T>::value>::type>
+		operator Handle<U>() const { return Handle<U>{ index, generation }; }
+
+		bool operator==(const Handle& other) const { return index == other.index && generation == other.generation; }
+		bool operator!=(const Handle& other) const { return !(*this == other); }
+	};
+
+	// Maps handles to objects derived from Base in O(1). Lookups cast statically: a Handle<T> is only ever made from a T*,
+	// so the stored pointer is known to be a T. The table does not own the objects.
+	template<typename Base>
+	class HandleTable {
+	public:
+		template<typename T>
+		Handle<T> Insert(T* object) {
+			static_assert(std::is_base_of<Base, T>::value, "object must derive from the table's base type");
+
+			uint32_t index;
+			if (!freeSlots.empty()) {
+				index = freeSlots.back();
+				freeSlots.pop_back();
+			}
+			else {
+				index = static_cast<uint32_t>(slots.size());
+				slots.push_back(Slot{});
+			}
+			slots[index].object = object;
+			return Handle<T>{ index, slots[index].generation };
+		}
+
+		template<typename T>
+		T* Get(Handle<T> handle) const {
+			if (handle.index >= slots.size() || slots[handle.index].generation != handle.generation) {
+				return nullptr;
+			}
+			return static_cast<T*>(slots[handle.index].object);
+		}
+
+		// Invalidates every copy of the handle. Returns false when it was already stale.
+		template<typename T>
+		bool Remove(Handle<T> handle) {
+			if (Get(handle) == nullptr) {
+				return false;
+			}
+			Slot& slot = slots[handle.index];
+			slot.object = nullptr;
+			slot.generation++;
+			freeSlots.push_back(handle.index);
+			return true;
+		}
+
+		void Clear() {
+			for (uint32_t i = 0; i < slots.size(); i++) {
+				if (slots[i].object != nullptr) {
+					slots[i].object = nullptr;
+					slots[i].generation++;
+					freeSlots.push_back(i);
+				}
+			}
+		}
+
+		size_t GetLiveCount() const { return slots.size() - freeSlots.size(); }
+
+	private:
+		struct Slot {
+			Base* object = nullptr;
+			uint32_t generation = 0;
+		};
+
+		std::vector<Slot> slots;
+		std::vector<uint32_t> freeSlots;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace enginetool {
+	// Ground under boxes that do not move, baked into a grid over x and z so finding it is one cell read instead of a ray cast.
+	// Boxes are given as three floats of min and three of max, like the other box structures. A cell keeps the highest top of
+	// the boxes covering all of it. Cells crossed by a box edge, or with a box in them higher than the point asked about, cannot
+	// be answered from one height and are left to ray casts. Tops are not blended between cells, box edges would turn into ramps.
+	class Heightfield {
+	public:
+		explicit Heightfield(float cellSize = 8.0f);
+
+		// Past this many cells the cells grow instead
+		static constexpr uint32_t maxCells = 1 << 22;
+
+		void SetCellSize(float size);
+		// The size the last Build used, at least the one asked for
+		float GetCellSize() const { return builtCellSize; }
+		size_t GetCount() const { return boxes.size(); }
+
+		void Clear();
+		// Without a flat top the ground on the box is not its top, all cells it spans are left to ray casts
+		void Insert(const float* min, const float* max, bool flatTop = true);
+		void Build();
+
+		// What AabbTree::ProbeDown from (x, y, z) would find among the boxes: the highest top of a box around the vertical line
+		// that does not start above y, std::numeric_limits<float>::lowest() when there is none. False when the cell needs a ray cast.
+		bool GroundLevel(float x, float y, float z, float& level) const;
+
+	private:
+		struct Box {
+			float min[3];
+			float max[3];
+			bool flatTop;
+		};
+
+		// A box in the cell starts at reach, so a point below it could be under that box rather than on top; infinite reach
+		// marks a cell a box edge runs through
+		struct Cell {
+			float top;
+			float reach;
+		};
+
+		float cellSize;
+		float builtCellSize;
+		float inverseCellSize = 0.0f;
+		float origin[2] = { 0.0f, 0.0f }; // x and z of the first cell's corner
+		uint32_t width = 0; // cells along x
+		uint32_t depth = 0; // cells along z
+		std::vector<Box> boxes;
+		std::vector<Cell> cells; // row by row along z
+	};
+}
\ No newline at end of file
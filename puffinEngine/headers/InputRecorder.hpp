@@ -0,0 +1,83 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace enginetool {
+	enum class InputEventType : uint8_t {
+		Key = 0,
+		MouseButton = 1,
+		CursorPosition = 2,
+		End = 3, // tick at which the recording stopped
+		Frame = 4 // a presented frame: tick reached by its last tick and the interpolation alpha it was rendered with
+	};
+
+	struct InputEvent {
+		InputEventType type = InputEventType::End;
+		uint64_t tick = 0; // fixed-step ticks simulated before the event arrived
+		float time = 0.0f; // seconds since the recording started, informational only
+		int32_t code = 0; // key or mouse button
+		int32_t action = 0; // GLFW_PRESS, GLFW_RELEASE or GLFW_REPEAT
+		double x = 0.0;
+		double y = 0.0;
+		float alpha = 0.0f; // Frame only
+	};
+
+	struct InputRecordingHeader {
+		double fixedTimeValue = 0.0;
+		int32_t width = 0;
+		int32_t height = 0;
+	};
+
+	// Binary layout, little endian: "PINP", uint16 version, header, then one record per event.
+	// A record is uint8 type, varint tick delta, float time and a payload that depends on the type.
+	// Every presented frame ends with a Frame record, so a replay can run the same ticks and draw at the same alpha per frame.
+	namespace input {
+		const uint16_t fileVersion = 2;
+
+		void WriteHeader(std::ostream& stream, const InputRecordingHeader& header);
+		bool ReadHeader(std::istream& stream, InputRecordingHeader& header);
+		void WriteEvent(std::ostream& stream, const InputEvent& event, uint64_t previousTick);
+		bool ReadEvent(std::istream& stream, InputEvent& event, uint64_t previousTick);
+	}
+
+	class InputRecorder {
+	public:
+		bool Open(const std::string& path, const InputRecordingHeader& header);
+		bool IsRecording() const { return file.is_open(); }
+		void Record(InputEvent event);
+		void Close(uint64_t tick);
+
+	private:
+		std::ofstream file;
+		std::chrono::steady_clock::time_point start;
+		uint64_t previousTick = 0;
+	};
+
+	// Feeds a recording back frame by frame. Live input is meant to be ignored while it is active.
+	// Mouse picks cast rays from the interpolated camera, so a replay only hits the same actors as the recording when every
+	// frame simulates the same ticks and renders at the same alpha before the next events are applied.
+	class InputReplay {
+	public:
+		bool Load(const std::string& path);
+		bool Load(std::istream& stream);
+		bool IsActive() const { return active; }
+		const InputRecordingHeader& GetHeader() const { return header; }
+		const std::vector<InputEvent>& GetEvents() const { return events; }
+		// Events of the next recorded frame in the order they arrived, and the Frame record closing them. A recording cut
+		// short ends with a frame that stays at the tick of its last event. False once every frame was handed out.
+		bool NextFrame(std::vector<InputEvent>& frameEvents, InputEvent& frame);
+		bool IsFinished() const;
+
+	private:
+		InputRecordingHeader header;
+		std::vector<InputEvent> events;
+		size_t nextEvent = 0;
+		bool active = false;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "src/MeshLayout.cpp"
+
+namespace enginetool {
+	struct SceneMaterial;
+
+	// Where one static instance is, packed so a whole batch reads and writes as one float array
+	struct InstanceLayout {
+		glm::vec3 pos;
+	};
+
+	// Static copies of one mesh with one material. They are not actors: no motion, handle or name, only a position each,
+	// so placing a million of them is a few array appends.
+	// There is no instanced pipeline yet: the scene draws batches through the actor pipelines with one push constant and one
+	// vkCmdDrawIndexed per instance that survives culling. That costs a draw call per visible instance and per pass, so
+	// batches suit scenery seen a few thousand at a time, not a million instances on screen at once.
+	struct InstanceBatch {
+		std::string meshName;
+		std::string materialName;
+		ScenePart* mesh = nullptr;
+		SceneMaterial* material = nullptr;
+		std::vector<InstanceLayout> instances;
+		ScenePart::AABB bounds; // of every instance with its mesh, meaningless while there are none
+
+		// Mesh must be set, its bounds are added to every instance
+		void Add(const InstanceLayout* first, size_t count);
+	};
+
+	// Binary layout, little endian: "PINS", uint16 version, varint batch count, then for every batch the mesh and material names
+	// as varint length and bytes, a varint instance count and the packed positions, three floats each.
+	namespace instancing {
+		const uint16_t fileVersion = 1;
+
+		bool Save(const std::string& path, const std::vector<InstanceBatch>& batches);
+		// Fills names and instances only, the scene resolves the names to its mesh and material libraries
+		bool Load(const std::string& path, std::vector<InstanceBatch>& batches);
+		bool Load(std::istream& stream, std::vector<InstanceBatch>& batches);
+	}
+}
\ No newline at end of file
@@ -6,7 +6,9 @@
 
 class Landscape : public Actor {
 public:
-	Landscape(std::string name, std::string description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors);
+	static constexpr float approachRate = 500.0f;
+
+	Landscape(enginetool::NameId name, enginetool::NameId description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors, enginetool::MotionStore& motionStore);
 	virtual ~Landscape();
 
 	virtual glm::vec3 CalculateSelectionIndicatorColor() override;
@@ -23,7 +25,7 @@ private:
 
 class Sea : public Landscape {
 public:
-	Sea(std::string name, std::string description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors);	
+	Sea(enginetool::NameId name, enginetool::NameId description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors, enginetool::MotionStore& motionStore);	
 	virtual ~Sea();
 
 	void CreateMesh();
@@ -36,7 +38,7 @@ private:
 
 class Cloud : public Landscape {
 public:
-	Cloud(std::string name, std::string description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors);	
+	Cloud(enginetool::NameId name, enginetool::NameId description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors, enginetool::MotionStore& motionStore);	
 	virtual ~Cloud();
 
 private:
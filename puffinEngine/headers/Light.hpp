@@ -6,7 +6,9 @@
 
 class Light : public Actor {
 public:
-	Light(std::string name, std::string description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors);
+	static constexpr float approachRate = 80.0f;
+
+	Light(enginetool::NameId name, enginetool::NameId description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors, enginetool::MotionStore& motionStore);
 	virtual ~Light();
 
 	glm::vec3 GetLightColor() const;
@@ -20,13 +22,13 @@ public:
 
 class SphereLight : public Light {
 public:
-	SphereLight(std::string name, std::string description, glm::vec3 position, ActorType type, std::vector<std::shared_ptr<Actor>>& actors);
+	SphereLight(enginetool::NameId name, enginetool::NameId description, glm::vec3 position, ActorType type, std::vector<std::shared_ptr<Actor>>& actors, enginetool::MotionStore& motionStore);
 	virtual ~SphereLight();
 };
 
 class Skybox : public Light {
 public:
-	Skybox(std::string name, std::string description, glm::vec3 position, ActorType type, std::vector<std::shared_ptr<Actor>>& actors, float horizon);
+	Skybox(enginetool::NameId name, enginetool::NameId description, glm::vec3 position, ActorType type, std::vector<std::shared_ptr<Actor>>& actors, enginetool::MotionStore& motionStore, float horizon);
 	virtual ~Skybox();
 
 	void CreateMesh();
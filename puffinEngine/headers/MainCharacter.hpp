@@ -4,11 +4,9 @@
 
 class MainCharacter : public Character {
 public:
-	MainCharacter(std::string name, std::string description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors);
+	MainCharacter(enginetool::NameId name, enginetool::NameId description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors, enginetool::MotionStore& motionStore);
 	virtual ~MainCharacter();
 
-	enginetool::ScenePart* assignedMesh;
-
 private:
 
 };
\ No newline at end of file
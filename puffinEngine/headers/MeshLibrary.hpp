@@ -24,5 +24,6 @@ private:
     void GetAABBDrawData();
     void Load(enginetool::ScenePart& mesh);
     void PrepeareAABBs();
+    void PrepeareBvhs();
     Device* logicalDevice;
 };
\ No newline at end of file
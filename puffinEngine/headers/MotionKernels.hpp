@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+
+namespace enginetool {
+	enum class SimdLevel {
+		Scalar, SSE2, AVX2
+	};
+
+	// Widest instruction set this cpu runs, detected once.
+	SimdLevel GetSupportedSimdLevel();
+	// Level the kernels dispatch to, the supported one unless lowered with SetSimdLevel. Requests above the supported level are clamped.
+	SimdLevel GetSimdLevel();
+	void SetSimdLevel(SimdLevel level);
+	const char* GetSimdLevelName(SimdLevel level);
+
+	// Batched Actor::Approach plus integration over count floats of xyz motion data (three per actor):
+	// movement moves towards goal by at most step, then position += movement * dt.
+	// Every level gives bit-identical results, so the choice never changes the simulation.
+	void ApproachAndIntegrate(float* positions, float* movements, const float* goals, size_t count, float step, float dt);
+	void ApproachAndIntegrate(SimdLevel level, float* positions, float* movements, const float* goals, size_t count, float step, float dt);
+}
\ No newline at end of file
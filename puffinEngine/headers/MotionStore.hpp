@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "src/MeshLayout.cpp"
+
+namespace enginetool {
+	// Batch kernels walk the vec3 arrays as plain floats
+	static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "glm::vec3 must be tightly packed");
+
+	// Hot motion and bounds data of every actor, one slot per actor in parallel arrays, so passes over all actors stream through memory.
+	// Slots are dense, awake ones first, so per-tick passes only walk [0, GetAwakeCount()) and sleeping actors cost nothing.
+	// Removing, sleeping and waking move slots around; the owner's slot index is updated, but references into the arrays are only
+	// stable while none of these runs.
+	class MotionStore {
+	public:
+		// slot receives the index of the new slot, and is rewritten whenever the slot moves, so it must outlive it
+		void Add(const glm::vec3& position, uint32_t& slot);
+		void Remove(uint32_t slot);
+		void Clear();
+		// Room for count more slots, so a bulk spawn reallocates each array at most once
+		void Reserve(size_t count);
+
+		bool IsAwake(uint32_t slot) const { return slot < awakeCount; }
+		void Sleep(uint32_t slot);
+		// True when the slot was asleep, so the owner queues itself once per wake-up however often it is woken
+		bool Wake(uint32_t slot);
+
+		size_t GetSize() const { return positions.size(); }
+		size_t GetAwakeCount() const { return awakeCount; }
+
+		// Whole-store passes, ranges are slot indices so callers can split them across threads.
+		void StoreTickState(size_t first, size_t last);
+		void Interpolate(float alpha, size_t first, size_t last);
+
+		std::vector<glm::vec3> positions;
+		std::vector<glm::vec3> previousPositions; // position at the start of the last simulation tick
+		std::vector<glm::vec3> renderPositions; // blend of previousPosition and position used by everything that draws
+		std::vector<glm::vec3> movements;
+		std::vector<glm::vec3> movementGoals;
+		std::vector<glm::vec3> velocities;
+		std::vector<ScenePart::AABB> aabbs;
+
+	private:
+		void Swap(uint32_t first, uint32_t second);
+
+		std::vector<uint32_t*> owners;
+		size_t awakeCount = 0;
+	};
+}
\ No newline at end of file
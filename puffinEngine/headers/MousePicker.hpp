@@ -15,7 +15,7 @@ public:
     glm::vec3 GetRayDirection() const;
     glm::vec3 GetRayOrigin() const;
     void CalculateNormalisedDeviceCoordinates(const double& xpos, const double& ypos) noexcept;
-    void UpdateMousePicker(const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix,std::shared_ptr<Camera> camera);
+    void UpdateMousePicker(const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, Camera* camera);
 
     glm::vec3 hitPoint;
     float width, height;
@@ -25,7 +25,7 @@ private:
     glm::vec2 mousePositionNormalized;
     glm::mat4 proj;
 	glm::mat4 view;
-    std::shared_ptr<Camera> currentCamera = nullptr;
+    Camera* currentCamera = nullptr; // owned by the scene
 
     glm::vec3 CalculateMouseRay();
 };
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace enginetool {
+	using NameId = uint32_t;
+
+	// Every distinct string once, referred to by a small id. Actors keep ids instead of their own copies of names and descriptions.
+	// Id 0 is the empty string. Not thread safe, like the scene lists that use it.
+	class NameTable {
+	public:
+		NameTable();
+
+		NameId Intern(const std::string& text);
+		const std::string& Lookup(NameId id);
+		size_t GetCount();
+		void Clear();
+
+		// Binary layout: "PNAM", uint16 version, varint count, then varint length and bytes of each string in id order
+		bool Save(const std::string& path);
+		bool Load(std::istream& stream);
+		// Only remembers the file, strings are read on first use. Lets tools open a table they may never query.
+		void Open(const std::string& path);
+
+	private:
+		void LoadPending();
+
+		std::unordered_map<std::string, NameId> ids;
+		std::vector<const std::string*> strings; // keys of ids by id, map nodes do not move
+		std::string pendingPath;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "SpatialHash.hpp"
+#include "Threads.hpp"
+
+namespace enginetool {
+	// Exact overlap tests of broadphase pairs, split over the thread pool. Every chunk of work writes its contacts to a buffer
+	// of its own and the buffers are joined in chunk order. Chunks depend only on the input, so the contacts and their order
+	// are the same for any number of workers, and the caller can act on them in a loop that gives the same result every time.
+	// Boxes are six floats per id, three of min and three of max, and overlap when they touch like in ScenePart::Overlaps.
+	class Narrowphase {
+	public:
+		using Contact = std::pair<uint32_t, uint32_t>;
+
+		// Pairs tested by one job
+		static constexpr size_t pairsPerJob = 1024;
+		// Broadphase boxes searched for pairs by one job
+		static constexpr size_t boxesPerJob = 256;
+
+		// Appends the pairs whose boxes overlap, in the order of pairs
+		void FindContacts(ThreadPool* threadPool, const std::vector<Contact>& pairs, const float* boxes, std::vector<Contact>& contacts);
+		// Appends the pairs of the broadphase whose boxes overlap, smaller id first; finding the pairs is split over the pool as well
+		void FindContacts(ThreadPool* threadPool, const SpatialHash& broadphase, const float* boxes, std::vector<Contact>& contacts);
+
+	private:
+		static bool Overlaps(const float* boxes, const Contact& pair);
+		void Merge(size_t chunkCount, std::vector<Contact>& contacts) const;
+
+		std::vector<std::vector<Contact>> chunkContacts; // kept between calls so the buffers stay allocated
+	};
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <assert.h>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace enginetool {
+	// Reserve for a bulk insert without giving up geometric growth, so many small batches still reallocate rarely
+	template<typename Container>
+	void ReserveMore(Container& container, size_t count) {
+		const size_t size = container.size() + count;
+		if (size > container.capacity()) {
+			container.reserve(std::max(size, container.capacity() * 2));
+		}
+	}
+
+	// Fixed-size pool for one object type. Storage grows in chunks that never move, so objects keep their address,
+	// and freed slots go on an intrusive free list, so creating and destroying objects rarely touches the heap.
+	template<typename T>
+	class ObjectPool {
+	public:
+		explicit ObjectPool(size_t chunkSize = 256) : chunkSize(chunkSize > 0 ? chunkSize : 1) {}
+		~ObjectPool() {
+			assert(liveCount == 0 && "objects must be destroyed before their pool");
+		}
+
+		ObjectPool(const ObjectPool&) = delete;
+		ObjectPool& operator=(const ObjectPool&) = delete;
+
+		template<typename... Args>
+		T* Create(Args&&... args) {
+			if (freeList == nullptr) {
+				AddChunk(chunkSize);
+			}
+			Slot* slot = freeList;
+			freeList = slot->next;
+			try {
+				T* object = new (slot->storage) T(std::forward<Args>(args)...);
+				liveCount++;
+				return object;
+			}
+			catch (...) {
+				slot->next = freeList;
+				freeList = slot;
+				throw;
+			}
+		}
+
+		void Destroy(T* object) {
+			if (object == nullptr) {
+				return;
+			}
+			object->~T();
+			Slot* slot = reinterpret_cast<Slot*>(object);
+			slot->next = freeList;
+			freeList = slot;
+			liveCount--;
+		}
+
+		// Shared ownership for containers that hold shared_ptr; the last owner hands the slot back to this pool.
+		template<typename... Args>
+		std::shared_ptr<T> MakeShared(Args&&... args) {
+			return std::shared_ptr<T>(Create(std::forward<Args>(args)...), Deleter{ this });
+		}
+
+		// Makes room for count more objects in one chunk
+		void Reserve(size_t count) {
+			size_t available = capacity - liveCount;
+			if (count > available) {
+				AddChunk(count - available);
+			}
+		}
+
+		size_t GetLiveCount() const { return liveCount; }
+		size_t GetCapacity() const { return capacity; }
+
+	private:
+		union Slot {
+			Slot* next;
+			alignas(T) unsigned char storage[sizeof(T)];
+		};
+
+		struct Deleter {
+			ObjectPool* pool;
+			void operator()(T* object) const { pool->Destroy(object); }
+		};
+
+		void AddChunk(size_t count) {
+			chunks.emplace_back(new Slot[count]);
+			Slot* chunk = chunks.back().get();
+			// Linked back to front, so the chunk is handed out in address order
+			for (size_t i = count; i > 0; i--) {
+				chunk[i - 1].next = freeList;
+				freeList = &chunk[i - 1];
+			}
+			capacity += count;
+		}
+
+		std::vector<std::unique_ptr<Slot[]>> chunks;
+		Slot* freeList = nullptr;
+		size_t chunkSize;
+		size_t capacity = 0;
+		size_t liveCount = 0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Instrumentation compiled in only with -DPUFFIN_PROFILING (cmake -DPUFFIN_PROFILING=ON), otherwise every macro expands to nothing.
+// Zone, counter and frame names are stored as pointers, pass string literals or strings that outlive the trace dump.
+
+#define PUFFIN_PROFILE_CONCAT_INNER(a, b) a##b
+#define PUFFIN_PROFILE_CONCAT(a, b) PUFFIN_PROFILE_CONCAT_INNER(a, b)
+
+#if PUFFIN_PROFILING
+#define PUFFIN_PROFILE_ZONE(name) enginetool::profiler::Zone PUFFIN_PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PUFFIN_PROFILE_FUNCTION() PUFFIN_PROFILE_ZONE(__func__)
+#define PUFFIN_PROFILE_COUNTER(name, value) enginetool::profiler::Counter(name, static_cast<double>(value))
+#define PUFFIN_PROFILE_FRAME(name) enginetool::profiler::Frame(name)
+#define PUFFIN_PROFILE_THREAD(name) enginetool::profiler::SetThreadName(name)
+#define PUFFIN_PROFILE_DUMP(path) enginetool::profiler::WriteChromeTrace(path)
+#else
+#define PUFFIN_PROFILE_ZONE(name) ((void)0)
+#define PUFFIN_PROFILE_FUNCTION() ((void)0)
+#define PUFFIN_PROFILE_COUNTER(name, value) ((void)0)
+#define PUFFIN_PROFILE_FRAME(name) ((void)0)
+#define PUFFIN_PROFILE_THREAD(name) ((void)0)
+#define PUFFIN_PROFILE_DUMP(path) ((void)0)
+#endif
+
+namespace enginetool {
+	namespace profiler {
+		enum class EventType : uint8_t {
+			Zone, Counter, Frame
+		};
+
+		struct Event {
+			const char* name;
+			uint64_t start; // ns since the profiler started
+			uint64_t duration; // ns, zones only
+			double value; // counters only
+			EventType type;
+		};
+
+		uint64_t Now();
+		void Record(const Event& event);
+		void Counter(const char* name, double value);
+		void Frame(const char* name);
+		void SetThreadName(const std::string& name);
+
+		// Every thread keeps the newest events in its own ring, older ones are overwritten.
+		// Dump while the recording threads are idle, e.g. after the main loop ended.
+		void WriteChromeTrace(std::ostream& stream);
+		bool WriteChromeTrace(const std::string& path);
+		void Clear();
+
+		class Zone {
+		public:
+			explicit Zone(const char* name) : name(name), start(Now()) {}
+			~Zone() {
+				const uint64_t end = Now();
+				Record(Event{ name, start, end - start, 0.0, EventType::Zone });
+			}
+
+			Zone(const Zone&) = delete;
+			Zone& operator=(const Zone&) = delete;
+
+		private:
+			const char* name;
+			uint64_t start;
+		};
+	}
+}
@@ -3,7 +3,10 @@
 #include <utility>
 #include <map>
 
+#include "CpuTopology.hpp"
 #include "Device.hpp"
+#include "FrameAllocator.hpp"
+#include "InputRecorder.hpp"
 #include "RenderPass.hpp"
 #include "Scene.hpp"
 #include "GuiMainHub.hpp"
@@ -58,9 +61,16 @@ private:
 
     void DrawFrame();
     void GatherThreadInfo();
+    void InitInputCapture();
 
     void mainLoop();
-    void PressKey(int key);
+    void OnCursorPosition(double x, double y);
+    void OnKey(int key, int action);
+    void OnMouseButton(int button, int action);
+    void PressKey(int key, int action);
+    void RecordFrame(float alpha);
+    void RecordInput(enginetool::InputEventType type, int code, int action, double x, double y);
+    enginetool::InputEvent ReplayInput();
 	void RecreateSwapChain();
     void StartGame();
     void UpdateGui();
@@ -93,6 +103,11 @@ private:
     enginetool::ThreadPool m_ThreadPool;
     bool m_GameStarted = false;
 
+    enginetool::InputRecorder m_InputRecorder;
+    enginetool::InputReplay m_InputReplay;
+    std::vector<enginetool::InputEvent> m_ReplayEvents;
+    uint64_t m_TickIndex = 0;
+
     double xpos, ypos;
 	int fb_width, fb_height; // framebuffer sizes are, in contrast to the window coordinates given in pixels in order to match Vulkans requirements for viewport.
 
@@ -107,4 +122,5 @@ private:
     void deinitMousePicker();
     void DestroyScene();
     void deinitWorldClock();
+    void DeInitInputCapture();
 };
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+
+#include "MotionKernels.hpp"
+
+namespace enginetool {
+	// count boxes as six arrays, structure of arrays: box i spans min[axis][i] to max[axis][i]
+	struct BoxArrays {
+		const float* min[3];
+		const float* max[3];
+	};
+
+	// count rays as six arrays: ray i starts at origin[axis][i], dirFrac[axis][i] is one over its direction
+	struct RayArrays {
+		const float* origin[3];
+		const float* dirFrac[3];
+	};
+
+	// Slab tests with the arithmetic of ScenePart::RayIntersection, run on the level picked in MotionKernels. A ray enters a box
+	// at distance tmin along its direction, negative when it starts inside. Distances of misses are +infinity, or NaN for a ray
+	// lying in a box face, so a test of distance <= a finite maxDistance drops both. Every level gives bit-identical results.
+
+	// One ray against count boxes: distances[i] is where the ray enters box i.
+	void IntersectRayBoxes(const float* origin, const float* dirFrac, const BoxArrays& boxes, size_t count, float* distances);
+	void IntersectRayBoxes(SimdLevel level, const float* origin, const float* dirFrac, const BoxArrays& boxes, size_t count, float* distances);
+
+	// One ray against count boxes: the box entered first within maxDistance, the lowest index on ties, and its distance.
+	// Returns count when the ray hits nothing in range, distance is left alone then.
+	size_t NearestRayBox(const float* origin, const float* dirFrac, const BoxArrays& boxes, size_t count, float maxDistance, float& distance);
+	size_t NearestRayBox(SimdLevel level, const float* origin, const float* dirFrac, const BoxArrays& boxes, size_t count, float maxDistance, float& distance);
+
+	// A packet of count rays against one box given as three floats of min and three of max: distances[i] is where ray i enters it.
+	void IntersectRaysBox(const RayArrays& rays, size_t count, const float* min, const float* max, float* distances);
+	void IntersectRaysBox(SimdLevel level, const RayArrays& rays, size_t count, const float* min, const float* max, float* distances);
+}
\ No newline at end of file
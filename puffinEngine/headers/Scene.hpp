@@ -6,18 +6,28 @@
 
 #define DYNAMIC_UB_OBJECTS 125 // Clouds
 
+#include "AabbTree.hpp"
+#include "ActorRoster.hpp"
 #include "Character.hpp"
 #include "Camera.hpp"
 #include "Buffer.hpp"
+#include "FrustumCulling.hpp"
 #include "Landscape.hpp"
 #include "Light.hpp"
 #include "GuiMainHub.hpp"
+#include "Heightfield.hpp"
+#include "InstanceBatch.hpp"
 #include "MainCharacter.hpp"
 #include "MaterialLibrary.hpp"
 #include "MeshLibrary.hpp"
+#include "MotionKernels.hpp"
 #include "MousePicker.hpp"
+#include "Narrowphase.hpp"
+#include "ObjectPool.hpp"
 #include "RenderPass.hpp"
+#include "SceneSnapshot.hpp"
 #include "SwapChain.hpp"
+#include "TaskGraph.hpp"
 #include "Texture.hpp"
 #include "Ui.hpp"
 
@@ -26,10 +36,12 @@ const int HEIGHT = 600;
 const float horizon = 9832.0f; //0.5km
 static float cloudsPos = 0.0f;
 const float cloudsVisibDist = 1.0f;
+const size_t actorsPerJob = 256; // ParallelFor chunk size for per-actor loops
 
 namespace puffinengine {
 	namespace tool {
-		class Scene {
+		// Actors are spawned and despawned through the roster; the scene adds their rendering and the queries in its world.
+		class Scene : public enginetool::ActorRoster {
 		public:
 			Scene();
 			~Scene();
@@ -42,6 +54,21 @@ namespace puffinengine {
 			void deinit();
 			
 			void DeSelect();
+			// Removes an actor from the scene and every list it is in. Returns false for a stale handle.
+			bool DestroyActor(enginetool::Handle<Actor> handle);
+			// Removes all live actors among handles with one pass over the actor lists. Returns how many were removed.
+			size_t Despawn(const std::vector<enginetool::Handle<Actor>>& handles);
+			// Places static copies of a mesh in one call, without an actor each. Copies with the same mesh and material share a batch.
+			void PlaceInstances(const std::string& meshName, const std::string& materialName, const std::vector<enginetool::InstanceLayout>& instances);
+			// Adds the batches of an instance file to the scene, false if it cannot be read
+			bool LoadInstances(const std::string& path);
+			bool SaveInstances(const std::string& path) const;
+			// Writes the landscape, lights, characters and instance batches to a snapshot, false if one of them uses a mesh or material
+			// that is not in the libraries or the file cannot be written
+			bool SaveSnapshot(const std::string& path);
+			// Adds the actors and batches of a snapshot to the scene. Adds nothing and returns false if the file cannot be read or refers
+			// to meshes or materials the libraries lack.
+			bool LoadSnapshot(const std::string& path);
 			void HandleMouseClick();
 			void CreateCommandBuffers();
 			void CreateMenuCommandBuffers();
@@ -52,6 +79,7 @@ namespace puffinengine {
 			unsigned int GetMainCharacterMaxHealth() const;
 			void UpdateGUI();
 			void update();
+			void PrepareFrame(float alpha);
 
 			// ------------ Scene navigation functions ------------- //
 
@@ -96,16 +124,16 @@ namespace puffinengine {
 			void TextOverlayToggle();
 
 			std::shared_ptr<Camera> currentCamera;
-			std::shared_ptr<Actor> selectedActor;
-			std::unique_ptr<Actor> mainCharacter;
+			enginetool::Handle<Actor> selectedActor; // goes stale, not dangling, when the actor is destroyed
+			std::unique_ptr<MainCharacter> mainCharacter;
+
+			std::vector<enginetool::InstanceBatch> instanceBatches;
 
 			std::vector<std::shared_ptr<Actor>> sceneCameras;
 			std::vector<std::shared_ptr<Actor>> seas;
 			std::vector<std::shared_ptr<Actor>> skyboxes;
 			std::vector<std::shared_ptr<Actor>> clouds;
 
-			std::vector<std::shared_ptr<Actor>> actors;
-
 			GuiMainHub* m_GUIMainHub = nullptr;
 
 			std::vector<VkCommandBuffer> commandBuffers;
@@ -117,13 +145,14 @@ namespace puffinengine {
 
 			VkCommandBuffer BeginSingleTimeCommands();
 			void CheckActorsVisibility();
-			void CheckIfItIsVisible(std::shared_ptr<Actor>& actorToCheck);
+			void CheckInstancesVisibility(const enginetool::Frustum& frustum, const enginetool::Frustum& mirrored);
 			void CleanUpDepthResources();
+			void CollectMovingActors();
 			void CleanUpOffscreenImage();
 			void copyBuffer(enginetool::Buffer* srcBuffer, enginetool::Buffer* dstBuffer, const VkDeviceSize size);
 			void CreateActorsBuffers();
 			void CreateBuffers();
-			void CreateCamera(std::string name, std::string description, glm::vec3 position, enginetool::ScenePart& mesh, enginetool::SceneMaterial& material);
+			enginetool::Handle<Camera> CreateCamera(std::string name, std::string description, glm::vec3 position, enginetool::ScenePart& mesh, enginetool::SceneMaterial& material);
 			void CreateCommandPool(); // neccsesary to create command buffer
 			void CreateDepthResources();
 			void CreateDescriptorPool();
@@ -133,36 +162,44 @@ namespace puffinengine {
 			void CreateGraphicsPipeline();
 			void CreateGUI(float, uint32_t);
 			void CreateImage(uint32_t, uint32_t, VkFormat, VkImageTiling, VkImageUsageFlags, VkMemoryPropertyFlags, VkImage&, VkDeviceMemory&);
-			void CreateLandscape(std::string name, std::string description, glm::vec3 position, enginetool::ScenePart& mesh, enginetool::SceneMaterial& material);
+			enginetool::Handle<Landscape> CreateLandscape(std::string name, std::string description, glm::vec3 position, enginetool::ScenePart& mesh, enginetool::SceneMaterial& material);
 			VkImageView CreateImageView(VkImage, VkFormat, VkImageAspectFlags);
-			void CreateSea(std::string name, std::string description, glm::vec3 position);
+			enginetool::Handle<Sea> CreateSea(std::string name, std::string description, glm::vec3 position);
 			VkShaderModule CreateShaderModule(const std::vector<char>&);
-			void CreateSkybox(std::string name, std::string description, glm::vec3 position, float horizon);
+			enginetool::Handle<Skybox> CreateSkybox(std::string name, std::string description, glm::vec3 position, float horizon);
 			void CreateTextureImageView(TextureLayout&);
 			void CreateTextureSampler(TextureLayout&);
 			void CreateSelectRay();
-			void CreateCharacter(std::string name, std::string description, glm::vec3 position, enginetool::ScenePart& mesh, enginetool::SceneMaterial& material);
-			void CreateCloud(std::string name, std::string description, glm::vec3 position, enginetool::ScenePart& mesh);
+			enginetool::Handle<Character> CreateCharacter(std::string name, std::string description, glm::vec3 position, enginetool::ScenePart& mesh, enginetool::SceneMaterial& material);
+			enginetool::Handle<Cloud> CreateCloud(std::string name, std::string description, glm::vec3 position, enginetool::ScenePart& mesh);
 			void CreateMappedIndexBuffer(std::vector<uint32_t>& indices, enginetool::Buffer& indexBuffer);
 			void CreateMappedVertexBuffer(std::vector<enginetool::VertexLayout>& vertices, enginetool::Buffer& vertexBuffer);
-			void CreateSphereLight(std::string name, std::string description, glm::vec3 position, enginetool::ScenePart& mesh);
+			enginetool::Handle<SphereLight> CreateSphereLight(std::string name, std::string description, glm::vec3 position, enginetool::ScenePart& mesh);
 			void CreateIndexBuffer(std::vector<uint32_t>& indices, enginetool::Buffer& indexBuffer);
 			void CreateVertexBuffer(std::vector<enginetool::VertexLayout>& vertices, enginetool::Buffer& vertexBuffer);
 			void EndSingleTimeCommands(const VkCommandBuffer& commandBuffer, const VkCommandPool& commandPool);
 			bool FindDestinationPosition(glm::vec3& destinationPoint);
+			void CreateScenery();
+			enginetool::InstanceBatch& FindInstanceBatch(const std::string& meshName, const std::string& materialName);
 			bool HasStencilComponent(VkFormat);
 			void InitMaterials();
+			void InterpolateTransforms();
 			void LoadAssets();
+			auto MeshHitTest(const glm::vec3& rayOrigin, const glm::vec3& rayDirection) const;
 			void PrepeareMainCharacter(enginetool::ScenePart& mesh);
 			void PrepareOffscreenImage();
-			void ProcesTasksMultithreaded(enginetool::ThreadPool* threadPool, std::vector<std::function<void()>>& tasks);
 			void RandomPositions();
+			void ResolveContacts();
 			void SelectActor();
+			void UpdateBroadphase();
+			void UpdateRayQueries();
 			void UpdateCloudsUniformBuffer();
 			void UpdateDescriptorSet();
 			void UpdateDynamicUniformBuffer();
 			void UpdateSelectRayDrawData();
 			void UpdateOceanUniformBuffer();
+			template<typename T>
+			void UpdateBucket(std::vector<T*>& bucket, enginetool::MotionStore& motion, float dt);
 			void UpdatePositions();
 			void UpdateSelectionIndicatorUniformBuffer();
 			void UpdateSkyboxUniformBuffer();
@@ -170,19 +207,49 @@ namespace puffinengine {
 			void UpdateOffscreenUniformBuffer();
 			void UpdateUniformBufferParameters();
 
-			std::function<void()> task1 = std::bind(&Scene::CheckActorsVisibility, this);
-			std::function<void()> task2 = std::bind(&Scene::UpdatePositions, this);
-			std::function<void()> task3 = std::bind(&Scene::UpdateSkyboxUniformBuffer, this);
-			std::function<void()> task4 = std::bind(&Scene::UpdateUniformBufferParameters, this);
-			std::function<void()> task5 = std::bind(&Scene::UpdateStaticUniformBuffer, this);
-			std::function<void()> task6 = std::bind(&Scene::UpdateSelectionIndicatorUniformBuffer, this);
-			std::function<void()> task7 = std::bind(&Scene::UpdateOffscreenUniformBuffer, this);
-			std::function<void()> task8 = std::bind(&Scene::UpdateDynamicUniformBuffer, this);
-			std::function<void()> task9 = std::bind(&Scene::UpdateOceanUniformBuffer, this);
-			std::function<void()> task10 = std::bind(&Scene::UpdateCloudsUniformBuffer, this);
-			std::function<void()> task11 = std::bind(&Scene::CreateCommandBuffers, this);
-			std::function<void()> task12 = std::bind(&Scene::CreateReflectionCommandBuffer, this);
-			std::function<void()> task13 = std::bind(&Scene::CreateRefractionCommandBuffer, this);
+			void BuildFrameTaskGraph();
+			void BuildSimulationTaskGraph();
+
+			std::vector<Actor*> movingActors; // see CollectMovingActors
+			// Grids over the AABBs of `actors` as they were at the start of the tick, so sensing does not test every pair of actors.
+			// broadphase holds the moving actors and is built every tick; restingBroadphase holds the sleeping ones and is kept
+			// between ticks, a box there only counts while its actor's inRestingBroadphase is set.
+			enginetool::SpatialHash broadphase;
+			enginetool::SpatialHash restingBroadphase;
+			std::vector<uint32_t> restingCandidates;
+			std::vector<enginetool::Narrowphase::Contact> restingPairs;
+			// Pairs of its actors whose AABBs overlap, found on every thread at once from copies of the AABBs, six floats per actor
+			enginetool::Narrowphase narrowphase;
+			std::vector<enginetool::ScenePart::AABB> contactBoxes;
+			std::vector<enginetool::Narrowphase::Contact> contacts;
+			// Ray queries over the same AABBs: picking, destinations and ground probes. Refit each tick, rebuilt when that is no longer enough.
+			enginetool::AabbTree rayTree;
+			// Ground for actors to stand on: landscapes baked into a height grid, every other actor in a tree of its own
+			enginetool::Heightfield heightfield;
+			enginetool::AabbTree groundTree;
+			std::vector<uint32_t> groundBoxes; // by actor index, its box in groundTree or none
+			std::vector<uint32_t> movedBoxes;
+			std::vector<uint32_t> movedGroundBoxes;
+			std::vector<enginetool::ScenePart::AABB> staticBoxes; // by actor index, the landscape boxes heightfield was baked from
+
+			// Actors inside the camera frustum, in the order of actors, for command recording
+			std::vector<Actor*> visibleActors;
+			std::vector<uint8_t> actorVisibility; // by actor index
+			std::vector<float> cullBounds; // AABBs where actors are drawn: min x, y and z arrays, then max
+			// Instances inside the frustum by batch, and inside its mirror image for the reflection pass
+			std::vector<std::vector<uint32_t>> visibleInstances;
+			std::vector<std::vector<uint32_t>> reflectedInstances;
+			std::vector<uint8_t> instanceVisibility; // of the batch being culled
+			std::vector<uint8_t> reflectedVisibility;
+			std::vector<float> instanceCullBounds; // laid out like cullBounds
+
+			enginetool::Handle<Skybox> skyboxHandle;
+			enginetool::Handle<Sea> seaHandle;
+			enginetool::Handle<SphereLight> sceneLightHandle; // lights the scene in the parameter uniform buffer
+
+			enginetool::TaskGraph frameTaskGraph;
+			enginetool::TaskGraph simulationTaskGraph;
+			float interpolationAlpha = 1.0f;
 
 			// ---------------- Deinitialisation ---------------- //
 
@@ -361,9 +428,6 @@ namespace puffinengine {
 			VkDescriptorPool descriptorPool;
 			VkPipelineLayout pipelineLayout;
 
-			VkRect2D scissor = {};
-			VkViewport viewport = {};
-
 			GLFWwindow* p_Window = nullptr;
 			Device* m_Device = nullptr;
 			SwapChain* p_SwapChain = nullptr;
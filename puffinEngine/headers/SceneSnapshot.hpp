@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace enginetool {
+	// A saved scene laid out the way it is used, so a loader maps the file and reads records in place instead of parsing it.
+	// Layout: header, actor records, batch records, instance positions, string offsets, then the characters. Every block starts on
+	// a 4 byte boundary. Records refer to strings by index, each distinct string is stored once and ends with '\0'.
+	namespace snapshot {
+		const char magic[4] = { 'P', 'S', 'C', 'N' };
+		const uint16_t fileVersion = 1;
+		const uint32_t byteOrderMark = 0x01020304; // files are written in native order and only read on machines with the same one
+		const uint32_t none = 0xffffffff;
+
+		struct Header {
+			char magic[4];
+			uint16_t version;
+			uint16_t headerSize;
+			uint32_t byteOrder;
+			uint32_t actorCount;
+			uint32_t actorsOffset;
+			uint32_t batchCount;
+			uint32_t batchesOffset;
+			uint32_t instanceCount;
+			uint32_t instancesOffset; // three floats per instance
+			uint32_t stringCount;
+			uint32_t stringTableOffset; // where each string starts in the characters
+			uint32_t charactersSize;
+			uint32_t charactersOffset;
+			uint32_t sceneLight; // index of the actor that lights the scene, or none
+		};
+
+		struct ActorRecord {
+			uint32_t type; // ActorType
+			uint32_t name; // string indices
+			uint32_t description;
+			uint32_t mesh;
+			uint32_t material;
+			float position[3];
+			float lightColor[3]; // lights only
+			uint32_t maxHealth; // landscape and characters
+			int32_t currentHealth;
+			uint32_t gold; // characters only
+		};
+
+		struct BatchRecord {
+			uint32_t mesh;
+			uint32_t material;
+			uint32_t firstInstance;
+			uint32_t instanceCount;
+		};
+	}
+
+	// Collects a scene and writes it as a snapshot
+	class SceneSnapshotWriter {
+	public:
+		uint32_t AddString(const std::string& text);
+		void AddActor(const snapshot::ActorRecord& actor);
+		void AddBatch(const std::string& mesh, const std::string& material, const float* positions, size_t instanceCount);
+		void SetSceneLight(uint32_t actorIndex) { sceneLight = actorIndex; }
+		size_t GetActorCount() const { return actors.size(); }
+		bool Save(const std::string& path) const;
+
+	private:
+		std::vector<snapshot::ActorRecord> actors;
+		std::vector<snapshot::BatchRecord> batches;
+		std::vector<float> positions;
+		std::vector<uint32_t> stringTable;
+		std::string characters;
+		std::unordered_map<std::string, uint32_t> stringIndices;
+		uint32_t sceneLight = snapshot::none;
+	};
+
+	// Read only view of a snapshot. The file is memory mapped where the platform allows it and read into one buffer elsewhere;
+	// records point into that memory and stay valid until Close.
+	class SceneSnapshot {
+	public:
+		SceneSnapshot() = default;
+		~SceneSnapshot();
+
+		SceneSnapshot(const SceneSnapshot&) = delete;
+		SceneSnapshot& operator=(const SceneSnapshot&) = delete;
+
+		// False if the file cannot be read or any block, string or instance range in it lies outside the file
+		bool Open(const std::string& path);
+		void Close();
+		bool IsOpen() const { return data != nullptr; }
+
+		const snapshot::Header& GetHeader() const { return *reinterpret_cast<const snapshot::Header*>(data); }
+		const snapshot::ActorRecord* GetActors() const;
+		const snapshot::BatchRecord* GetBatches() const;
+		const float* GetInstancePositions() const;
+		const char* GetString(uint32_t index) const;
+
+	private:
+		bool Validate() const;
+
+		const char* data = nullptr;
+		size_t size = 0;
+		bool mapped = false;
+		std::vector<char> buffer;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace enginetool {
+	// Broadphase over axis aligned boxes: a uniform grid of cubic cells, hashed into a table sized to the number of boxes.
+	// Boxes are given as three floats of min and three of max, so glm::vec3 and plain arrays both fit. The grid is rebuilt
+	// from scratch each tick (Clear, Insert, Build), which is linear in the number of boxes. Queries are read only and may
+	// run on several threads at once.
+	class SpatialHash {
+	public:
+		explicit SpatialHash(float cellSize = 64.0f);
+
+		// Boxes that cover more than this many cells are kept in a short list instead of the grid and tested against everything
+		static constexpr uint32_t maxCellsPerBox = 64;
+
+		void SetCellSize(float size);
+		float GetCellSize() const { return cellSize; }
+		size_t GetCount() const { return ids.size(); }
+
+		void Clear();
+		void Insert(uint32_t id, const float* min, const float* max);
+		void Build();
+
+		// Appends the id of every box that shares a cell with the given box, each once. Candidates still need an exact overlap test.
+		void Query(const float* min, const float* max, std::vector<uint32_t>& candidates) const;
+		// Appends every pair of boxes that share a cell, each once and with the smaller id first
+		void FindPairs(std::vector<std::pair<uint32_t, uint32_t>>& pairs) const;
+		// The same pairs split into partCount parts, part is one of them; each part can be searched on a thread of its own
+		void FindPairs(std::vector<std::pair<uint32_t, uint32_t>>& pairs, uint32_t part, uint32_t partCount) const;
+
+	private:
+		struct CellRange {
+			int32_t min[3];
+			int32_t max[3];
+		};
+
+		struct Entry {
+			uint32_t box;
+			int32_t cell[3];
+		};
+
+		CellRange ToCells(const float* min, const float* max) const;
+		static uint64_t CellCount(const CellRange& range);
+		uint32_t Slot(const int32_t* cell) const;
+		// Two ranges that overlap share several cells; a pair is only reported from the lowest of them
+		static bool IsFirstSharedCell(const CellRange& a, const CellRange& b, const int32_t* cell);
+		static bool Overlaps(const CellRange& a, const CellRange& b);
+
+		float cellSize;
+		float inverseCellSize;
+		std::vector<uint32_t> ids;
+		std::vector<CellRange> ranges; // by box index, in insertion order
+		std::vector<uint32_t> largeBoxes;
+		std::vector<Entry> entries; // grouped by slot
+		std::vector<uint32_t> slotStarts; // entries of slot s are [slotStarts[s], slotStarts[s + 1])
+		uint32_t slotMask = 0;
+	};
+}
\ No newline at end of file
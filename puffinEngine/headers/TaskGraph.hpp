@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Threads.hpp"
+
+namespace enginetool {
+	// Frame work split into tasks that declare which resources they read and write.
+	// A task waits only for earlier tasks that write what it touches or read what it writes, everything else overlaps on the pool.
+	class TaskGraph {
+	public:
+		TaskGraph();
+		~TaskGraph();
+
+		uint32_t AddTask(const std::string& name, std::function<void()> function, const std::vector<std::string>& reads, const std::vector<std::string>& writes);
+		void Clear();
+		void Run(ThreadPool* threadPool);
+		void DumpGraphviz(std::ostream& stream) const;
+
+		size_t GetTaskCount() const { return tasks.size(); }
+		const std::vector<uint32_t>& GetDependencies(uint32_t task) const { return tasks[task].dependencies; }
+
+	private:
+		struct Task {
+			std::string name;
+			std::function<void()> function;
+			std::vector<std::string> reads;
+			std::vector<std::string> writes;
+			std::vector<uint32_t> dependencies;
+			std::vector<uint32_t> successors;
+		};
+
+		struct ResourceState {
+			int64_t lastWriter = -1;
+			std::vector<uint32_t> readersSinceWrite;
+		};
+
+		std::vector<Task> tasks;
+		std::map<std::string, ResourceState> resources;
+		std::unique_ptr<std::atomic<uint32_t>[]> pendingDependencies;
+		size_t pendingCapacity = 0;
+
+		struct RunContext {
+			TaskGraph* graph;
+			ThreadPool* threadPool;
+			JobCounter* counter;
+		};
+
+		void RunTask(uint32_t task, const RunContext& context);
+		std::string DescribeEdge(uint32_t from, uint32_t to) const;
+	};
+}
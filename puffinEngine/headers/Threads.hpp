@@ -1,11 +1,19 @@
 #pragma once
 
+#include <algorithm>
 #include <assert.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <vector>
-#include <queue>
+#include <memory>
 #include <mutex>
 #include <condition_variable>
 #include <functional>
+#include <string>
+#include <thread>
+
+#include "Profiler.hpp"
 
 #ifdef WIN32
 #define NOMINMAX
@@ -14,16 +22,283 @@
 #include <thread>
 #endif
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace enginetool {
+	class Thread;
+	class ThreadPool;
+	struct Job;
+	struct WorkSignal;
+	void RunJob(Job& job, WorkSignal& signal);
+
+	// Job handle: every job submitted with a counter increments it, and it drops back to zero once all of them finished.
+	class JobCounter {
+	public:
+		bool IsDone() const {
+			return pending.load(std::memory_order_acquire) == 0;
+		}
+
+	private:
+		friend class Thread;
+		friend class ThreadPool;
+		friend void RunJob(Job& job, WorkSignal& signal);
+
+		std::atomic<uint32_t> pending{ 0 };
+	};
+
+	struct Job {
+		std::function<void()> function;
+		JobCounter* counter = nullptr;
+	};
+
+	inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+		_mm_pause();
+#else
+		std::this_thread::yield();
+#endif
+	}
+
+	// Bounded multi-producer multi-consumer ring (Dmitry Vyukov's design): one CAS per push or pop and no locks.
+	// Every cell carries a sequence number telling whether it is free for the producer or filled for the consumer at a given position.
+	template<typename T>
+	class BoundedQueue {
+	public:
+		explicit BoundedQueue(size_t capacity) {
+			size_t size = 2;
+			while (size < capacity) {
+				size <<= 1;
+			}
+			mask = size - 1;
+			buffer.reset(new Cell[size]);
+			for (size_t i = 0; i < size; i++) {
+				buffer[i].sequence.store(i, std::memory_order_relaxed);
+			}
+		}
+
+		bool TryPush(T&& data) {
+			size_t position = enqueuePosition.load(std::memory_order_relaxed);
+			Cell* cell;
+			while (true) {
+				cell = &buffer[position & mask];
+				const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+				const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+				if (difference == 0) {
+					if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+						break;
+					}
+				}
+				else if (difference < 0) {
+					return false;
+				}
+				else {
+					position = enqueuePosition.load(std::memory_order_relaxed);
+				}
+			}
+			cell->data = std::move(data);
+			cell->sequence.store(position + 1, std::memory_order_release);
+			return true;
+		}
+
+		bool TryPop(T& data) {
+			size_t position = dequeuePosition.load(std::memory_order_relaxed);
+			Cell* cell;
+			while (true) {
+				cell = &buffer[position & mask];
+				const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+				const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+				if (difference == 0) {
+					if (dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+						break;
+					}
+				}
+				else if (difference < 0) {
+					return false;
+				}
+				else {
+					position = dequeuePosition.load(std::memory_order_relaxed);
+				}
+			}
+			data = std::move(cell->data);
+			cell->data = T();
+			cell->sequence.store(position + mask + 1, std::memory_order_release);
+			return true;
+		}
+
+		size_t Capacity() const { return mask + 1; }
+
+	private:
+		static const size_t cacheLineSize = 64;
+
+		struct Cell {
+			std::atomic<size_t> sequence;
+			T data;
+		};
+
+		std::unique_ptr<Cell[]> buffer;
+		size_t mask = 0;
+		// Producers and consumers hammer different positions, keep them on separate cache lines.
+		char paddingBefore[cacheLineSize];
+		std::atomic<size_t> enqueuePosition{ 0 };
+		char paddingBetween[cacheLineSize - sizeof(std::atomic<size_t>)];
+		std::atomic<size_t> dequeuePosition{ 0 };
+		char paddingAfter[cacheLineSize - sizeof(std::atomic<size_t>)];
+	};
+
+	// Bounded Chase-Lev deque (in the C11 form of Le, Pop, Cohen and Zappa Nardelli). Only the owner pushes and pops, at the
+	// bottom, so it runs its newest and still cache-warm jobs first; any thread steals the oldest ones from the top.
+	// Cells hold pointers, so a thief that loses the race for a cell never reads a job while someone else moves it out.
+	template<typename T>
+	class WorkStealingDeque {
+	public:
+		explicit WorkStealingDeque(size_t capacity) {
+			size_t size = 2;
+			while (size < capacity) {
+				size <<= 1;
+			}
+			mask = size - 1;
+			cells.reset(new std::atomic<T*>[size]);
+			for (size_t i = 0; i < size; i++) {
+				cells[i].store(nullptr, std::memory_order_relaxed);
+			}
+		}
+
+		// Owner only. Fails when the deque is full.
+		bool TryPush(T* item) {
+			const int64_t b = bottom.load(std::memory_order_relaxed);
+			const int64_t t = top.load(std::memory_order_acquire);
+			if (b - t > static_cast<int64_t>(mask)) {
+				return false;
+			}
+			cells[b & mask].store(item, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return true;
+		}
+
+		// Owner only, newest first.
+		T* TryPop() {
+			const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+			bottom.store(b, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t t = top.load(std::memory_order_relaxed);
+			if (t > b) {
+				bottom.store(b + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			T* item = cells[b & mask].load(std::memory_order_relaxed);
+			if (t == b) {
+				// The last one, thieves may be after it too
+				if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+					item = nullptr;
+				}
+				bottom.store(b + 1, std::memory_order_relaxed);
+			}
+			return item;
+		}
+
+		// Any thread, oldest first. Can come back empty handed when it loses a race although the deque is not empty.
+		T* TrySteal() {
+			int64_t t = top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			const int64_t b = bottom.load(std::memory_order_acquire);
+			if (t >= b) {
+				return nullptr;
+			}
+
+			T* item = cells[t & mask].load(std::memory_order_relaxed);
+			if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+				return nullptr;
+			}
+			return item;
+		}
+
+		size_t Capacity() const { return static_cast<size_t>(mask + 1); }
+
+	private:
+		static const size_t cacheLineSize = 64;
+
+		std::unique_ptr<std::atomic<T*>[]> cells;
+		int64_t mask = 0;
+		char paddingBefore[cacheLineSize];
+		std::atomic<int64_t> top{ 0 };
+		char paddingBetween[cacheLineSize - sizeof(std::atomic<int64_t>)];
+		std::atomic<int64_t> bottom{ 0 };
+		char paddingAfter[cacheLineSize - sizeof(std::atomic<int64_t>)];
+	};
+
+	// Sleeping and waking state shared by all workers of one pool (or owned by a standalone thread).
+	// Idle workers spin for a while before parking, and producers only touch the mutex when somebody is actually parked.
+	struct WorkSignal {
+		std::mutex mutex;
+		std::condition_variable wakeCondition;
+		std::condition_variable doneCondition;
+		std::atomic<uint32_t> queuedJobs{ 0 };
+		std::atomic<uint32_t> activeJobs{ 0 };
+		std::atomic<uint32_t> parkedWorkers{ 0 };
+		std::atomic<bool> stopping{ false };
+
+		void WakeOne() {
+			if (parkedWorkers.load(std::memory_order_seq_cst) != 0) {
+				{ std::lock_guard<std::mutex> lock(mutex); }
+				wakeCondition.notify_one();
+			}
+		}
+
+		void Park() {
+			std::unique_lock<std::mutex> lock(mutex);
+			parkedWorkers.fetch_add(1, std::memory_order_seq_cst);
+			wakeCondition.wait(lock, [this]() { return queuedJobs.load(std::memory_order_seq_cst) != 0 || stopping.load(std::memory_order_seq_cst); });
+			parkedWorkers.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		void Stop() {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stopping.store(true, std::memory_order_seq_cst);
+			}
+			wakeCondition.notify_all();
+		}
+	};
+
+	inline void RunJob(Job& job, WorkSignal& signal) {
+		job.function();
+
+		bool notify = false;
+		if (job.counter && job.counter->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			notify = true;
+		}
+		if (signal.activeJobs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			notify = true;
+		}
+
+		if (notify) {
+			{ std::lock_guard<std::mutex> lock(signal.mutex); }
+			signal.doneCondition.notify_all();
+		}
+	}
+}
+
 namespace enginetool {
 	class Thread {
 	public:
-		Thread() { Init(); }
-		~Thread() { DeInit(); }
+		Thread() : Thread(nullptr, 0) {}
+		Thread(ThreadPool* pool, uint32_t index);
+		~Thread() {
+			DeInit();
+		}
 
 		void AddJob(std::function<void()> function) {
-			std::lock_guard<std::mutex> lock(queueMutex);
-			jobQueue.push(std::move(function));
-			condition.notify_one();
+			addedJobs.pending.fetch_add(1, std::memory_order_relaxed);
+			PushJob(Job{ std::move(function), &addedJobs });
 		}
 
 #ifdef WIN32
@@ -40,73 +315,105 @@ namespace enginetool {
 			std::this_thread::yield();
 		}
 
-		void Wait() {
-			std::unique_lock<std::mutex> lock(queueMutex);
-			condition.wait(lock, [this]() { return jobQueue.empty(); });
+		bool PinToCpu(uint32_t cpu) {
+#ifdef __linux__
+			cpu_set_t set;
+			CPU_ZERO(&set);
+			CPU_SET(cpu, &set);
+			return pthread_setaffinity_np(worker.native_handle(), sizeof(set), &set) == 0;
+#else
+			(void)cpu;
+			return false;
+#endif
 		}
 
+		// Waits until every job added with AddJob finished, no matter which worker ended up running it.
+		void Wait();
+
 	private:
-		bool destroying = false;
+		friend class ThreadPool;
+
+		uint32_t index = 0;
+		ThreadPool* pool = nullptr;
+		WorkSignal* signal = nullptr;
+		std::unique_ptr<WorkSignal> ownSignal;
+
+		static const size_t jobQueueCapacity = 1024;
+		static const uint32_t spinRounds = 64;
+		static const uint32_t yieldRounds = 16;
+
 		std::thread worker;
-		std::queue<std::function<void()>> jobQueue;
-		std::mutex queueMutex;
-		std::condition_variable condition;
+		// Jobs the worker spawned itself, run newest first. They live in jobCells, so pushing one moves it into a cell instead of
+		// allocating; the indices of free cells go round freeJobCells, the owner takes them and whoever moved a job out returns them.
+		WorkStealingDeque<Job> ownJobs{ jobQueueCapacity };
+		std::unique_ptr<Job[]> jobCells{ new Job[jobQueueCapacity] };
+		BoundedQueue<uint32_t> freeJobCells{ jobQueueCapacity };
+		// Jobs handed in by other threads, run in the order they came
+		BoundedQueue<Job> jobQueue{ jobQueueCapacity };
+		JobCounter addedJobs;
 
-		void DeInit() {
-			if (worker.joinable()) {
-				Wait();
-				queueMutex.lock();
-				destroying = true;
-				condition.notify_one();
-				queueMutex.unlock();
-				worker.join();
-			}
+		static Thread*& CurrentWorker() {
+			static thread_local Thread* current = nullptr;
+			return current;
 		}
 
+		void DeInit();
 		void Init() {
 			worker = std::thread(&Thread::QueueLoop, this);
 		}
 
-		void QueueLoop() {
-			while (true) {
-				std::function<void()> job;
-
-				{
-					std::unique_lock<std::mutex> lock(queueMutex);
-					condition.wait(lock, [this] { return !jobQueue.empty() || destroying; });
-					if (destroying) {
-						break;
-					}
-					job = jobQueue.front();
-				}
-
-				job();
-
-				{
-					std::lock_guard<std::mutex> lock(queueMutex);
-					jobQueue.pop();
-					condition.notify_one();
-				}
-			}
-		}
+		void PushJob(Job&& job);
+		void TakeOwnJob(Job* cell, Job& job);
+		bool PopJob(Job& job);
+		bool StealJob(Job& job);
+		void QueueLoop();
 	};
 }
 
 namespace enginetool {
+	// Work-stealing pool: every worker runs the jobs it spawned newest first from its own deque, then the jobs handed to it through
+	// its ring, and when both are dry steals the oldest jobs of the other workers.
 	class ThreadPool {
 	public:
+		ThreadPool() = default;
+		~ThreadPool() { Stop(); }
+
 		std::vector<std::unique_ptr<Thread>> threads;
 
 		void SetThreadCount(uint32_t count) {
-			threads.clear();
+			Stop();
 			for (uint32_t i = 0; i < count; i++) {
-				threads.push_back(std::make_unique<Thread>());
+				threads.push_back(std::make_unique<Thread>(this, i));
+			}
+			// Workers steal from each other, so none of them may run before the whole list exists.
+			for (const std::unique_ptr<Thread>& thread : threads) {
+				thread->Init();
+			}
+		}
+
+		void Submit(std::function<void()> function) {
+			Enqueue(Job{ std::move(function), nullptr });
+		}
+
+		void Submit(std::function<void()> function, JobCounter& counter) {
+			counter.pending.fetch_add(1, std::memory_order_relaxed);
+			Enqueue(Job{ std::move(function), &counter });
+		}
+
+		// Runs queued jobs on the calling thread until the counter reaches zero.
+		void Wait(JobCounter& counter) {
+			while (!counter.IsDone()) {
+				if (!HelpOrSleep([&counter]() { return counter.IsDone(); })) {
+					return;
+				}
 			}
 		}
 
 		void Hold() {
-			for (const std::unique_ptr<Thread>& thread : threads) {
-				thread->Wait();
+			while (signal.activeJobs.load(std::memory_order_acquire) != 0) {
+				if (!HelpOrSleep([this]() { return signal.activeJobs.load(std::memory_order_acquire) == 0; })) {
+					return;
+				}
 			}
 		}
 
@@ -115,5 +422,250 @@ namespace enginetool {
 				thread->Sleep();
 			}
 		}
+
+		// Pins worker i to cpus[i], workers beyond the list stay free. Returns how many were pinned.
+		uint32_t PinThreads(const std::vector<uint32_t>& cpus) {
+			uint32_t pinned = 0;
+			for (size_t i = 0; i < threads.size() && i < cpus.size(); i++) {
+				if (threads[i]->PinToCpu(cpus[i])) {
+					pinned++;
+				}
+			}
+			return pinned;
+		}
+
+	private:
+		friend class Thread;
+
+		WorkSignal signal;
+		std::atomic<uint32_t> nextQueue{ 0 };
+
+		void Stop() {
+			if (threads.empty()) {
+				return;
+			}
+
+			Hold();
+			signal.Stop();
+			for (const std::unique_ptr<Thread>& thread : threads) {
+				thread->worker.join();
+			}
+			threads.clear();
+			signal.stopping.store(false, std::memory_order_relaxed);
+		}
+
+		void Enqueue(Job&& job) {
+			if (threads.empty()) {
+				job.function();
+				if (job.counter) {
+					job.counter->pending.fetch_sub(1, std::memory_order_acq_rel);
+				}
+				return;
+			}
+
+			// Jobs spawned by a worker stay on its own ring, everything else is spread over the workers.
+			Thread* current = Thread::CurrentWorker();
+			if (current && current->pool == this) {
+				current->PushJob(std::move(job));
+				return;
+			}
+
+			uint32_t target = nextQueue.fetch_add(1, std::memory_order_relaxed) % static_cast<uint32_t>(threads.size());
+			threads[target]->PushJob(std::move(job));
+		}
+
+		bool StealJob(uint32_t thiefIndex, Job& job) {
+			const size_t count = threads.size();
+			for (size_t i = 1; i <= count; i++) {
+				Thread* victim = threads[(thiefIndex + i) % count].get();
+				if (victim->StealJob(job)) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		// Returns false when there are no workers left to make progress.
+		template<typename Predicate>
+		bool HelpOrSleep(Predicate done) {
+			if (threads.empty()) {
+				return false;
+			}
+
+			Thread* current = Thread::CurrentWorker();
+			Job job;
+			if (current && current->pool == this) {
+				if (current->PopJob(job) || StealJob(current->index, job)) {
+					RunJob(job, signal);
+					return true;
+				}
+			}
+			else if (StealJob(nextQueue.load(std::memory_order_relaxed), job)) {
+				RunJob(job, signal);
+				return true;
+			}
+
+			std::unique_lock<std::mutex> lock(signal.mutex);
+			signal.doneCondition.wait_for(lock, std::chrono::microseconds(200), [this, &done]() {
+				return done() || signal.queuedJobs.load(std::memory_order_acquire) != 0;
+			});
+			return true;
+		}
 	};
-}
\ No newline at end of file
+}
+
+namespace enginetool {
+	inline Thread::Thread(ThreadPool* pool, uint32_t index) : index(index), pool(pool) {
+		for (uint32_t cell = 0; cell < jobQueueCapacity; cell++) {
+			freeJobCells.TryPush(uint32_t(cell));
+		}
+		if (pool) {
+			signal = &pool->signal;
+		}
+		else {
+			ownSignal = std::make_unique<WorkSignal>();
+			signal = ownSignal.get();
+			Init();
+		}
+	}
+
+	inline void Thread::Wait() {
+		if (pool) {
+			pool->Wait(addedJobs);
+			return;
+		}
+
+		std::unique_lock<std::mutex> lock(signal->mutex);
+		signal->doneCondition.wait(lock, [this]() { return addedJobs.IsDone(); });
+	}
+
+	inline void Thread::DeInit() {
+		if (!worker.joinable()) {
+			return;
+		}
+
+		if (!pool) {
+			Wait();
+			signal->Stop();
+		}
+		worker.join();
+	}
+
+	inline void Thread::PushJob(Job&& job) {
+		signal->activeJobs.fetch_add(1, std::memory_order_relaxed);
+		signal->queuedJobs.fetch_add(1, std::memory_order_seq_cst);
+		uint32_t cell = 0;
+		if (CurrentWorker() == this && freeJobCells.TryPop(cell)) {
+			jobCells[cell] = std::move(job);
+			if (ownJobs.TryPush(&jobCells[cell])) {
+				signal->WakeOne();
+				return;
+			}
+			TakeOwnJob(&jobCells[cell], job);
+		}
+		else if (jobQueue.TryPush(std::move(job))) {
+			signal->WakeOne();
+			return;
+		}
+
+		// The ring is full: the producer runs the job itself instead of blocking on the consumers.
+		signal->queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+		RunJob(job, *signal);
+	}
+
+	inline void Thread::TakeOwnJob(Job* cell, Job& job) {
+		job = std::move(*cell);
+		*cell = Job();
+		freeJobCells.TryPush(static_cast<uint32_t>(cell - jobCells.get()));
+	}
+
+	inline bool Thread::PopJob(Job& job) {
+		if (Job* own = ownJobs.TryPop()) {
+			TakeOwnJob(own, job);
+		}
+		else if (!jobQueue.TryPop(job)) {
+			return false;
+		}
+		signal->queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	inline bool Thread::StealJob(Job& job) {
+		if (Job* own = ownJobs.TrySteal()) {
+			TakeOwnJob(own, job);
+		}
+		else if (!jobQueue.TryPop(job)) {
+			return false;
+		}
+		signal->queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	inline void Thread::QueueLoop() {
+		CurrentWorker() = this;
+		PUFFIN_PROFILE_THREAD("Worker " + std::to_string(index));
+
+		uint32_t idleRounds = 0;
+		while (true) {
+			Job job;
+			if (PopJob(job) || (pool && pool->StealJob(index, job))) {
+				RunJob(job, *signal);
+				idleRounds = 0;
+				continue;
+			}
+
+			if (signal->stopping.load(std::memory_order_acquire) && signal->queuedJobs.load(std::memory_order_acquire) == 0) {
+				break;
+			}
+
+			// Spin, then yield, and only then park on the condition variable.
+			if (idleRounds < spinRounds) {
+				CpuRelax();
+			}
+			else if (idleRounds < spinRounds + yieldRounds) {
+				std::this_thread::yield();
+			}
+			else {
+				signal->Park();
+				idleRounds = 0;
+				continue;
+			}
+			idleRounds++;
+		}
+
+		CurrentWorker() = nullptr;
+	}
+}
+
+namespace enginetool {
+	// Splits [begin, end) into fixed chunks of grain elements and calls body(first, last) for each of them, the calling thread takes the first chunk.
+	// Chunk boundaries depend only on the range and the grain, never on the number of workers.
+	template<typename Function>
+	void ParallelFor(ThreadPool* threadPool, size_t begin, size_t end, size_t grain, const Function& body) {
+		if (begin >= end) {
+			return;
+		}
+
+		grain = std::max<size_t>(grain, 1);
+		if (!threadPool || threadPool->threads.empty() || end - begin <= grain) {
+			body(begin, end);
+			return;
+		}
+
+		struct Range {
+			const Function* body;
+			size_t end;
+			size_t grain;
+		} range = { &body, end, grain };
+
+		// Two pointers' worth of captures so std::function keeps the chunk job in its small buffer.
+		JobCounter counter;
+		for (size_t first = begin + grain; first < end; first += grain) {
+			const Range* shared = &range;
+			threadPool->Submit([shared, first]() { (*shared->body)(first, std::min(first + shared->grain, shared->end)); }, counter);
+		}
+
+		body(begin, begin + grain);
+		threadPool->Wait(counter);
+	}
+}
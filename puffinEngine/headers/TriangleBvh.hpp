@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace enginetool {
+	// Bounding volume hierarchy over the triangles of one mesh, in the mesh's own space, for exact ray hits. Built once with the
+	// surface area heuristic and kept in a file next to the mesh, so later starts read it back instead of building it again.
+	// Triangles keep their three corners, so a built hierarchy no longer needs the vertex buffer it came from.
+	class TriangleBvh {
+	public:
+		bool IsEmpty() const { return nodes.empty(); }
+		size_t GetTriangleCount() const { return corners.size() / 9; }
+		size_t GetNodeCount() const { return nodes.size(); }
+
+		// Triangles are indexCount / 3 triples of indices into positions, three floats each, stride bytes apart
+		void Build(const float* positions, size_t stride, const uint32_t* indices, size_t indexCount);
+		// Reads a hierarchy saved from the same triangles. False when the file is missing, damaged or was made from other triangles.
+		bool Load(const std::string& path, const float* positions, size_t stride, const uint32_t* indices, size_t indexCount);
+		bool Save(const std::string& path) const;
+
+		// Nearest triangle along the ray at a distance in [minDistance, maxDistance], either side of a triangle counts.
+		// A negative minDistance also finds triangles behind the origin. Sets distance and returns true on a hit.
+		bool Raycast(const float* origin, const float* direction, float minDistance, float maxDistance, float& distance) const;
+
+	private:
+		// Children of an inner node are the next node and first; a leaf holds count triangles from first
+		struct Node {
+			float min[3];
+			float max[3];
+			uint32_t first;
+			uint32_t count;
+		};
+
+		struct Header {
+			char magic[4];
+			uint32_t version;
+			uint32_t triangleCount;
+			uint32_t nodeCount;
+			uint64_t sourceHash; // of the corners the hierarchy was built from
+		};
+
+		static constexpr uint32_t maxLeafSize = 4;
+		static constexpr uint32_t binCount = 16;
+
+		static std::vector<float> GatherCorners(const float* positions, size_t stride, const uint32_t* indices, size_t indexCount);
+		static uint64_t Hash(const std::vector<float>& corners);
+		void BuildNode(std::vector<uint32_t>& order, const std::vector<float>& centroids, uint32_t first, uint32_t count);
+		bool IsValid() const;
+
+		std::vector<Node> nodes; // depth first, a parent comes before its children
+		std::vector<float> corners; // nine floats per triangle, grouped by leaf
+		uint64_t sourceHash = 0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,352 @@
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include "headers/AabbTree.hpp"
+
+using namespace enginetool;
+
+namespace {
+	// The arithmetic of ScenePart::RayIntersection, so the tree and a linear scan agree on every hit and distance
+	bool Intersect(const float* min, const float* max, const float* origin, const float* dirFrac, float& distance) {
+		const float t1 = (min[0] - origin[0]) * dirFrac[0];
+		const float t2 = (max[0] - origin[0]) * dirFrac[0];
+		const float t3 = (min[1] - origin[1]) * dirFrac[1];
+		const float t4 = (max[1] - origin[1]) * dirFrac[1];
+		const float t5 = (min[2] - origin[2]) * dirFrac[2];
+		const float t6 = (max[2] - origin[2]) * dirFrac[2];
+
+		const float tmin = std::max(std::max(std::min(t1, t2), std::min(t3, t4)), std::min(t5, t6));
+		const float tmax = std::min(std::min(std::max(t1, t2), std::max(t3, t4)), std::max(t5, t6));
+		if (tmax < 0 || tmin > tmax) {
+			return false;
+		}
+		distance = tmin;
+		return true;
+	}
+
+	float HalfArea(const float* min, const float* max) {
+		const float x = max[0] - min[0];
+		const float y = max[1] - min[1];
+		const float z = max[2] - min[2];
+		return x * y + y * z + z * x;
+	}
+
+	// A random ray through a node tests all its boxes, or both children if it has any
+	float NodeArea(const float* min, const float* max, uint32_t count) {
+		return HalfArea(min, max) * ((count > 0) ? count : 1);
+	}
+
+	void Grow(float* min, float* max, const float* otherMin, const float* otherMax) {
+		for (int axis = 0; axis < 3; axis++) {
+			min[axis] = std::min(min[axis], otherMin[axis]);
+			max[axis] = std::max(max[axis], otherMax[axis]);
+		}
+	}
+
+	void Empty(float* min, float* max) {
+		std::fill(min, min + 3, std::numeric_limits<float>::max());
+		std::fill(max, max + 3, std::numeric_limits<float>::lowest());
+	}
+}
+
+// ---------------- Building ------------------------ //
+
+void AabbTree::Clear() {
+	ids.clear();
+	boxes.clear();
+	order.clear();
+	nodes.clear();
+	parents.clear();
+	leaves.clear();
+	nodeArea = 0.0f;
+	builtCost = 0.0f;
+}
+
+void AabbTree::Insert(uint32_t id, const float* min, const float* max) {
+	ids.push_back(id);
+	Box box;
+	std::copy(min, min + 3, box.min);
+	std::copy(max, max + 3, box.max);
+	boxes.push_back(box);
+}
+
+void AabbTree::Build() {
+	nodes.clear();
+	order.resize(boxes.size());
+	std::iota(order.begin(), order.end(), 0);
+	parents.clear();
+	leaves.resize(boxes.size());
+	nodeArea = 0.0f;
+	if (boxes.empty()) {
+		builtCost = 0.0f;
+		return;
+	}
+
+	centroids.resize(boxes.size() * 3);
+	for (size_t i = 0; i < boxes.size(); i++) {
+		for (int axis = 0; axis < 3; axis++) {
+			centroids[i * 3 + axis] = (boxes[i].min[axis] + boxes[i].max[axis]) * 0.5f;
+		}
+	}
+	nodes.reserve(boxes.size() * 2);
+	BuildNode(0, static_cast<uint32_t>(boxes.size()));
+	centroids.clear();
+
+	parents.resize(nodes.size());
+	parents[0] = none;
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		const Node& node = nodes[i];
+		nodeArea += NodeArea(node.bounds.min, node.bounds.max, node.count);
+		if (node.count > 0) {
+			for (uint32_t j = node.first; j < node.first + node.count; j++) leaves[order[j]] = i;
+		}
+		else {
+			parents[i + 1] = i;
+			parents[node.right] = i;
+		}
+	}
+	builtCost = Cost();
+}
+
+void AabbTree::BuildNode(uint32_t first, uint32_t count) {
+	const uint32_t index = static_cast<uint32_t>(nodes.size());
+	nodes.emplace_back();
+
+	Box bounds;
+	float centroidMin[3], centroidMax[3];
+	Empty(bounds.min, bounds.max);
+	Empty(centroidMin, centroidMax);
+	for (uint32_t i = first; i < first + count; i++) {
+		Grow(bounds.min, bounds.max, boxes[order[i]].min, boxes[order[i]].max);
+		const float* centroid = &centroids[order[i] * 3];
+		Grow(centroidMin, centroidMax, centroid, centroid);
+	}
+	nodes[index].bounds = bounds;
+	nodes[index].first = first;
+	nodes[index].count = count;
+	nodes[index].right = 0;
+	if (count == 1) {
+		return;
+	}
+
+	int axis = 0;
+	for (int i = 1; i < 3; i++) {
+		if (centroidMax[i] - centroidMin[i] > centroidMax[axis] - centroidMin[axis]) axis = i;
+	}
+	const float extent = centroidMax[axis] - centroidMin[axis];
+
+	uint32_t middle = first + count / 2; // boxes on one spot cannot be told apart, so they are halved
+	if (extent > 0.0f) {
+		// Surface area heuristic over binned centroids: the split with the least area times boxes on each side
+		Box binBounds[binCount];
+		uint32_t binCounts[binCount] = {};
+		for (uint32_t bin = 0; bin < binCount; bin++) Empty(binBounds[bin].min, binBounds[bin].max);
+		const float scale = binCount / extent;
+		auto binOf = [&](uint32_t box) {
+			return std::min(binCount - 1, static_cast<uint32_t>((centroids[box * 3 + axis] - centroidMin[axis]) * scale));
+		};
+		for (uint32_t i = first; i < first + count; i++) {
+			const uint32_t bin = binOf(order[i]);
+			binCounts[bin]++;
+			Grow(binBounds[bin].min, binBounds[bin].max, boxes[order[i]].min, boxes[order[i]].max);
+		}
+
+		float rightAreas[binCount];
+		Box side;
+		Empty(side.min, side.max);
+		uint32_t sideCount = 0;
+		for (uint32_t bin = binCount - 1; bin > 0; bin--) {
+			Grow(side.min, side.max, binBounds[bin].min, binBounds[bin].max);
+			sideCount += binCounts[bin];
+			rightAreas[bin] = (sideCount > 0) ? HalfArea(side.min, side.max) * sideCount : 0.0f;
+		}
+		Empty(side.min, side.max);
+		sideCount = 0;
+		float bestCost = std::numeric_limits<float>::max();
+		uint32_t bestSplit = 1;
+		for (uint32_t split = 1; split < binCount; split++) {
+			Grow(side.min, side.max, binBounds[split - 1].min, binBounds[split - 1].max);
+			sideCount += binCounts[split - 1];
+			const float cost = ((sideCount > 0) ? HalfArea(side.min, side.max) * sideCount : 0.0f) + rightAreas[split];
+			if (sideCount > 0 && sideCount < count && cost < bestCost) {
+				bestCost = cost;
+				bestSplit = split;
+			}
+		}
+
+		// A visit costs about as much as one box test, so a small node stays a leaf unless splitting saves more than that
+		const float area = HalfArea(bounds.min, bounds.max);
+		const float splitCost = (area > 0.0f) ? 1.0f + bestCost / area : 1.0f;
+		if (count <= maxLeafSize && static_cast<float>(count) <= splitCost) {
+			return;
+		}
+		middle = static_cast<uint32_t>(std::partition(order.begin() + first, order.begin() + first + count, [&](uint32_t box) { return binOf(box) < bestSplit; }) - order.begin());
+	}
+	else if (count <= maxLeafSize) {
+		return;
+	}
+
+	nodes[index].count = 0;
+	BuildNode(first, middle - first);
+	nodes[index].right = static_cast<uint32_t>(nodes.size());
+	BuildNode(middle, first + count - middle);
+}
+
+void AabbTree::UpdateBox(uint32_t index, const float* min, const float* max) {
+	std::copy(min, min + 3, boxes[index].min);
+	std::copy(max, max + 3, boxes[index].max);
+}
+
+void AabbTree::Refit() {
+	// Children come after their parent, so walking backwards finishes every child before its parent
+	for (size_t i = nodes.size(); i-- > 0;) {
+		RefitNode(static_cast<uint32_t>(i));
+	}
+}
+
+// A node whose bounds did not change leaves the bounds of all its ancestors as they were, as far as this box is concerned
+void AabbTree::Refit(const std::vector<uint32_t>& indices) {
+	if (nodes.empty()) {
+		return;
+	}
+	for (uint32_t index : indices) {
+		uint32_t node = leaves[index];
+		while (node != none && RefitNode(node)) node = parents[node];
+	}
+}
+
+bool AabbTree::RefitNode(uint32_t index) {
+	Node& node = nodes[index];
+	Box bounds;
+	Empty(bounds.min, bounds.max);
+	if (node.count > 0) {
+		for (uint32_t j = node.first; j < node.first + node.count; j++) {
+			Grow(bounds.min, bounds.max, boxes[order[j]].min, boxes[order[j]].max);
+		}
+	}
+	else {
+		Grow(bounds.min, bounds.max, nodes[index + 1].bounds.min, nodes[index + 1].bounds.max);
+		Grow(bounds.min, bounds.max, nodes[node.right].bounds.min, nodes[node.right].bounds.max);
+	}
+	if (std::equal(bounds.min, bounds.min + 3, node.bounds.min) && std::equal(bounds.max, bounds.max + 3, node.bounds.max)) {
+		return false;
+	}
+	nodeArea += NodeArea(bounds.min, bounds.max, node.count) - NodeArea(node.bounds.min, node.bounds.max, node.count);
+	node.bounds = bounds;
+	return true;
+}
+
+bool AabbTree::NeedsRebuild() const {
+	return !nodes.empty() && Cost() > builtCost * 2.0f;
+}
+
+// Expected box and node tests of a random ray through the root, relative to one
+float AabbTree::Cost() const {
+	const float rootArea = HalfArea(nodes[0].bounds.min, nodes[0].bounds.max);
+	if (rootArea <= 0.0f) {
+		return static_cast<float>(nodes.size());
+	}
+	return nodeArea / rootArea;
+}
+
+// ---------------- Queries ------------------------- //
+
+template<typename Visit>
+void AabbTree::Traverse(const float* origin, const float* direction, float maxDistance, Visit visit) const {
+	if (nodes.empty()) {
+		return;
+	}
+
+	const float dirFrac[3] = { 1.0f / direction[0], 1.0f / direction[1], 1.0f / direction[2] };
+	float distance;
+	if (!Intersect(nodes[0].bounds.min, nodes[0].bounds.max, origin, dirFrac, distance) || distance > maxDistance) {
+		return;
+	}
+
+	struct Entry {
+		uint32_t node;
+		float distance;
+	};
+	thread_local std::vector<Entry> stack; // queries run on several threads
+	stack.clear();
+	stack.push_back({ 0, distance });
+	while (!stack.empty()) {
+		const Entry entry = stack.back();
+		stack.pop_back();
+		if (entry.distance > maxDistance) {
+			continue; // something nearer was found after this node was pushed
+		}
+
+		const Node& node = nodes[entry.node];
+		if (node.count > 0) {
+			for (uint32_t i = node.first; i < node.first + node.count; i++) {
+				const uint32_t box = order[i];
+				if (Intersect(boxes[box].min, boxes[box].max, origin, dirFrac, distance) && distance <= maxDistance && !visit(box, distance, maxDistance)) {
+					return;
+				}
+			}
+			continue;
+		}
+
+		// The nearer child goes on top, so it is searched first and can rule out the other
+		Entry children[2] = { { entry.node + 1, 0.0f }, { node.right, 0.0f } };
+		bool hit[2];
+		for (int i = 0; i < 2; i++) {
+			const Node& child = nodes[children[i].node];
+			hit[i] = Intersect(child.bounds.min, child.bounds.max, origin, dirFrac, children[i].distance) && children[i].distance <= maxDistance;
+		}
+		if (hit[0] && hit[1] && children[0].distance < children[1].distance) {
+			std::swap(children[0], children[1]);
+		}
+		for (int i = 0; i < 2; i++) {
+			if (hit[i]) stack.push_back(children[i]);
+		}
+	}
+}
+
+AabbTree::RayHit AabbTree::Raycast(const float* origin, const float* direction, float maxDistance, uint32_t ignore) const {
+	RayHit nearest;
+	Traverse(origin, direction, maxDistance, [&](uint32_t box, float distance, float& limit) {
+		if (ids[box] != ignore && (nearest.id == none || distance < nearest.distance)) {
+			nearest.id = ids[box];
+			nearest.distance = distance;
+			limit = distance;
+		}
+		return true;
+	});
+	return nearest;
+}
+
+bool AabbTree::RaycastAny(const float* origin, const float* direction, float maxDistance, uint32_t ignore) const {
+	bool found = false;
+	Traverse(origin, direction, maxDistance, [&](uint32_t box, float, float&) {
+		found = ids[box] != ignore;
+		return !found;
+	});
+	return found;
+}
+
+AabbTree::RayHit AabbTree::ProbeDown(const float* origin, float floor, uint32_t ignore) const {
+	const float down[3] = { 0.0f, -1.0f, 0.0f };
+	return Raycast(origin, down, origin[1] - floor, ignore);
+}
+
+AabbTree::RayHit AabbTree::Raycast(const float* origin, const float* direction, float maxDistance, uint32_t ignore, ExactTest exact) const {
+	RayHit nearest;
+	Traverse(origin, direction, maxDistance, [&](uint32_t box, float distance, float& limit) {
+		float exactDistance;
+		if (ids[box] != ignore && exact(ids[box], distance, limit, exactDistance) && (nearest.id == none || exactDistance < nearest.distance)) {
+			nearest.id = ids[box];
+			nearest.distance = exactDistance;
+			limit = exactDistance;
+		}
+		return true;
+	});
+	return nearest;
+}
+
+AabbTree::RayHit AabbTree::ProbeDown(const float* origin, float floor, uint32_t ignore, ExactTest exact) const {
+	const float down[3] = { 0.0f, -1.0f, 0.0f };
+	return Raycast(origin, down, origin[1] - floor, ignore, exact);
+}
\ No newline at end of file
@@ -1,38 +1,43 @@
+#include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <iostream>
 #include <cmath>
 
-#define BOOST_PENDING_INTEGER_LOG2_HPP
-//#include <boost/integer/integer_log2.hpp>
-#include <boost/uuid/uuid.hpp>
-#include <boost/uuid/uuid_generators.hpp>
-#include <boost/uuid/uuid_io.hpp>
-#include <boost/lexical_cast.hpp>
-
 #include "headers/Actor.hpp"
 
-Actor::Actor(std::string name, std::string description, glm::vec3 position, ActorType type, std::vector<std::shared_ptr<Actor>>& actors) : state(ActorState::Idle) {
+Actor::Actor(enginetool::NameId name, enginetool::NameId description, glm::vec3 position, ActorType type, std::vector<std::shared_ptr<Actor>>& actors, enginetool::MotionStore& motionStore) 
+: state(ActorState::Idle), motion(&motionStore) {
 	this->name = name;
 	this->description = description;
-	this->position = position;
+	id = CreateId();
+	motion->Add(position, motionSlot);
 	this->type = type;
 	interactActors = &actors;
 	initPosition = position;
 	groundLevel = position.y;
-	id = CreateId();
 	// create save file
+#if DEBUG_VERSION
 	std::cout << "Actor created\n";
+#endif
 }
 
 Actor::~Actor() {
+	motion->Remove(motionSlot);
+#if DEBUG_VERSION
 	std::cout << "Actor destroyed\n";
+#endif
 }
 
 // --------------- Setters and getters -------------- //
-std::string Actor::GetId() const {
+uint64_t Actor::GetId() const {
 	return id;
 }
 
+enginetool::NameId Actor::GetDescription() const {
+	return description;
+}
+
 ActorType Actor::GetType() {
     return type;
 }
@@ -46,25 +51,28 @@ float Actor::Approach(float actorGoal, float actorCurrent, float dt) {
 	return actorGoal;
 }
 
-std::string Actor::CreateId() {
-	boost::uuids::uuid uuid = boost::uuids::random_generator()();
-	std::string id = boost::uuids::to_string(uuid);
-	return id;
+// Unique for the run of the program, ids are never reused
+uint64_t Actor::CreateId() {
+	static std::atomic<uint64_t> nextId(1);
+	return nextId.fetch_add(1, std::memory_order_relaxed);
 }
 
 void Actor::ChangePosition() {
-	glm::vec3 direction = destinationPoint - position;
+	Wake();
+	glm::vec3 direction = destinationPoint - Position();
 	direction = glm::normalize(direction);
+	glm::vec3& movementGoal = MovementGoal();
+	const glm::vec3& velocity = Velocity();
 	movementGoal.x = direction.x * velocity.x;
 	movementGoal.y = direction.y * velocity.y;
 	movementGoal.z = direction.z * velocity.z;
 }
 
 void Actor::CheckIfInTheDestination() {
-	float distance = glm::distance(position, destinationPoint);
+	float distance = glm::distance(Position(), destinationPoint);
 	
 	if(distance<0.1) 
-		movementGoal=glm::vec3(0.0f, 0.0f, 0.0f);
+		MovementGoal()=glm::vec3(0.0f, 0.0f, 0.0f);
 	else 
 		ChangePosition();
 }
@@ -78,39 +86,112 @@ float Actor::DetectGroundLevel() {
 	glm::vec3 hitPoint;
 	float groundLevel = -20.0f;
 
-	std::vector<std::shared_ptr<Actor>>::iterator it;
+	// The nearest box straight down is the one with the highest top, which is what the scan below keeps
+	if (rayTree != nullptr) {
+		// Static ground is one cell read; where the heightfield answers, only the actors it leaves out need a ray cast
+		float staticGround;
+		const bool baked = heightfield != nullptr && groundTree != nullptr && heightfield->GroundLevel(Position().x, Position().y, Position().z, staticGround);
+		if (baked && staticGround > groundLevel) groundLevel = staticGround;
+		const enginetool::AabbTree* tree = baked ? groundTree : rayTree;
+		const glm::vec3 origin = Position();
+		const enginetool::AabbTree::RayHit ground = tree->ProbeDown(&origin.x, groundLevel, rayTreeId, [&](uint32_t id, float enter, float limit, float& distance) {
+			return id < interactActors->size() && (*interactActors)[id]->RayHitsMesh(origin, rayDirection, enter, limit, distance);
+		});
+		if (ground.id != enginetool::AabbTree::none) {
+			hitPoint = Position() + rayDirection * ground.distance;
+			if(hitPoint.y > groundLevel) groundLevel = hitPoint.y;
+		}
+		return groundLevel;
+	}
 
-	for (it = interactActors->begin(); it!=interactActors->end() ;++it) {
-		if(enginetool::ScenePart::RayIntersection(hitPoint, dirFrac, position, rayDirection, it->get()->currentAabb) && it->get()!=this) {
+	// Hits below the starting ground level change nothing, so only the column between it and the actor is searched
+	const glm::vec3 columnMin(Position().x, groundLevel, Position().z);
+	const glm::vec3 columnMax(Position().x, std::max(groundLevel, Position().y), Position().z);
+	ForEachCandidate(columnMin, columnMax, [&](Actor* other) {
+		if(enginetool::ScenePart::RayIntersection(hitPoint, dirFrac, Position(), rayDirection, other->CurrentAabb())) {
 			//std::cout << "Hit point: " << hitPoint.x << " " << hitPoint.y << " " << hitPoint.z << "\n";
 			if(hitPoint.y > groundLevel) groundLevel = hitPoint.y;
 		}
-	}
+	});
 	//std::cout << "Ground is at: " << groundLevel << std::endl;
 	return groundLevel;
 }
 
+bool Actor::RayHitsMesh(const glm::vec3& origin, const glm::vec3& direction, float enter, float limit, float& distance) const {
+	if (assignedMesh == nullptr || assignedMesh->bvh.IsEmpty()) {
+		distance = enter;
+		return true;
+	}
+
+	// The box is the mesh's box moved, so the ray is moved the other way into mesh space. The box and the triangles are
+	// rounded apart, a triangle on a face of the box may come out a little before enter.
+	const glm::vec3 localOrigin = origin - (CurrentAabb().min - assignedMesh->aabb.min);
+	const float slack = 1e-4f * (std::abs(enter) + 1.0f);
+	if (!assignedMesh->bvh.Raycast(&localOrigin.x, &direction.x, enter - slack, limit, distance)) {
+		return false;
+	}
+	distance = std::max(distance, enter);
+	return true;
+}
+
 void Actor::CheckCollisions() {
-	std::vector<std::shared_ptr<Actor>>::iterator it;
-	for (it = interactActors->begin(); it!=interactActors->end() ;++it) {
-		if(enginetool::ScenePart::Overlaps(this->currentAabb, it->get()->currentAabb) && it->get()!=this) {
-			//std::cout << this->name << " collides with: " << it->get()->name << "\n";
+	ForEachCandidate(CurrentAabb().min, CurrentAabb().max, [this](Actor* other) {
+		if(enginetool::ScenePart::Overlaps(CurrentAabb(), other->CurrentAabb())) {
+			//std::cout << this->name << " collides with: " << other->name << "\n";
 			SetState(ActorState::Reflection);		
 		}
+	});
+}
+
+void Actor::StoreTickState() {
+	PreviousPosition() = Position();
+}
+
+// Alpha is the part of a fixed step left in the accumulator, 0 shows the previous tick and 1 the latest one.
+void Actor::Interpolate(float alpha) {
+	RenderPosition() = glm::mix(PreviousPosition(), Position(), alpha);
+}
+
+template<typename F>
+void Actor::ForEachCandidate(const glm::vec3& min, const glm::vec3& max, F body) {
+	if (broadphase == nullptr) {
+		for (const auto& other : *interactActors) {
+			if (other.get() != this) body(other.get());
+		}
+		return;
+	}
+
+	// Sensing runs on several threads, each with a list of its own
+	thread_local std::vector<uint32_t> candidates;
+	candidates.clear();
+	broadphase->Query(&min.x, &max.x, candidates);
+	const size_t moving = candidates.size();
+	if (restingBroadphase != nullptr) {
+		restingBroadphase->Query(&min.x, &max.x, candidates);
+	}
+	for (size_t c = 0; c < candidates.size(); c++) {
+		const uint32_t i = candidates[c];
+		Actor* other = (i < interactActors->size()) ? (*interactActors)[i].get() : nullptr;
+		// A resting box whose actor has woken since is stale, the actor is in broadphase now
+		if (other != nullptr && other != this && (c < moving || other->inRestingBroadphase)) body(other);
 	}
 }
 
-void Actor::SaveToFile() {
+// Runs for every actor before any of them moves, so what an actor sees does not depend on update order.
+void Actor::SenseSurroundings() {
 
 }
 
 void Actor::SetPosition(glm::vec3 position) {
-	this->position = position;
+	Wake();
+	Position() = position;
+	PreviousPosition() = position;
 }
 
 void Actor::SetState(ActorState state) {
 	if (this->state==state || inAir) return;
 
+	Wake();
 	this->state=state;
 
 	switch(this->state){
@@ -144,40 +225,77 @@ void Actor::SetState(ActorState state) {
 	} 
 }
 
+void Actor::BeginMove() {
+	if(MovementGoal()!=glm::vec3(0.0f,0.0f,0.0f) && !manualControl) CheckIfInTheDestination();
+}
+
+void Actor::EndMove() {
+	UpdateAABB();
+}
+
 void Actor::UpdateAABB(){
-	currentAabb.max = assignedMesh->aabb.max + position;
-	currentAabb.min = assignedMesh->aabb.min + position;
+	enginetool::ScenePart::AABB& currentAabb = CurrentAabb();
+	currentAabb.max = assignedMesh->aabb.max + Position();
+	currentAabb.min = assignedMesh->aabb.min + Position();
 }
 
 void Actor::offManualControl() {
 	manualControl = false;
-	destinationPoint = position;
+	destinationPoint = Position();
 }
 
 void Actor::onManualControl() {
+	Wake();
 	manualControl = true;
-	destinationPoint = position;
+	destinationPoint = Position();
 }
 
 void Actor::ResetPosition() {
-	position = initPosition;
-	movement = glm::vec3(0.0f, 0.0f, 0.0f);
-	movementGoal = glm::vec3(0.0f, 0.0f, 0.0f);
-	destinationPoint = position;
+	Wake();
+	Position() = initPosition;
+	PreviousPosition() = initPosition;
+	Movement() = glm::vec3(0.0f, 0.0f, 0.0f);
+	MovementGoal() = glm::vec3(0.0f, 0.0f, 0.0f);
+	destinationPoint = initPosition;
+}
+
+// ---------------- Sleeping ------------------------ //
+
+void Actor::EnableSleeping(std::vector<Actor*>& wakeQueue) {
+	this->wakeQueue = &wakeQueue;
+}
+
+// Converged means the last tick did not move the actor and nothing asks it to, so position and AABB stay valid while it sleeps.
+bool Actor::TrySleep() {
+	const glm::vec3 zero = glm::vec3(0.0f, 0.0f, 0.0f);
+	if (wakeQueue == nullptr || manualControl || inAir || Movement() != zero || MovementGoal() != zero) {
+		return false;
+	}
+	motion->Sleep(motionSlot);
+	return true;
+}
+
+void Actor::Wake() {
+	if (motion->Wake(motionSlot)) {
+		wakeQueue->push_back(this);
+	}
 }
 
 // ------------- Manual control functions --------------- //
 
 void Actor::Dolly(float actorVelocityGoal) {
-	movementGoal.x = actorVelocityGoal;
+	Wake();
+	MovementGoal().x = actorVelocityGoal;
 }
 
 void Actor::Pedestal(float actorVelocityGoal) {
-	movementGoal.y = actorVelocityGoal;
+	Wake();
+	MovementGoal().y = actorVelocityGoal;
 }
 
 void Actor::Strafe(float actorVelocityGoal) {
-	movementGoal.z = actorVelocityGoal;
+	Wake();
+	MovementGoal().z = actorVelocityGoal;
 }
 
 void Actor::Truck(float actorVelocityGoal) {
@@ -197,31 +315,31 @@ void Actor::StartFall() {
 void Actor::StartReflect() {
 	//R = V - 2 N (N.V) / (N.N)
 	
-	movementGoal.x *=(-1);
-	movementGoal.z *=(-1);
+	MovementGoal().x *=(-1);
+	MovementGoal().z *=(-1);
 }
 
 void Actor::StartWalkBackward() {
-	movementGoal.x = -walkVelocity;
+	MovementGoal().x = -walkVelocity;
 }
 
 void Actor::StartWalkForward() {
-	movementGoal.x = walkVelocity;
+	MovementGoal().x = walkVelocity;
 }
 
 void Actor::StartWalkLeft() {
-	movementGoal.z = -walkVelocity;
+	MovementGoal().z = -walkVelocity;
 }
 
 void Actor::StartWalkRight() {
-	movementGoal.z = walkVelocity;
+	MovementGoal().z = walkVelocity;
 }
 
 
 void Actor::StartIdle() {
-	movementGoal = glm::vec3(0.0f, 0.0f, 0.0f);
+	MovementGoal() = glm::vec3(0.0f, 0.0f, 0.0f);
 }
 
 void Actor::StartJump() {
-	movementGoal.y = 1300.0f;
+	MovementGoal().y = 1300.0f;
 }
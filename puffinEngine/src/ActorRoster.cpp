@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "headers/ActorRoster.hpp"
+
+using namespace enginetool;
+
+// ---------------- Main functions ------------------ //
+
+void ActorWorld::Attach(Actor& actor) const {
+	actor.broadphase = broadphase;
+	actor.restingBroadphase = restingBroadphase;
+	actor.rayTree = rayTree;
+	actor.groundTree = groundTree;
+	actor.heightfield = heightfield;
+}
+
+void ActorRoster::Spawn(ActorType type, const std::string& name, const std::vector<glm::vec3>& positions, ScenePart& mesh, SceneMaterial& material, std::vector<Handle<Actor>>& spawned) {
+	const size_t count = positions.size();
+	const NameId nameId = actorNames.Intern(name);
+	MotionStoreFor(type).Reserve(count);
+	ReserveMore(actors, count);
+	ReserveMore(spawned, count);
+
+	switch (type) {
+	case ActorType::Landscape:
+		landscapePool.Reserve(count);
+		ReserveMore(landscapeBucket, count);
+		for (const auto& position : positions) {
+			Handle<Landscape> handle;
+			SpawnActor(landscapePool, type, nameId, 0, position, mesh, material, handle)->Init(1000, 1000);
+			spawned.push_back(handle);
+		}
+		break;
+	case ActorType::SphereLight:
+		sphereLightPool.Reserve(count);
+		ReserveMore(sphereLightBucket, count);
+		for (const auto& position : positions) {
+			Handle<SphereLight> handle;
+			SpawnActor(sphereLightPool, type, nameId, 0, position, mesh, material, handle);
+			spawned.push_back(handle);
+		}
+		break;
+	case ActorType::Character:
+		characterPool.Reserve(count);
+		ReserveMore(characterBucket, count);
+		for (const auto& position : positions) {
+			Handle<Character> handle;
+			SpawnActor(characterPool, type, nameId, 0, position, mesh, material, handle)->Init(1000, 1000, 100);
+			spawned.push_back(handle);
+		}
+		break;
+	default:
+		throw std::runtime_error("actor type cannot be spawned!");
+	}
+}
+
+size_t ActorRoster::Despawn(const std::vector<Handle<Actor>>& handles, std::initializer_list<std::vector<Actor*>*> views, std::initializer_list<std::vector<std::shared_ptr<Actor>>*> owners) {
+	size_t removed = 0;
+	for (const auto& handle : handles) {
+		if (actorHandles.Remove(handle)) {
+			removed++;
+		}
+	}
+	if (removed == 0) {
+		return 0;
+	}
+
+	// Removed actors are the ones whose own handle went stale. The views only point at actors, so they are compacted
+	// before the owning lists drop the last shared_ptr; that hands pooled actors back to their pool.
+	auto despawned = [this](const Actor* actor) { return actorHandles.Get(actor->handle) == nullptr; };
+	landscapeBucket.erase(std::remove_if(landscapeBucket.begin(), landscapeBucket.end(), despawned), landscapeBucket.end());
+	sphereLightBucket.erase(std::remove_if(sphereLightBucket.begin(), sphereLightBucket.end(), despawned), sphereLightBucket.end());
+	characterBucket.erase(std::remove_if(characterBucket.begin(), characterBucket.end(), despawned), characterBucket.end());
+	for (auto* view : { &otherActors, &wokenActors, &settledActors }) {
+		view->erase(std::remove_if(view->begin(), view->end(), despawned), view->end());
+	}
+	for (auto* view : views) {
+		view->erase(std::remove_if(view->begin(), view->end(), despawned), view->end());
+	}
+
+	actorsChanged = true;
+	restingChanged = true;
+	auto despawnedOwner = [&despawned](const std::shared_ptr<Actor>& a) { return despawned(a.get()); };
+	actors.erase(std::remove_if(actors.begin(), actors.end(), despawnedOwner), actors.end());
+	for (auto* owner : owners) {
+		owner->erase(std::remove_if(owner->begin(), owner->end(), despawnedOwner), owner->end());
+	}
+	return removed;
+}
+
+void ActorRoster::AddActor(std::shared_ptr<Actor> actor) {
+	world.Attach(*actor);
+	actorsChanged = true;
+	restingChanged = true;
+	// Only bucketed actors find their way back into an update loop when woken, so only they may sleep
+	if (AddToBucket(actor.get())) {
+		actor->EnableSleeping(wokenActors);
+	}
+	actors.emplace_back(std::move(actor));
+}
+
+bool ActorRoster::AddToBucket(Actor* actor) {
+	switch (actor->GetType()) {
+	case ActorType::Landscape:
+		landscapeBucket.push_back(static_cast<Landscape*>(actor));
+		return true;
+	case ActorType::SphereLight:
+		sphereLightBucket.push_back(static_cast<SphereLight*>(actor));
+		return true;
+	case ActorType::Character:
+		characterBucket.push_back(static_cast<Character*>(actor));
+		return true;
+	default:
+		otherActors.push_back(actor);
+		return false;
+	}
+}
+
+MotionStore& ActorRoster::MotionStoreFor(ActorType type) {
+	switch (type) {
+	case ActorType::Landscape:
+		return landscapeMotion;
+	case ActorType::SphereLight:
+		return sphereLightMotion;
+	case ActorType::Character:
+		return characterMotion;
+	default:
+		return motionStore;
+	}
+}
\ No newline at end of file
@@ -6,8 +6,8 @@
 
 // ------- Constructors and dectructors ------------- //
 
-Camera::Camera(std::string name, std::string description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors) 
-: Actor(name, description, position, type, actors) {
+Camera::Camera(enginetool::NameId name, enginetool::NameId description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors, enginetool::MotionStore& motionStore) 
+: Actor(name, description, position, type, actors, motionStore) {
 #if DEBUG_VERSION
 	std::cout << "Camera created\n";
 #endif 
@@ -27,11 +27,13 @@ void Camera::Init(float move_x, float move_y, float move_z,
 	float up_x, float up_y, float up_z, 
 	float fov, float cnear, float cfar, float horiz, float vert)
 {
-	movement = glm::vec3(move_x, move_y, move_z); 
-	movementGoal = glm::vec3(move_goal_x, move_goal_y, move_goal_z);
+	Movement() = glm::vec3(move_x, move_y, move_z); 
+	MovementGoal() = glm::vec3(move_goal_x, move_goal_y, move_goal_z);
 	direction = glm::vec3(dir_x, dir_y, dir_z);
 	up = glm::vec3(up_x, up_y, up_z);
-	view = position + direction;
+	view = Position() + direction;
+	previousView = view;
+	renderView = view;
 	
 	FOV = fov;
 	clippingNear = cnear;
@@ -47,6 +49,11 @@ glm::vec3 Camera::CalculateSelectionIndicatorColor() {
 
 
 void Camera::UpdatePosition(float dt) {
+	glm::vec3& position = Position();
+	glm::vec3& movement = Movement();
+	const glm::vec3& movementGoal = MovementGoal();
+	glm::vec3& velocity = Velocity();
+
 	// Smooth movement and edge case in approach, without is movement is const
 	movement.x = Approach(movementGoal.x, movement.x, dt * 500);
 	movement.y = Approach(movementGoal.y, movement.y, dt * 500);
@@ -64,9 +71,20 @@ void Camera::UpdatePosition(float dt) {
 	view = position + direction; 
 }
 
+void Camera::StoreTickState() {
+	Actor::StoreTickState();
+	previousView = view;
+}
+
+void Camera::Interpolate(float alpha) {
+	Actor::Interpolate(alpha);
+	renderView = glm::mix(previousView, view, alpha);
+}
+
 void Camera::ResetPosition(){
 	Actor::ResetPosition();
 	view = glm::vec3(0.0f, 0.0f, 0.0f); 
+	previousView = view;
 	up = glm::vec3(0.0f, 1.0f, 0.0f); 
 	FOV = 60.0f;
 	clippingNear = 0.001f;
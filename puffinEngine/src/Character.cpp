@@ -5,14 +5,18 @@
 
 // ------- Constructors and dectructors ------------- //
 
-Character::Character(std::string name, std::string description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors) 
-: Actor(name, description, position, type, actors) {
+Character::Character(enginetool::NameId name, enginetool::NameId description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors, enginetool::MotionStore& motionStore) 
+: Actor(name, description, position, type, actors, motionStore) {
 	// create save file
+#if DEBUG_VERSION
 	std::cout << "Character created\n";
+#endif
 }
 
 Character::~Character() {
+#if DEBUG_VERSION
 	std::cout << "Character destroyed\n";
+#endif
 }
 
 void Character::Init(unsigned int maxHealth, int currentHealth, unsigned int gold) {
@@ -26,18 +30,32 @@ glm::vec3 Character::CalculateSelectionIndicatorColor(){
 	return glm::vec3(2.0f * (1.0f - perentOfMax), 2.0f * perentOfMax, 0.0f);
 }
 
+// Collisions are found by the scene for all actors at once, see Scene::ResolveContacts
+void Character::SenseSurroundings() {
+	groundLevel = DetectGroundLevel();
+}
+
+void Character::BeginMove() {
+	//if(MovementGoal()!=glm::vec3(0.0f,0.0f,0.0f) && !manualControl) Actor::CheckIfInTheDestination();
+}
+
 void Character::UpdatePosition(float dt) {
-	//if(movementGoal!=glm::vec3(0.0f,0.0f,0.0f) && !manualControl) Actor::CheckIfInTheDestination();
+	glm::vec3& movement = Movement();
+	const glm::vec3& movementGoal = MovementGoal();
+	BeginMove();
 
-	groundLevel = DetectGroundLevel();
-	CheckCollisions();
-	
-	movement.x = Approach(movementGoal.x, movement.x, dt * 1000);
-	movement.y = Approach(movementGoal.y, movement.y, dt * 1000);
- 	movement.z = Approach(movementGoal.z, movement.z, dt * 1000);
+	movement.x = Approach(movementGoal.x, movement.x, dt * approachRate);
+	movement.y = Approach(movementGoal.y, movement.y, dt * approachRate);
+ 	movement.z = Approach(movementGoal.z, movement.z, dt * approachRate);
+
+	Position() += movement * dt;
+
+	EndMove();
+}
 
-	velocity = movement;
-	position += velocity * dt;
+void Character::EndMove() {
+	glm::vec3& position = Position();
+	Velocity() = Movement();
 
 	if (position.y <= groundLevel) {
 		position.y = groundLevel;
@@ -48,7 +66,7 @@ void Character::UpdatePosition(float dt) {
 	}
 	else SetState(ActorState::Fall);
 		
-	if (inAir) movementGoal.y -= 100.0f;
+	if (inAir) MovementGoal().y -= 100.0f;
 
 	UpdateAABB();
 }
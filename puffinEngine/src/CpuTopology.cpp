@@ -0,0 +1,240 @@
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "headers/CpuTopology.hpp"
+
+using namespace enginetool;
+
+namespace {
+	bool ReadValue(const std::string& path, std::string& value) {
+		std::ifstream file(path);
+		if (!file.is_open()) {
+			return false;
+		}
+		std::getline(file, value);
+		return true;
+	}
+
+	bool ReadNumber(const std::string& path, uint32_t& number) {
+		std::string value;
+		if (!ReadValue(path, value) || value.empty()) {
+			return false;
+		}
+		number = static_cast<uint32_t>(std::stoul(value));
+		return true;
+	}
+
+	bool IsAllowed(uint32_t cpu) {
+#ifdef __linux__
+		static const cpu_set_t allowed = []() {
+			cpu_set_t set;
+			CPU_ZERO(&set);
+			if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+				for (int i = 0; i < CPU_SETSIZE; i++) CPU_SET(i, &set);
+			}
+			return set;
+		}();
+		return cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed);
+#else
+		(void)cpu;
+		return true;
+#endif
+	}
+}
+
+// ---------------- Main functions ------------------ //
+
+CpuTopology CpuTopology::Detect(const std::string& sysfsPath) {
+	CpuTopology topology;
+
+	std::string online;
+	if (ReadValue(sysfsPath + "/online", online)) {
+		for (const auto id : ParseCpuList(online)) {
+			if (!IsAllowed(id)) {
+				continue;
+			}
+
+			const std::string cpuPath = sysfsPath + "/cpu" + std::to_string(id);
+			LogicalCpu cpu;
+			cpu.id = id;
+
+			uint32_t coreId = id;
+			uint32_t packageId = 0;
+			ReadNumber(cpuPath + "/topology/core_id", coreId);
+			ReadNumber(cpuPath + "/topology/physical_package_id", packageId);
+			cpu.core = (packageId << 16) | coreId;
+
+			cpu.l3Domain = packageId;
+			for (uint32_t index = 0; ; index++) {
+				const std::string cachePath = cpuPath + "/cache/index" + std::to_string(index);
+				uint32_t level = 0;
+				if (!ReadNumber(cachePath + "/level", level)) {
+					break;
+				}
+				std::string shared;
+				if (level == 3 && ReadValue(cachePath + "/shared_cpu_list", shared)) {
+					const std::vector<uint32_t> sharing = ParseCpuList(shared);
+					if (!sharing.empty()) {
+						cpu.l3Domain = sharing.front();
+					}
+				}
+			}
+
+			topology.AddCpu(cpu);
+		}
+	}
+
+	// No sysfs: treat every hardware thread as its own core.
+	if (topology.cpus.empty()) {
+		const uint32_t count = std::max(1u, std::thread::hardware_concurrency());
+		for (uint32_t id = 0; id < count; id++) {
+			LogicalCpu cpu;
+			cpu.id = id;
+			cpu.core = id;
+			topology.AddCpu(cpu);
+		}
+	}
+
+	return topology;
+}
+
+std::vector<uint32_t> CpuTopology::ParseCpuList(const std::string& list) {
+	std::vector<uint32_t> result;
+	std::stringstream stream(list);
+	std::string range;
+	while (std::getline(stream, range, ',')) {
+		if (range.empty()) {
+			continue;
+		}
+		const size_t dash = range.find('-');
+		const uint32_t first = static_cast<uint32_t>(std::stoul(range.substr(0, dash)));
+		const uint32_t last = (dash == std::string::npos) ? first : static_cast<uint32_t>(std::stoul(range.substr(dash + 1)));
+		for (uint32_t id = first; id <= last; id++) {
+			result.push_back(id);
+		}
+	}
+	return result;
+}
+
+void CpuTopology::AddCpu(const LogicalCpu& cpu) {
+	cpus.push_back(cpu);
+}
+
+const LogicalCpu* CpuTopology::FindCpu(uint32_t id) const {
+	for (const auto& cpu : cpus) {
+		if (cpu.id == id) {
+			return &cpu;
+		}
+	}
+	return nullptr;
+}
+
+uint32_t CpuTopology::GetPhysicalCoreCount() const {
+	std::set<uint32_t> cores;
+	for (const auto& cpu : cpus) cores.insert(cpu.core);
+	return static_cast<uint32_t>(cores.size());
+}
+
+uint32_t CpuTopology::GetL3DomainCount() const {
+	std::set<uint32_t> domains;
+	for (const auto& cpu : cpus) domains.insert(cpu.l3Domain);
+	return static_cast<uint32_t>(domains.size());
+}
+
+uint32_t CpuTopology::RecommendedWorkerCount(uint32_t reservedCpu) const {
+	uint32_t cores = GetPhysicalCoreCount();
+	if (FindCpu(reservedCpu)) {
+		cores--;
+	}
+	return std::max(1u, cores);
+}
+
+std::vector<uint32_t> CpuTopology::PickWorkerCpus(uint32_t reservedCpu, uint32_t count) const {
+	const LogicalCpu* reserved = FindCpu(reservedCpu);
+
+	// core -> its logical cpus in id order
+	std::map<uint32_t, std::vector<uint32_t>> cores;
+	std::map<uint32_t, uint32_t> coreDomain;
+	for (const auto& cpu : cpus) {
+		cores[cpu.core].push_back(cpu.id);
+		coreDomain[cpu.core] = cpu.l3Domain;
+	}
+	for (auto& core : cores) {
+		std::sort(core.second.begin(), core.second.end());
+	}
+
+	std::vector<uint32_t> order;
+	for (const auto& core : cores) {
+		if (!reserved || core.first != reserved->core) {
+			order.push_back(core.first);
+		}
+	}
+	std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+		const bool aLocal = reserved && coreDomain[a] == reserved->l3Domain;
+		const bool bLocal = reserved && coreDomain[b] == reserved->l3Domain;
+		if (aLocal != bLocal) {
+			return aLocal;
+		}
+		return coreDomain[a] < coreDomain[b];
+	});
+	std::vector<uint32_t> picked;
+	for (size_t sibling = 0; picked.size() < count; sibling++) {
+		bool any = false;
+		for (const auto core : order) {
+			const std::vector<uint32_t>& logical = cores[core];
+			if (sibling >= logical.size()) {
+				continue;
+			}
+			any = true;
+			picked.push_back(logical[sibling]);
+			if (picked.size() == count) {
+				break;
+			}
+		}
+		if (!any) {
+			break;
+		}
+	}
+
+	// The reserved core's siblings come last, after every other hardware thread.
+	if (reserved) {
+		for (const auto id : cores[reserved->core]) {
+			if (picked.size() < count && id != reserved->id) {
+				picked.push_back(id);
+			}
+		}
+	}
+
+	return picked;
+}
+
+// ---------------- Thread placement ---------------- //
+
+int enginetool::GetCurrentCpu() {
+#ifdef __linux__
+	return sched_getcpu();
+#else
+	return -1;
+#endif
+}
+
+bool enginetool::PinCurrentThreadToCpu(uint32_t cpu) {
+#ifdef __linux__
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+	(void)cpu;
+	return false;
+#endif
+}
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <atomic>
+
+#include "headers/FrameAllocator.hpp"
+
+using namespace enginetool;
+
+namespace {
+	std::atomic<uint64_t> frameIndex(0);
+
+	struct ThreadArena {
+		FrameArena arena;
+		uint64_t frame = 0;
+	};
+}
+
+// ------- Constructors and dectructors ------------- //
+
+FrameArena::FrameArena(size_t blockSize) : blockSize(std::max<size_t>(blockSize, 64)) {
+}
+
+// ---------------- Main functions ------------------ //
+
+void* FrameArena::Allocate(size_t size, size_t alignment) {
+	size = std::max<size_t>(size, 1);
+
+	while (currentBlock < blocks.size()) {
+		Block& block = blocks[currentBlock];
+		const uintptr_t base = reinterpret_cast<uintptr_t>(block.memory.get());
+		const uintptr_t aligned = (base + offset + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+		const size_t end = static_cast<size_t>(aligned - base) + size;
+		if (end <= block.size) {
+			usedBytes += end - offset;
+			offset = end;
+			return reinterpret_cast<void*>(aligned);
+		}
+
+		currentBlock++;
+		offset = 0;
+	}
+
+	// Blocks grow geometrically, so a frame that keeps overflowing settles after a few resets
+	const size_t lastSize = blocks.empty() ? blockSize : blocks.back().size * 2;
+	AddBlock(std::max(lastSize, size + alignment));
+	return Allocate(size, alignment);
+}
+
+void FrameArena::Reset() {
+	if (blocks.size() > 1) {
+		const size_t capacity = GetCapacity();
+		blocks.clear();
+		AddBlock(capacity);
+	}
+
+	currentBlock = 0;
+	offset = 0;
+	usedBytes = 0;
+}
+
+size_t FrameArena::GetCapacity() const {
+	size_t capacity = 0;
+	for (const auto& block : blocks) {
+		capacity += block.size;
+	}
+	return capacity;
+}
+
+void FrameArena::AddBlock(size_t size) {
+	Block block;
+	block.memory.reset(new char[size]);
+	block.size = size;
+	blocks.push_back(std::move(block));
+	currentBlock = blocks.size() - 1;
+	offset = 0;
+}
+
+// -------------- Per-thread arenas ----------------- //
+
+FrameArena& enginetool::GetFrameArena() {
+	static thread_local ThreadArena threadArena;
+	const uint64_t frame = frameIndex.load(std::memory_order_acquire);
+	if (threadArena.frame != frame) {
+		threadArena.arena.Reset();
+		threadArena.frame = frame;
+	}
+	return threadArena.arena;
+}
+
+void enginetool::NextFrame() {
+	frameIndex.fetch_add(1, std::memory_order_acq_rel);
+}
+
+uint64_t enginetool::GetFrameIndex() {
+	return frameIndex.load(std::memory_order_acquire);
+}
\ No newline at end of file
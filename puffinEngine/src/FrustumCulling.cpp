@@ -0,0 +1,137 @@
+#include "headers/FrustumCulling.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PUFFIN_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PUFFIN_TARGET(isa) __attribute__((target(isa)))
+#else
+#define PUFFIN_TARGET(isa)
+#endif
+
+using namespace enginetool;
+
+namespace {
+	// Per plane the corner of a box furthest along its normal: when even that one is outside, the whole box is.
+	// Which corner it is depends only on the plane, so it is picked once for all boxes.
+	struct PlaneCorner {
+		const float* corner[3];
+		float normal[3];
+		float distance;
+	};
+
+	void PickCorners(const Frustum& frustum, const BoxArrays& boxes, size_t first, PlaneCorner* corners) {
+		for (int plane = 0; plane < 6; plane++) {
+			for (int axis = 0; axis < 3; axis++) {
+				corners[plane].normal[axis] = frustum.planes[plane][axis];
+				corners[plane].corner[axis] = ((frustum.planes[plane][axis] >= 0.0f) ? boxes.max[axis] : boxes.min[axis]) + first;
+			}
+			corners[plane].distance = frustum.planes[plane][3];
+		}
+	}
+
+	void CullBoxesScalar(const Frustum& frustum, const BoxArrays& boxes, size_t first, size_t count, uint8_t* visible) {
+		PlaneCorner corners[6];
+		PickCorners(frustum, boxes, first, corners);
+		for (size_t i = 0; i < count; i++) {
+			bool outside = false;
+			for (const PlaneCorner& plane : corners) {
+				const float side = plane.normal[0] * plane.corner[0][i] + plane.normal[1] * plane.corner[1][i] + plane.normal[2] * plane.corner[2][i] + plane.distance;
+				outside = outside || side < 0.0f;
+			}
+			visible[i] = outside ? 0 : 1;
+		}
+	}
+
+#if PUFFIN_SIMD_X86
+	// Four boxes a step, summed in the order of the scalar path
+	PUFFIN_TARGET("sse2")
+	void CullBoxesSSE2(const Frustum& frustum, const BoxArrays& boxes, size_t first, size_t count, uint8_t* visible) {
+		PlaneCorner corners[6];
+		PickCorners(frustum, boxes, first, corners);
+
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4) {
+			__m128 outside = _mm_setzero_ps();
+			for (const PlaneCorner& plane : corners) {
+				__m128 side = _mm_mul_ps(_mm_set1_ps(plane.normal[0]), _mm_loadu_ps(plane.corner[0] + i));
+				side = _mm_add_ps(side, _mm_mul_ps(_mm_set1_ps(plane.normal[1]), _mm_loadu_ps(plane.corner[1] + i)));
+				side = _mm_add_ps(side, _mm_mul_ps(_mm_set1_ps(plane.normal[2]), _mm_loadu_ps(plane.corner[2] + i)));
+				side = _mm_add_ps(side, _mm_set1_ps(plane.distance));
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(side, _mm_setzero_ps()));
+			}
+			const int mask = _mm_movemask_ps(outside);
+			for (int lane = 0; lane < 4; lane++) visible[i + lane] = ((mask >> lane) & 1) ? 0 : 1;
+		}
+
+		CullBoxesScalar(frustum, boxes, first + i, count - i, visible + i);
+	}
+
+	// Eight boxes a step. No FMA, it would round differently from the scalar path.
+	PUFFIN_TARGET("avx2")
+	void CullBoxesAVX2(const Frustum& frustum, const BoxArrays& boxes, size_t first, size_t count, uint8_t* visible) {
+		PlaneCorner corners[6];
+		PickCorners(frustum, boxes, first, corners);
+
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8) {
+			__m256 outside = _mm256_setzero_ps();
+			for (const PlaneCorner& plane : corners) {
+				__m256 side = _mm256_mul_ps(_mm256_set1_ps(plane.normal[0]), _mm256_loadu_ps(plane.corner[0] + i));
+				side = _mm256_add_ps(side, _mm256_mul_ps(_mm256_set1_ps(plane.normal[1]), _mm256_loadu_ps(plane.corner[1] + i)));
+				side = _mm256_add_ps(side, _mm256_mul_ps(_mm256_set1_ps(plane.normal[2]), _mm256_loadu_ps(plane.corner[2] + i)));
+				side = _mm256_add_ps(side, _mm256_set1_ps(plane.distance));
+				outside = _mm256_or_ps(outside, _mm256_cmp_ps(side, _mm256_setzero_ps(), _CMP_LT_OQ));
+			}
+			const int mask = _mm256_movemask_ps(outside);
+			for (int lane = 0; lane < 8; lane++) visible[i + lane] = ((mask >> lane) & 1) ? 0 : 1;
+		}
+
+		CullBoxesSSE2(frustum, boxes, first + i, count - i, visible + i);
+	}
+#endif
+
+	SimdLevel Clamp(SimdLevel level) {
+		return (static_cast<int>(level) > static_cast<int>(GetSupportedSimdLevel())) ? GetSupportedSimdLevel() : level;
+	}
+}
+
+// ---------------- Main functions ------------------ //
+
+// Gribb and Hartmann: a point is inside when -w <= x <= w, -w <= y <= w and 0 <= z <= w in clip space, and each of those
+// is a plane made of rows of the matrix
+Frustum enginetool::ExtractFrustum(const float* viewProjection) {
+	auto row = [viewProjection](int i, int column) { return viewProjection[column * 4 + i]; };
+	Frustum frustum;
+	for (int column = 0; column < 4; column++) {
+		frustum.planes[0][column] = row(3, column) + row(0, column);
+		frustum.planes[1][column] = row(3, column) - row(0, column);
+		frustum.planes[2][column] = row(3, column) + row(1, column);
+		frustum.planes[3][column] = row(3, column) - row(1, column);
+		frustum.planes[4][column] = row(2, column);
+		frustum.planes[5][column] = row(3, column) - row(2, column);
+	}
+	return frustum;
+}
+
+void enginetool::CullBoxes(const Frustum& frustum, const BoxArrays& boxes, size_t count, uint8_t* visible) {
+	CullBoxes(GetSimdLevel(), frustum, boxes, count, visible);
+}
+
+void enginetool::CullBoxes(SimdLevel level, const Frustum& frustum, const BoxArrays& boxes, size_t count, uint8_t* visible) {
+	switch (Clamp(level)) {
+#if PUFFIN_SIMD_X86
+	case SimdLevel::AVX2:
+		CullBoxesAVX2(frustum, boxes, 0, count, visible);
+		return;
+	case SimdLevel::SSE2:
+		CullBoxesSSE2(frustum, boxes, 0, count, visible);
+		return;
+#endif
+	default:
+		CullBoxesScalar(frustum, boxes, 0, count, visible);
+		return;
+	}
+}
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <sstream>
 
 #include "MeshLayout.cpp"
+#include "headers/FrameAllocator.hpp"
 #include "headers/GuiMainHub.hpp"
 
 using namespace puffinengine::tool;
@@ -186,19 +187,22 @@ void GuiMainHub::updateCommandBuffers(const double &frameTime, uint32_t elapsedT
 	}
 	else {
 		p_TextOverlay->renderText("Puffin Engine", 5.0f, 5.0f, TextAlignment::alignLeft);
-		std::stringstream ss;
+		// Rebuilt every frame, so the text lives in the frame arena instead of the global heap
+		enginetool::FrameStringStream ss;
 		ss << std::fixed << std::setprecision(2) << "Frame Time: " << frameTime << " ms | Elapsed: " << elapsedTime << " s | " << fps << " FPS";
-		p_TextOverlay->renderText(ss.str(), 5.0f, 25.0f, TextAlignment::alignLeft);
+		const enginetool::FrameString stats = ss.str();
+		p_TextOverlay->renderText(stats.data(), stats.size(), 5.0f, 25.0f, TextAlignment::alignLeft);
 
 		const int barWidth = 24;
 		const int filledWidth = static_cast<int>(m_PlayerHealthRatio * barWidth + 0.5f);
-		std::stringstream health;
+		enginetool::FrameStringStream health;
 		health << "HP " << m_PlayerCurrentHealth << "/" << m_PlayerMaxHealth << " [";
 		for (int i = 0; i < barWidth; ++i) {
 			health << (i < filledWidth ? '#' : '-');
 		}
 		health << "]";
-		p_TextOverlay->renderText(health.str(), 5.0f, 45.0f, TextAlignment::alignLeft);
+		const enginetool::FrameString healthBar = health.str();
+		p_TextOverlay->renderText(healthBar.data(), healthBar.size(), 5.0f, 45.0f, TextAlignment::alignLeft);
 
 		p_TextOverlay->renderText("Press \"1\" to turn on or off all GUI components", 5.0f, 65.0f, TextAlignment::alignLeft);
 		p_TextOverlay->renderText("Press \"WSAD\" to move camera", 5.0f, 85.0f, TextAlignment::alignLeft);
@@ -290,7 +290,7 @@ void GuiTextOverlay::beginTextUpdate() {
 	m_NumLetters = 0;
 }
 
-void GuiTextOverlay::renderText(const std::string& text, float x, float y, const TextAlignment& align) {
+void GuiTextOverlay::renderText(const char* text, size_t length, float x, float y, const TextAlignment& align) {
 	assert(p_Mapped != nullptr); // try-catch
 
 	float fbW = static_cast<float>(p_SwapChain->getExtent().width);
@@ -304,8 +304,8 @@ void GuiTextOverlay::renderText(const std::string& text, float x, float y, const
 
 	// Calculate text width
 	float textWidth = 0;
-	for (auto letter : text) {
-		stb_fontchar *charData = &m_StbFontData[static_cast<uint32_t>(letter) - STB_FIRST_CHAR];
+	for (size_t i = 0; i < length; i++) {
+		stb_fontchar *charData = &m_StbFontData[static_cast<uint32_t>(text[i]) - STB_FIRST_CHAR];
 		textWidth += charData->advance * charW;
 	}
 
@@ -319,8 +319,8 @@ void GuiTextOverlay::renderText(const std::string& text, float x, float y, const
 	}
 
 	// Generate a uv mapped quad per char in the new text
-	for (const auto &letter : text) {
-		stb_fontchar *charData = &m_StbFontData[static_cast<uint32_t>(letter) - STB_FIRST_CHAR];
+	for (size_t i = 0; i < length; i++) {
+		stb_fontchar *charData = &m_StbFontData[static_cast<uint32_t>(text[i]) - STB_FIRST_CHAR];
 
 		p_Mapped->x = (x + (float)charData->x0 * charW);
 		p_Mapped->y = (y + (float)charData->y0 * charH);
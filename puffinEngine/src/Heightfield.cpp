@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "headers/Heightfield.hpp"
+
+using namespace enginetool;
+
+namespace {
+	const float noGround = std::numeric_limits<float>::lowest();
+	const float crossed = std::numeric_limits<float>::infinity();
+}
+
+Heightfield::Heightfield(float cellSize) {
+	SetCellSize(cellSize);
+}
+
+void Heightfield::SetCellSize(float size) {
+	cellSize = size;
+	builtCellSize = size;
+}
+
+// ---------------- Building ------------------------ //
+
+void Heightfield::Clear() {
+	boxes.clear();
+	cells.clear();
+	width = 0;
+	depth = 0;
+}
+
+void Heightfield::Insert(const float* min, const float* max, bool flatTop) {
+	Box box;
+	std::copy(min, min + 3, box.min);
+	std::copy(max, max + 3, box.max);
+	box.flatTop = flatTop;
+	boxes.push_back(box);
+}
+
+void Heightfield::Build() {
+	cells.clear();
+	width = 0;
+	depth = 0;
+	builtCellSize = cellSize;
+	if (boxes.empty()) {
+		return;
+	}
+
+	float extent[2] = { 0.0f, 0.0f };
+	origin[0] = origin[1] = std::numeric_limits<float>::max();
+	for (const Box& box : boxes) {
+		origin[0] = std::min(origin[0], box.min[0]);
+		origin[1] = std::min(origin[1], box.min[2]);
+	}
+	for (const Box& box : boxes) {
+		extent[0] = std::max(extent[0], box.max[0] - origin[0]);
+		extent[1] = std::max(extent[1], box.max[2] - origin[1]);
+	}
+
+	// Doubling the cells until they fit keeps a scene of far apart boxes from taking all memory
+	uint64_t cellCount;
+	do {
+		inverseCellSize = 1.0f / builtCellSize;
+		width = static_cast<uint32_t>(std::min(extent[0] * inverseCellSize, static_cast<float>(maxCells))) + 1;
+		depth = static_cast<uint32_t>(std::min(extent[1] * inverseCellSize, static_cast<float>(maxCells))) + 1;
+		cellCount = static_cast<uint64_t>(width) * depth;
+		if (cellCount > maxCells) builtCellSize *= 2.0f;
+	} while (cellCount > maxCells);
+
+	cells.assign(static_cast<size_t>(cellCount), Cell{ noGround, noGround });
+	// Cells a box spans are [first, end). One that ends on a cell border only touches the next cell, so that cell is not in it.
+	auto firstCell = [this](float value, float start, uint32_t count) {
+		return std::min(count - 1, static_cast<uint32_t>((value - start) * inverseCellSize));
+	};
+	auto endCell = [this](float value, float start, uint32_t count) {
+		return std::min(count, static_cast<uint32_t>(std::ceil((value - start) * inverseCellSize)));
+	};
+	for (const Box& box : boxes) {
+		const uint32_t firstX = firstCell(box.min[0], origin[0], width);
+		const uint32_t endX = endCell(box.max[0], origin[0], width);
+		const uint32_t firstZ = firstCell(box.min[2], origin[1], depth);
+		const uint32_t endZ = endCell(box.max[2], origin[1], depth);
+		for (uint32_t z = firstZ; z < endZ; z++) {
+			const float cellMinZ = origin[1] + z * builtCellSize;
+			const bool coversZ = box.flatTop && box.min[2] <= cellMinZ && box.max[2] >= cellMinZ + builtCellSize;
+			for (uint32_t x = firstX; x < endX; x++) {
+				const float cellMinX = origin[0] + x * builtCellSize;
+				Cell& cell = cells[static_cast<size_t>(z) * width + x];
+				if (coversZ && box.min[0] <= cellMinX && box.max[0] >= cellMinX + builtCellSize) {
+					cell.top = std::max(cell.top, box.max[1]);
+					cell.reach = std::max(cell.reach, box.min[1]);
+				}
+				else {
+					cell.reach = crossed;
+				}
+			}
+		}
+	}
+}
+
+// ---------------- Queries ------------------------- //
+
+bool Heightfield::GroundLevel(float x, float y, float z, float& level) const {
+	const float cellX = std::floor((x - origin[0]) * inverseCellSize);
+	const float cellZ = std::floor((z - origin[1]) * inverseCellSize);
+	// Outside the grid there are no boxes; NaN lands here as well and is left to the ray cast
+	if (!(cellX >= 0.0f && cellX < width && cellZ >= 0.0f && cellZ < depth)) {
+		level = noGround;
+		return cellX == cellX && cellZ == cellZ;
+	}
+
+	const Cell& cell = cells[static_cast<size_t>(cellZ) * width + static_cast<size_t>(cellX)];
+	if (!(y >= cell.reach)) {
+		return false;
+	}
+	level = cell.top;
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,188 @@
+#include <cstring>
+
+#include "headers/BinaryStream.hpp"
+#include "headers/InputRecorder.hpp"
+
+using namespace enginetool;
+using namespace enginetool::binary;
+
+namespace {
+	const char magic[4] = { 'P', 'I', 'N', 'P' };
+}
+
+// ---------------- Serialisation ------------------- //
+
+void input::WriteHeader(std::ostream& stream, const InputRecordingHeader& header) {
+	stream.write(magic, sizeof(magic));
+	WriteRaw(stream, fileVersion);
+	WriteRaw(stream, header.fixedTimeValue);
+	WriteRaw(stream, header.width);
+	WriteRaw(stream, header.height);
+}
+
+bool input::ReadHeader(std::istream& stream, InputRecordingHeader& header) {
+	char fileMagic[4];
+	uint16_t version = 0;
+	if (!stream.read(fileMagic, sizeof(fileMagic)) || std::memcmp(fileMagic, magic, sizeof(magic)) != 0) {
+		return false;
+	}
+	if (!ReadRaw(stream, version) || version != fileVersion) {
+		return false;
+	}
+	return ReadRaw(stream, header.fixedTimeValue) && ReadRaw(stream, header.width) && ReadRaw(stream, header.height);
+}
+
+void input::WriteEvent(std::ostream& stream, const InputEvent& event, uint64_t previousTick) {
+	stream.put(static_cast<char>(event.type));
+	WriteVarint(stream, event.tick - previousTick);
+	WriteRaw(stream, event.time);
+
+	switch (event.type) {
+	case InputEventType::Key:
+	case InputEventType::MouseButton:
+		WriteRaw(stream, static_cast<int16_t>(event.code));
+		stream.put(static_cast<char>(event.action));
+		break;
+	case InputEventType::CursorPosition:
+		WriteRaw(stream, event.x);
+		WriteRaw(stream, event.y);
+		break;
+	case InputEventType::End:
+		break;
+	case InputEventType::Frame:
+		WriteRaw(stream, event.alpha);
+		break;
+	}
+}
+
+bool input::ReadEvent(std::istream& stream, InputEvent& event, uint64_t previousTick) {
+	const int type = stream.get();
+	uint64_t tickDelta = 0;
+	if (type == std::char_traits<char>::eof() || type > static_cast<int>(InputEventType::Frame)) {
+		return false;
+	}
+	if (!ReadVarint(stream, tickDelta) || !ReadRaw(stream, event.time)) {
+		return false;
+	}
+	event.type = static_cast<InputEventType>(type);
+	event.tick = previousTick + tickDelta;
+
+	switch (event.type) {
+	case InputEventType::Key:
+	case InputEventType::MouseButton: {
+		int16_t code = 0;
+		if (!ReadRaw(stream, code)) {
+			return false;
+		}
+		const int action = stream.get();
+		if (action == std::char_traits<char>::eof()) {
+			return false;
+		}
+		event.code = code;
+		event.action = action;
+		return true;
+	}
+	case InputEventType::CursorPosition:
+		return ReadRaw(stream, event.x) && ReadRaw(stream, event.y);
+	case InputEventType::End:
+		return true;
+	case InputEventType::Frame:
+		return ReadRaw(stream, event.alpha);
+	}
+	return false;
+}
+
+// ---------------- Recording ----------------------- //
+
+bool InputRecorder::Open(const std::string& path, const InputRecordingHeader& header) {
+	file.open(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	input::WriteHeader(file, header);
+	start = std::chrono::steady_clock::now();
+	previousTick = 0;
+	return true;
+}
+
+void InputRecorder::Record(InputEvent event) {
+	if (!file.is_open()) {
+		return;
+	}
+
+	event.time = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+	input::WriteEvent(file, event, previousTick);
+	previousTick = event.tick;
+}
+
+void InputRecorder::Close(uint64_t tick) {
+	if (!file.is_open()) {
+		return;
+	}
+
+	InputEvent end;
+	end.type = InputEventType::End;
+	end.tick = tick;
+	Record(end);
+	file.close();
+}
+
+// ---------------- Replay -------------------------- //
+
+bool InputReplay::Load(const std::string& path) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open()) {
+		return false;
+	}
+	return Load(file);
+}
+
+bool InputReplay::Load(std::istream& stream) {
+	active = false;
+	events.clear();
+	nextEvent = 0;
+
+	if (!input::ReadHeader(stream, header) || header.fixedTimeValue <= 0.0) {
+		return false;
+	}
+
+	InputEvent event;
+	uint64_t previousTick = 0;
+	while (input::ReadEvent(stream, event, previousTick)) {
+		previousTick = event.tick;
+		if (event.type == InputEventType::End) {
+			active = true;
+			return true;
+		}
+		events.push_back(event);
+	}
+
+	// A recording cut short by a crash still replays up to its last event
+	active = true;
+	return true;
+}
+
+bool InputReplay::NextFrame(std::vector<InputEvent>& frameEvents, InputEvent& frame) {
+	frameEvents.clear();
+	while (nextEvent < events.size()) {
+		const InputEvent& event = events[nextEvent++];
+		if (event.type == InputEventType::Frame) {
+			frame = event;
+			return true;
+		}
+		frameEvents.push_back(event);
+	}
+
+	if (frameEvents.empty()) {
+		return false;
+	}
+	frame = InputEvent();
+	frame.type = InputEventType::Frame;
+	frame.tick = frameEvents.back().tick;
+	return true;
+}
+
+bool InputReplay::IsFinished() const {
+	return active && nextEvent >= events.size();
+}
\ No newline at end of file
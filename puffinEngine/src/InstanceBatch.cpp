@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#include "headers/BinaryStream.hpp"
+#include "headers/InstanceBatch.hpp"
+
+using namespace enginetool;
+
+namespace {
+	const char magic[4] = { 'P', 'I', 'N', 'S' };
+
+	void SwapFloatBytes(float* values, size_t count) {
+		for (size_t i = 0; i < count; i++) {
+			unsigned char* bytes = reinterpret_cast<unsigned char*>(values + i);
+			std::swap(bytes[0], bytes[3]);
+			std::swap(bytes[1], bytes[2]);
+		}
+	}
+}
+
+// ---------------- Main functions ------------------ //
+
+void InstanceBatch::Add(const InstanceLayout* first, size_t count) {
+	if (count == 0) {
+		return;
+	}
+
+	if (instances.empty()) {
+		bounds.min = glm::vec3(std::numeric_limits<float>::max());
+		bounds.max = glm::vec3(std::numeric_limits<float>::lowest());
+	}
+	for (size_t i = 0; i < count; i++) {
+		bounds.min = glm::min(bounds.min, first[i].pos + mesh->aabb.min);
+		bounds.max = glm::max(bounds.max, first[i].pos + mesh->aabb.max);
+	}
+	instances.insert(instances.end(), first, first + count);
+}
+
+// ---------------- Serialisation ------------------- //
+
+bool instancing::Save(const std::string& path, const std::vector<InstanceBatch>& batches) {
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	file.write(magic, sizeof(magic));
+	file.put(static_cast<char>(fileVersion & 0xff));
+	file.put(static_cast<char>(fileVersion >> 8));
+	binary::WriteVarint(file, batches.size());
+	for (const auto& batch : batches) {
+		binary::WriteString(file, batch.meshName);
+		binary::WriteString(file, batch.materialName);
+		binary::WriteVarint(file, batch.instances.size());
+		if (binary::IsLittleEndian()) {
+			file.write(reinterpret_cast<const char*>(batch.instances.data()), batch.instances.size() * sizeof(InstanceLayout));
+		}
+		else {
+			std::vector<InstanceLayout> swapped(batch.instances);
+			SwapFloatBytes(&swapped.data()->pos.x, swapped.size() * 3);
+			file.write(reinterpret_cast<const char*>(swapped.data()), swapped.size() * sizeof(InstanceLayout));
+		}
+	}
+	return static_cast<bool>(file);
+}
+
+bool instancing::Load(const std::string& path, std::vector<InstanceBatch>& batches) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open()) {
+		return false;
+	}
+	return Load(file, batches);
+}
+
+bool instancing::Load(std::istream& stream, std::vector<InstanceBatch>& batches) {
+	static_assert(sizeof(InstanceLayout) == 3 * sizeof(float), "instance positions are read as packed floats");
+	batches.clear();
+
+	char fileMagic[4];
+	unsigned char version[2];
+	if (!stream.read(fileMagic, sizeof(fileMagic)) || std::memcmp(fileMagic, magic, sizeof(magic)) != 0) {
+		return false;
+	}
+	if (!stream.read(reinterpret_cast<char*>(version), sizeof(version)) || (version[0] | version[1] << 8) != fileVersion) {
+		return false;
+	}
+
+	uint64_t batchCount = 0;
+	if (!binary::ReadVarint(stream, batchCount)) {
+		return false;
+	}
+	for (uint64_t i = 0; i < batchCount; i++) {
+		InstanceBatch batch;
+		uint64_t instanceCount = 0;
+		if (!binary::ReadString(stream, batch.meshName) || !binary::ReadString(stream, batch.materialName) || !binary::ReadVarint(stream, instanceCount)) {
+			batches.clear();
+			return false;
+		}
+		// Positions are already in their in-memory layout and go straight into the array, in chunks,
+		// so a corrupt count fails at the end of the stream instead of in one huge allocation
+		while (batch.instances.size() < instanceCount) {
+			const size_t first = batch.instances.size();
+			const size_t count = static_cast<size_t>(std::min<uint64_t>(instanceCount - first, binary::readChunk));
+			batch.instances.resize(first + count);
+			if (!stream.read(reinterpret_cast<char*>(batch.instances.data() + first), count * sizeof(InstanceLayout))) {
+				batches.clear();
+				return false;
+			}
+		}
+		if (!binary::IsLittleEndian()) {
+			SwapFloatBytes(&batch.instances.data()->pos.x, batch.instances.size() * 3);
+		}
+		batches.push_back(std::move(batch));
+	}
+	return true;
+}
\ No newline at end of file
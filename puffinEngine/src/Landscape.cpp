@@ -6,8 +6,8 @@
 
 // ------- Constructors and dectructors ------------- //
 
-Landscape::Landscape(std::string name, std::string description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors) 
-: Actor(name, description, position, type, actors) {
+Landscape::Landscape(enginetool::NameId name, enginetool::NameId description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors, enginetool::MotionStore& motionStore) 
+: Actor(name, description, position, type, actors, motionStore) {
 #if DEBUG_VERSION
 	// create save file
 	std::cout << "Landscape created\n";
@@ -28,15 +28,17 @@ void Landscape::Init(unsigned int maxHealth, int currentHealth) {
 }
 
 void Landscape::UpdatePosition(float dt) {
-	if(movementGoal!=glm::vec3(0.0f,0.0f,0.0f) && !manualControl) Actor::CheckIfInTheDestination();
+	glm::vec3& movement = Movement();
+	const glm::vec3& movementGoal = MovementGoal();
+	BeginMove();
 
-	movement.x = Approach(movementGoal.x, movement.x, dt * 500);
-	movement.y = Approach(movementGoal.y, movement.y, dt * 500);
- 	movement.z = Approach(movementGoal.z, movement.z, dt * 500);
+	movement.x = Approach(movementGoal.x, movement.x, dt * approachRate);
+	movement.y = Approach(movementGoal.y, movement.y, dt * approachRate);
+ 	movement.z = Approach(movementGoal.z, movement.z, dt * approachRate);
 
-	position += movement * dt;
+	Position() += movement * dt;
 
-	Actor::UpdateAABB();
+	EndMove();
 }
 
 glm::vec3 Landscape::CalculateSelectionIndicatorColor(){
@@ -69,8 +71,8 @@ void Landscape::ResetPosition(){
 
 // ------- Constructors and dectructors ------------- //
 
-Sea::Sea(std::string name, std::string description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors) 
-: Landscape(name, description, position, type, actors) {
+Sea::Sea(enginetool::NameId name, enginetool::NameId description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors, enginetool::MotionStore& motionStore) 
+: Landscape(name, description, position, type, actors, motionStore) {
 #if DEBUG_VERSION
 	std::cout << "Sea created\n";
 #endif
@@ -135,8 +137,8 @@ void Sea::CreateMesh() {
 
 // ------- Constructors and dectructors ------------- //
 
-Cloud::Cloud(std::string name, std::string description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors) 
-: Landscape(name, description, position, type, actors) {
+Cloud::Cloud(enginetool::NameId name, enginetool::NameId description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors, enginetool::MotionStore& motionStore) 
+: Landscape(name, description, position, type, actors, motionStore) {
 #if DEBUG_VERSION
 	std::cout << "Cloud created\n";
 #endif
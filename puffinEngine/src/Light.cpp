@@ -4,8 +4,8 @@
 
 // ------- Constructors and dectructors ------------- //
 
-Light::Light(std::string name, std::string description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors) 
-: Actor(name, description, position, type, actors) {
+Light::Light(enginetool::NameId name, enginetool::NameId description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors, enginetool::MotionStore& motionStore) 
+: Actor(name, description, position, type, actors, motionStore) {
 #if DEBUG_VERSION
 	std::cout << "Light created\n";
 #endif
@@ -17,8 +17,8 @@ Light::~Light() {
 #endif
 }
 
-SphereLight::SphereLight(std::string name, std::string description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors) 
-: Light(name, description, position, type, actors) {
+SphereLight::SphereLight(enginetool::NameId name, enginetool::NameId description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors, enginetool::MotionStore& motionStore) 
+: Light(name, description, position, type, actors, motionStore) {
 #if DEBUG_VERSION
 	std::cout << "Sphere light created\n";
 #endif
@@ -30,8 +30,8 @@ SphereLight::~SphereLight() {
 #endif
 }
 
-Skybox::Skybox(std::string name, std::string description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors, float horizon) 
-: Light(name, description, position, type, actors) {
+Skybox::Skybox(enginetool::NameId name, enginetool::NameId description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors, enginetool::MotionStore& motionStore, float horizon) 
+: Light(name, description, position, type, actors, motionStore) {
 #if DEBUG_VERSION
 	std::cout << "Skybox created\n";
 #endif
@@ -60,15 +60,17 @@ glm::vec3 Light::CalculateSelectionIndicatorColor() {
 }
 
 void Light::UpdatePosition(float dt) {
-	if(movementGoal!=glm::vec3(0.0f,0.0f,0.0f) && !manualControl) Actor::CheckIfInTheDestination();
+	glm::vec3& movement = Movement();
+	const glm::vec3& movementGoal = MovementGoal();
+	BeginMove();
 	// Smooth movement and edge case in approach, without is movement is const
-	movement.x = Approach(movementGoal.x, movement.x, dt * 80);
-	movement.y = Approach(movementGoal.y, movement.y, dt * 80);
- 	movement.z = Approach(movementGoal.z, movement.z, dt * 80);
+	movement.x = Approach(movementGoal.x, movement.x, dt * approachRate);
+	movement.y = Approach(movementGoal.y, movement.y, dt * approachRate);
+ 	movement.z = Approach(movementGoal.z, movement.z, dt * approachRate);
 
-	position += movement * dt;
+	Position() += movement * dt;
 
-	Actor::UpdateAABB();
+	EndMove();
 }
 
 void Skybox::CreateMesh() {
@@ -5,8 +5,8 @@
 
 // ------- Constructors and dectructors ------------- //
 
-MainCharacter::MainCharacter(std::string name, std::string description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors ) 
-: Character(name, description, position, type, actors) {
+MainCharacter::MainCharacter(enginetool::NameId name, enginetool::NameId description, glm::vec3 position, ActorType type,  std::vector<std::shared_ptr<Actor>>& actors, enginetool::MotionStore& motionStore ) 
+: Character(name, description, position, type, actors, motionStore) {
 	// create save file
 	std::cout << "MainCharacter created\n";
 }
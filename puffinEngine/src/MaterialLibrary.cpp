@@ -46,6 +46,7 @@ void MaterialLibrary::CreateCommandPool() {
 }
 
 void MaterialLibrary::FillLibrary() {
+	PUFFIN_PROFILE_ZONE("MaterialLibrary::FillLibrary");
     enginetool::SceneMaterial defaultGray;
 		enginetool::SceneMaterial rust;
 		enginetool::SceneMaterial chrome;
@@ -106,6 +107,7 @@ void MaterialLibrary::FillLibrary() {
 }
 
 void MaterialLibrary::LoadTexture(std::string texture, TextureLayout& layer) {
+	PUFFIN_PROFILE_ZONE("MaterialLibrary::LoadTexture");
 	stbi_uc* pixels = stbi_load(texture.c_str(), (int*)&layer.texWidth, (int*)&layer.texHeight, &layer.texChannels, STBI_rgb_alpha);
 
 	if (!pixels) {
@@ -132,6 +134,7 @@ void MaterialLibrary::LoadTexture(std::string texture, TextureLayout& layer) {
 }
 
 void MaterialLibrary::LoadSkyboxTexture(TextureLayout& layer) {
+	PUFFIN_PROFILE_ZONE("MaterialLibrary::LoadSkyboxTexture");
 	std::filesystem::path p = std::filesystem::current_path().parent_path();
 	std::filesystem::path texture = p / "puffinEngine" / "assets" / "skybox" / "car_cubemap.ktx";
 	gli::texture_cube texCube(gli::load(texture.string()));
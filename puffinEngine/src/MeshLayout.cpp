@@ -1,3 +1,5 @@
+#pragma once
+
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/glm.hpp>
 #include <glm/gtx/hash.hpp>
@@ -6,6 +8,8 @@
 #include <string>
 #include <vulkan/vulkan.h>
 
+#include "headers/TriangleBvh.hpp"
+
 namespace enginetool {
 	struct VertexLayout {
 		glm::vec3 pos;
@@ -96,6 +100,9 @@ namespace enginetool {
 		
 		std::string meshFilename;
 
+		TriangleBvh bvh; // triangles in mesh space, for exact ray hits
+		bool flatTop = false; // the top face of the aabb is all mesh, so standing on the box is standing on the mesh
+
 		void GetAABB(const std::vector<enginetool::VertexLayout>& vertices) {
 			glm::vec3 min; 
 			glm::vec3 max;
@@ -118,6 +125,21 @@ namespace enginetool {
     		aabb.max = max;
 		}
 
+		// Needs the aabb. Sums the triangles lying in the top face of the box, small gaps between them are let through.
+		void GetFlatTop(const std::vector<enginetool::VertexLayout>& vertices, const std::vector<uint32_t>& indices) {
+			float area = 0.0f;
+			for (uint32_t i = indexBase; i + 2 < indexBase + indexCount; i += 3) {
+				const glm::vec3& a = vertices[indices[i]].pos;
+				const glm::vec3& b = vertices[indices[i + 1]].pos;
+				const glm::vec3& c = vertices[indices[i + 2]].pos;
+				if (a.y == aabb.max.y && b.y == aabb.max.y && c.y == aabb.max.y) {
+					area += std::abs((b.x - a.x) * (c.z - a.z) - (c.x - a.x) * (b.z - a.z)) * 0.5f;
+				}
+			}
+			const float footprint = (aabb.max.x - aabb.min.x) * (aabb.max.z - aabb.min.z);
+			flatTop = footprint > 0.0f && area >= footprint * 0.999f;
+		}
+
 		static bool Overlaps(const AABB& a, const AABB& b) {
 			return  a.max.x >= b.min.x && a.min.x <= b.max.x &&
 					a.max.y >= b.min.y && a.min.y <= b.max.y &&
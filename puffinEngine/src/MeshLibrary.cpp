@@ -31,10 +31,12 @@ void MeshLibrary::Init(Device* device) {
 
     FillLibrary();
 	PrepeareAABBs();
+	PrepeareBvhs();
 	GetAABBDrawData();  
 }
 
 void MeshLibrary::FillLibrary() {
+	PUFFIN_PROFILE_ZONE("MeshLibrary::FillLibrary");
     enginetool::ScenePart box, teapot, human, plane, cloud, sphere, smallCoinB, coin; 
 
 	std::filesystem::path p = std::filesystem::current_path().parent_path();
@@ -83,7 +85,33 @@ void MeshLibrary::PrepeareAABBs() {
 	for (auto& m : meshes) m.second.GetAABB(vertices);
 }
 
+// Hierarchies are saved next to the mesh, a start after the first one only reads them back
+void MeshLibrary::PrepeareBvhs() {
+	PUFFIN_PROFILE_ZONE("MeshLibrary::PrepeareBvhs");
+	for (auto& m : meshes) {
+		enginetool::ScenePart& mesh = m.second;
+		mesh.GetFlatTop(vertices, indices);
+		if (mesh.indexCount == 0) {
+			continue;
+		}
+
+		const std::string cachePath = mesh.meshFilename + ".bvh";
+		const float* positions = &vertices[0].pos.x;
+		if (mesh.bvh.Load(cachePath, positions, sizeof(enginetool::VertexLayout), &indices[mesh.indexBase], mesh.indexCount)) {
+			continue;
+		}
+
+		mesh.bvh.Build(positions, sizeof(enginetool::VertexLayout), &indices[mesh.indexBase], mesh.indexCount);
+		if (!mesh.bvh.Save(cachePath)) {
+#if DEBUG_VERSION
+			std::cout << "Could not save " << cachePath << "\n";
+#endif
+		}
+	}
+}
+
 void MeshLibrary::Load(enginetool::ScenePart& mesh){
+	PUFFIN_PROFILE_ZONE("MeshLibrary::Load");
 	tinyobj::attrib_t attrib;
 	std::vector<tinyobj::shape_t> shapes;
 	std::vector<tinyobj::material_t> materials;
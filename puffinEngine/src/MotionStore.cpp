@@ -0,0 +1,110 @@
+#include <algorithm>
+
+#include "headers/MotionStore.hpp"
+#include "headers/ObjectPool.hpp"
+
+using namespace enginetool;
+
+// ---------------- Main functions ------------------ //
+
+void MotionStore::Add(const glm::vec3& position, uint32_t& slot) {
+	positions.push_back(position);
+	previousPositions.push_back(position);
+	renderPositions.push_back(position);
+	movements.push_back(glm::vec3(0.0f, 0.0f, 0.0f));
+	movementGoals.push_back(glm::vec3(0.0f, 0.0f, 0.0f));
+	velocities.push_back(glm::vec3(30.0f, 30.0f, 30.0f));
+	aabbs.push_back({ position, position });
+	owners.push_back(&slot);
+	slot = static_cast<uint32_t>(positions.size() - 1);
+
+	// New actors start awake
+	Wake(slot);
+}
+
+void MotionStore::Remove(uint32_t slot) {
+	// Sleeping moves an awake slot to the end of the awake part, the owner's index follows it there
+	uint32_t* owner = owners[slot];
+	Sleep(slot);
+	Swap(*owner, static_cast<uint32_t>(positions.size() - 1));
+
+	positions.pop_back();
+	previousPositions.pop_back();
+	renderPositions.pop_back();
+	movements.pop_back();
+	movementGoals.pop_back();
+	velocities.pop_back();
+	aabbs.pop_back();
+	owners.pop_back();
+}
+
+void MotionStore::Clear() {
+	positions.clear();
+	previousPositions.clear();
+	renderPositions.clear();
+	movements.clear();
+	movementGoals.clear();
+	velocities.clear();
+	aabbs.clear();
+	owners.clear();
+	awakeCount = 0;
+}
+
+void MotionStore::Reserve(size_t count) {
+	ReserveMore(positions, count);
+	ReserveMore(previousPositions, count);
+	ReserveMore(renderPositions, count);
+	ReserveMore(movements, count);
+	ReserveMore(movementGoals, count);
+	ReserveMore(velocities, count);
+	ReserveMore(aabbs, count);
+	ReserveMore(owners, count);
+}
+
+// The slot trades places with the last awake one. Its previous and render positions are settled on the current position,
+// which is where the interpolation would have ended up had it kept running.
+void MotionStore::Sleep(uint32_t slot) {
+	if (!IsAwake(slot)) {
+		return;
+	}
+	previousPositions[slot] = positions[slot];
+	renderPositions[slot] = positions[slot];
+	awakeCount--;
+	Swap(slot, static_cast<uint32_t>(awakeCount));
+}
+
+bool MotionStore::Wake(uint32_t slot) {
+	if (IsAwake(slot)) {
+		return false;
+	}
+	Swap(slot, static_cast<uint32_t>(awakeCount));
+	awakeCount++;
+	return true;
+}
+
+void MotionStore::Swap(uint32_t first, uint32_t second) {
+	if (first == second) {
+		return;
+	}
+	std::swap(positions[first], positions[second]);
+	std::swap(previousPositions[first], previousPositions[second]);
+	std::swap(renderPositions[first], renderPositions[second]);
+	std::swap(movements[first], movements[second]);
+	std::swap(movementGoals[first], movementGoals[second]);
+	std::swap(velocities[first], velocities[second]);
+	std::swap(aabbs[first], aabbs[second]);
+	std::swap(owners[first], owners[second]);
+	*owners[first] = first;
+	*owners[second] = second;
+}
+
+void MotionStore::StoreTickState(size_t first, size_t last) {
+	std::copy(positions.begin() + first, positions.begin() + last, previousPositions.begin() + first);
+}
+
+// Alpha is the part of a fixed step left in the accumulator, 0 shows the previous tick and 1 the latest one.
+void MotionStore::Interpolate(float alpha, size_t first, size_t last) {
+	for (size_t i = first; i < last; i++) {
+		renderPositions[i] = glm::mix(previousPositions[i], positions[i], alpha);
+	}
+}
\ No newline at end of file
@@ -25,7 +25,7 @@ glm::vec3 MousePicker::GetRayDirection() const {
 }
 
 glm::vec3 MousePicker::GetRayOrigin() const {
-	return currentCamera->position;
+	return currentCamera->Position();
 }
 
 // ---------------- Main functions ------------------ //
@@ -36,7 +36,7 @@ void MousePicker::init(Device* device) {
 	height = 600;
 }
 
-void MousePicker::UpdateMousePicker(const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, std::shared_ptr<Camera> camera) {
+void MousePicker::UpdateMousePicker(const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, Camera* camera) {
     view = viewMatrix;
     proj = projectionMatrix;
     currentCamera = camera;
@@ -0,0 +1,114 @@
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "headers/BinaryStream.hpp"
+#include "headers/NameTable.hpp"
+
+using namespace enginetool;
+
+namespace {
+	const char magic[4] = { 'P', 'N', 'A', 'M' };
+	const uint16_t fileVersion = 1;
+}
+
+NameTable::NameTable() {
+	Clear();
+}
+
+// ---------------- Main functions ------------------ //
+
+NameId NameTable::Intern(const std::string& text) {
+	LoadPending();
+	auto inserted = ids.emplace(text, static_cast<NameId>(strings.size()));
+	if (inserted.second) {
+		strings.push_back(&inserted.first->first);
+	}
+	return inserted.first->second;
+}
+
+const std::string& NameTable::Lookup(NameId id) {
+	LoadPending();
+	if (id >= strings.size()) {
+		throw std::runtime_error("name id out of range!");
+	}
+	return *strings[id];
+}
+
+size_t NameTable::GetCount() {
+	LoadPending();
+	return strings.size();
+}
+
+void NameTable::Clear() {
+	ids.clear();
+	strings.clear();
+	pendingPath.clear();
+	strings.push_back(&ids.emplace(std::string(), 0).first->first);
+}
+
+// ---------------- Serialisation ------------------- //
+
+bool NameTable::Save(const std::string& path) {
+	LoadPending();
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	file.write(magic, sizeof(magic));
+	file.put(static_cast<char>(fileVersion & 0xff));
+	file.put(static_cast<char>(fileVersion >> 8));
+	binary::WriteVarint(file, strings.size());
+	for (const std::string* text : strings) {
+		binary::WriteString(file, *text);
+	}
+	return static_cast<bool>(file);
+}
+
+bool NameTable::Load(std::istream& stream) {
+	Clear();
+
+	char fileMagic[4];
+	unsigned char version[2];
+	if (!stream.read(fileMagic, sizeof(fileMagic)) || std::memcmp(fileMagic, magic, sizeof(magic)) != 0) {
+		return false;
+	}
+	if (!stream.read(reinterpret_cast<char*>(version), sizeof(version)) || (version[0] | version[1] << 8) != fileVersion) {
+		return false;
+	}
+
+	uint64_t count = 0;
+	if (!binary::ReadVarint(stream, count)) {
+		return false;
+	}
+	std::string text;
+	for (uint64_t i = 0; i < count; i++) {
+		if (!binary::ReadString(stream, text)) {
+			Clear();
+			return false;
+		}
+		// Ids must come back as they were saved, so a table with duplicates or a misplaced empty string is rejected
+		if (Intern(text) != i) {
+			Clear();
+			return false;
+		}
+	}
+	return true;
+}
+
+void NameTable::Open(const std::string& path) {
+	Clear();
+	pendingPath = path;
+}
+
+void NameTable::LoadPending() {
+	if (pendingPath.empty()) {
+		return;
+	}
+	std::ifstream file(pendingPath, std::ios::binary);
+	pendingPath.clear();
+	if (!file.is_open() || !Load(file)) {
+		throw std::runtime_error("failed to load name table!");
+	}
+}
\ No newline at end of file
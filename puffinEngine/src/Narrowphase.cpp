@@ -0,0 +1,57 @@
+#include <algorithm>
+
+#include "headers/Narrowphase.hpp"
+
+using namespace enginetool;
+
+bool Narrowphase::Overlaps(const float* boxes, const Contact& pair) {
+	const float* a = boxes + static_cast<size_t>(pair.first) * 6;
+	const float* b = boxes + static_cast<size_t>(pair.second) * 6;
+	return a[3] >= b[0] && a[0] <= b[3] &&
+		a[4] >= b[1] && a[1] <= b[4] &&
+		a[5] >= b[2] && a[2] <= b[5];
+}
+
+void Narrowphase::FindContacts(ThreadPool* threadPool, const std::vector<Contact>& pairs, const float* boxes, std::vector<Contact>& contacts) {
+	const size_t chunkCount = (pairs.size() + pairsPerJob - 1) / pairsPerJob;
+	if (chunkContacts.size() < chunkCount) chunkContacts.resize(chunkCount);
+
+	ParallelFor(threadPool, 0, chunkCount, 1, [&](size_t firstChunk, size_t lastChunk) {
+		for (size_t chunk = firstChunk; chunk < lastChunk; chunk++) {
+			std::vector<Contact>& found = chunkContacts[chunk];
+			found.clear();
+			const size_t last = std::min(pairs.size(), (chunk + 1) * pairsPerJob);
+			for (size_t i = chunk * pairsPerJob; i < last; i++) {
+				if (Overlaps(boxes, pairs[i])) found.push_back(pairs[i]);
+			}
+		}
+	});
+	Merge(chunkCount, contacts);
+}
+
+void Narrowphase::FindContacts(ThreadPool* threadPool, const SpatialHash& broadphase, const float* boxes, std::vector<Contact>& contacts) {
+	const uint32_t chunkCount = static_cast<uint32_t>(std::max<size_t>(1, broadphase.GetCount() / boxesPerJob));
+	if (chunkContacts.size() < chunkCount) chunkContacts.resize(chunkCount);
+
+	// Each chunk finds its part of the pairs and keeps the ones that overlap, in place
+	ParallelFor(threadPool, 0, chunkCount, 1, [&](size_t firstChunk, size_t lastChunk) {
+		for (size_t chunk = firstChunk; chunk < lastChunk; chunk++) {
+			std::vector<Contact>& found = chunkContacts[chunk];
+			found.clear();
+			broadphase.FindPairs(found, static_cast<uint32_t>(chunk), chunkCount);
+			found.erase(std::remove_if(found.begin(), found.end(), [boxes](const Contact& pair) {
+				return !Overlaps(boxes, pair);
+			}), found.end());
+		}
+	});
+	Merge(chunkCount, contacts);
+}
+
+void Narrowphase::Merge(size_t chunkCount, std::vector<Contact>& contacts) const {
+	size_t total = contacts.size();
+	for (size_t chunk = 0; chunk < chunkCount; chunk++) total += chunkContacts[chunk].size();
+	contacts.reserve(total);
+	for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+		contacts.insert(contacts.end(), chunkContacts[chunk].begin(), chunkContacts[chunk].end());
+	}
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "headers/Profiler.hpp"
+
+using namespace enginetool;
+
+namespace {
+	const size_t eventsPerThread = 1 << 16;
+
+	struct ThreadEvents {
+		uint32_t threadId = 0;
+		std::string threadName;
+		std::vector<profiler::Event> events = std::vector<profiler::Event>(eventsPerThread);
+		uint64_t written = 0;
+	};
+
+	// Buffers outlive their threads, so a dump still shows workers of a pool that was resized.
+	struct Registry {
+		std::mutex mutex;
+		std::vector<std::unique_ptr<ThreadEvents>> threads;
+		const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+	};
+
+	Registry& GetRegistry() {
+		static Registry registry;
+		return registry;
+	}
+
+	ThreadEvents& GetThreadEvents() {
+		static thread_local ThreadEvents* events = nullptr;
+		if (!events) {
+			Registry& registry = GetRegistry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			registry.threads.push_back(std::make_unique<ThreadEvents>());
+			events = registry.threads.back().get();
+			events->threadId = static_cast<uint32_t>(registry.threads.size());
+			events->threadName = "Thread " + std::to_string(events->threadId);
+		}
+		return *events;
+	}
+
+	void WriteEscaped(std::ostream& stream, const char* text) {
+		for (const char* c = text; *c; c++) {
+			if (*c == '"' || *c == '\\') stream << '\\';
+			stream << *c;
+		}
+	}
+}
+
+// ---------------- Main functions ------------------ //
+
+uint64_t profiler::Now() {
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - GetRegistry().origin).count());
+}
+
+void profiler::Record(const Event& event) {
+	ThreadEvents& thread = GetThreadEvents();
+	thread.events[thread.written % eventsPerThread] = event;
+	thread.written++;
+}
+
+void profiler::Counter(const char* name, double value) {
+	Record(Event{ name, Now(), 0, value, EventType::Counter });
+}
+
+void profiler::Frame(const char* name) {
+	Record(Event{ name, Now(), 0, 0.0, EventType::Frame });
+}
+
+void profiler::SetThreadName(const std::string& name) {
+	GetThreadEvents().threadName = name;
+}
+
+void profiler::Clear() {
+	Registry& registry = GetRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	for (const auto& thread : registry.threads) {
+		thread->written = 0;
+	}
+}
+
+// ------------------- Chrome trace ----------------- //
+
+void profiler::WriteChromeTrace(std::ostream& stream) {
+	Registry& registry = GetRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+
+	stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	bool first = true;
+	auto separator = [&stream, &first]() {
+		if (!first) stream << ",\n";
+		first = false;
+	};
+
+	for (const auto& thread : registry.threads) {
+		separator();
+		stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread->threadId << ",\"args\":{\"name\":\"";
+		WriteEscaped(stream, thread->threadName.c_str());
+		stream << "\"}}";
+
+		const uint64_t count = std::min<uint64_t>(thread->written, eventsPerThread);
+		for (uint64_t i = thread->written - count; i < thread->written; i++) {
+			const Event& event = thread->events[i % eventsPerThread];
+			separator();
+			stream << "{\"name\":\"";
+			WriteEscaped(stream, event.name);
+			stream << "\",\"pid\":1,\"tid\":" << thread->threadId << ",\"ts\":" << event.start / 1000.0;
+			switch (event.type) {
+			case EventType::Zone:
+				stream << ",\"ph\":\"X\",\"dur\":" << event.duration / 1000.0 << "}";
+				break;
+			case EventType::Counter:
+				stream << ",\"ph\":\"C\",\"args\":{\"value\":" << event.value << "}}";
+				break;
+			case EventType::Frame:
+				stream << ",\"ph\":\"i\",\"s\":\"g\"}";
+				break;
+			}
+		}
+	}
+
+	stream << "\n]}\n";
+}
+
+bool profiler::WriteChromeTrace(const std::string& path) {
+	std::ofstream file(path);
+	if (!file.is_open()) {
+		return false;
+	}
+	WriteChromeTrace(file);
+	return true;
+}
@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include <algorithm>
+#include <cstdlib>
 #include <memory>
 #include <string>
 #include <thread>
@@ -32,6 +33,7 @@ return std::min(b, std::max(what, a));
 // ---------------- Main functions ------------------ //
 
 void PuffinEngine::run() {
+	PUFFIN_PROFILE_THREAD("Main thread"); // workers name themselves once initAllSystems starts the pool
 	if (initAllSystems()) {
 		mainLoop();
 	}
@@ -86,12 +88,61 @@ void PuffinEngine::createWorldClock() {
 }
 
 void PuffinEngine::GatherThreadInfo() {
-	numThreads = std::thread::hardware_concurrency();
-	if (numThreads < 2) {
-		numThreads = 2;
+	// The main thread helps with every stage it waits on, so its core is kept out of the pool.
+	const enginetool::CpuTopology topology = enginetool::CpuTopology::Detect();
+	const int currentCpu = enginetool::GetCurrentCpu();
+	const uint32_t mainCpu = currentCpu >= 0 ? static_cast<uint32_t>(currentCpu) : topology.GetCpus().front().id;
+	numThreads = topology.RecommendedWorkerCount(mainCpu);
+
+	// PUFFIN_WORKER_THREADS=<n> overrides the worker count, PUFFIN_PIN_THREADS=1 pins main thread and workers to their cores
+	if (const char* workerThreads = std::getenv("PUFFIN_WORKER_THREADS")) {
+		const int requested = std::atoi(workerThreads);
+		if (requested > 0) {
+			numThreads = static_cast<uint32_t>(requested);
+		}
 	}
+
+	std::cout << "cpus = " << topology.GetCpus().size() << ", physical cores = " << topology.GetPhysicalCoreCount() << ", L3 domains = " << topology.GetL3DomainCount() << std::endl;
 	std::cout << "numThreads = " << numThreads << std::endl;
-	m_ThreadPool.SetThreadCount(numThreads);		
+	m_ThreadPool.SetThreadCount(numThreads);
+
+	const char* pinThreads = std::getenv("PUFFIN_PIN_THREADS");
+	if (pinThreads && std::string(pinThreads) == "1") {
+		enginetool::PinCurrentThreadToCpu(mainCpu);
+		const uint32_t pinned = m_ThreadPool.PinThreads(topology.PickWorkerCpus(mainCpu, numThreads));
+		std::cout << "pinned main thread to cpu " << mainCpu << " and " << pinned << " workers" << std::endl;
+	}
+}
+
+void PuffinEngine::InitInputCapture() {
+	// PUFFIN_RECORD_INPUT=<file> records every input event with its tick, PUFFIN_REPLAY_INPUT=<file> plays it back at fixed dt
+	if (const char* replayPath = std::getenv("PUFFIN_REPLAY_INPUT")) {
+		if (!m_InputReplay.Load(replayPath)) {
+			std::cerr << "could not load input recording " << replayPath << std::endl;
+			return;
+		}
+
+		const enginetool::InputRecordingHeader& header = m_InputReplay.GetHeader();
+		m_MainClock.fixedTimeValue = header.fixedTimeValue;
+		if (header.width > 0 && header.height > 0 && (header.width != width || header.height != height)) {
+			glfwSetWindowSize(window, header.width, header.height);
+		}
+		std::cout << "replaying " << m_InputReplay.GetEvents().size() << " input events from " << replayPath << std::endl;
+		return;
+	}
+
+	if (const char* recordPath = std::getenv("PUFFIN_RECORD_INPUT")) {
+		enginetool::InputRecordingHeader header;
+		header.fixedTimeValue = m_MainClock.fixedTimeValue;
+		header.width = width;
+		header.height = height;
+		if (m_InputRecorder.Open(recordPath, header)) {
+			std::cout << "recording input to " << recordPath << std::endl;
+		}
+		else {
+			std::cerr << "could not open " << recordPath << " for input recording" << std::endl;
+		}
+	}
 }
 
 void PuffinEngine::CreateImGuiMenu() {
@@ -145,8 +196,13 @@ void PuffinEngine::mainLoop() {
 	double frameTimes[frameHistorySize] = { 0.0 };
 	int frameIndex = 0;
 	int frameSampleCount = 0;
+	InitInputCapture();
+	const double replayStartTime = currentTime;
+	uint64_t replayFrames = 0;
 
 	while (!glfwWindowShouldClose(window)) {
+		PUFFIN_PROFILE_FRAME("Frame");
+		PUFFIN_PROFILE_ZONE("PuffinEngine::mainLoop");
 		double newTime = glfwGetTime();
 		double frameTime = newTime - currentTime;
 		currentTime = newTime;
@@ -155,10 +211,20 @@ void PuffinEngine::mainLoop() {
 		if (frameTime > maxFrameTime)
 			frameTime = maxFrameTime;
 
-		accumulator += frameTime;
+		// A replay takes its ticks from the recorded frames, so the simulation does not depend on how fast frames are presented
+		if (!m_InputReplay.IsActive()) {
+			accumulator += frameTime;
+		}
 
 		glfwPollEvents();
-		glfwGetCursorPos(window, &xpos, &ypos);
+		enginetool::InputEvent replayFrame;
+		if (m_InputReplay.IsActive()) {
+			replayFrame = ReplayInput();
+			replayFrames++;
+		}
+		else {
+			glfwGetCursorPos(window, &xpos, &ypos);
+		}
 		glfwGetFramebufferSize(window, &fb_width, &fb_height);
 		glfwGetWindowSize(window, &width, &height);
 
@@ -183,25 +249,112 @@ void PuffinEngine::mainLoop() {
 		m_MainClock.fps = avgFrameTime > 0.0 ? 1.0 / avgFrameTime : 0.0;
 		m_MainClock.frameTime = frameTime * 1000.0;
 
+		float alpha = 0.0f;
 		if (m_GameStarted) {
-			while (accumulator >= m_MainClock.fixedTimeValue) {
+			uint32_t ticks = 0;
+			auto tick = [this, &ticks]() {
+				ticks++;
 				scene_1.update();
+				m_TickIndex++;
 				m_MainClock.totalElapsedTime += m_MainClock.fixedTimeValue;
-				accumulator -= m_MainClock.fixedTimeValue;
+			};
+
+			if (m_InputReplay.IsActive()) {
+				// Same ticks and same alpha as the recorded frame, so the camera that the next picks cast from matches
+				while (m_TickIndex < replayFrame.tick) {
+					tick();
+				}
+				alpha = replayFrame.alpha;
 			}
+			else {
+				while (accumulator >= m_MainClock.fixedTimeValue) {
+					tick();
+					accumulator -= m_MainClock.fixedTimeValue;
+				}
+				alpha = static_cast<float>(accumulator / m_MainClock.fixedTimeValue);
+			}
+			PUFFIN_PROFILE_COUNTER("Ticks per frame", ticks);
+
+			// Uniform buffers and command buffers are built once per presented frame, between the last two ticks
+			scene_1.PrepareFrame(alpha);
 		}
 		else {
 			accumulator = 0.0;
 		}
+		RecordFrame(alpha);
 
 		UpdateGui();
 		DrawFrame();
+
+		// Transient per-frame allocations of every thread are released here, the pool is idle between frames
+		enginetool::NextFrame();
 	}
 
 	vkDeviceWaitIdle(m_Device.get());
+	if (m_InputReplay.IsActive()) {
+		const double replayTime = glfwGetTime() - replayStartTime;
+		std::cout << "replayed " << m_TickIndex << " ticks in " << replayFrames << " frames, " << replayTime << " s, "
+			<< (replayFrames > 0 ? replayTime * 1000.0 / replayFrames : 0.0) << " ms per frame" << std::endl;
+	}
+	PUFFIN_PROFILE_DUMP("puffinTrace.json");
+}
+
+enginetool::InputEvent PuffinEngine::ReplayInput() {
+	enginetool::InputEvent frame;
+	frame.tick = m_TickIndex;
+	m_InputReplay.NextFrame(m_ReplayEvents, frame);
+	for (const enginetool::InputEvent& event : m_ReplayEvents) {
+		switch (event.type) {
+		case enginetool::InputEventType::Key:
+			OnKey(event.code, event.action);
+			break;
+		case enginetool::InputEventType::MouseButton:
+			OnMouseButton(event.code, event.action);
+			break;
+		case enginetool::InputEventType::CursorPosition:
+			OnCursorPosition(event.x, event.y);
+			break;
+		case enginetool::InputEventType::End:
+		case enginetool::InputEventType::Frame:
+			break;
+		}
+	}
+
+	if (m_InputReplay.IsFinished()) {
+		glfwSetWindowShouldClose(window, GLFW_TRUE);
+	}
+	return frame;
+}
+
+void PuffinEngine::RecordInput(enginetool::InputEventType type, int code, int action, double x, double y) {
+	if (!m_InputRecorder.IsRecording()) {
+		return;
+	}
+
+	enginetool::InputEvent event;
+	event.type = type;
+	event.tick = m_TickIndex;
+	event.code = code;
+	event.action = action;
+	event.x = x;
+	event.y = y;
+	m_InputRecorder.Record(event);
+}
+
+void PuffinEngine::RecordFrame(float alpha) {
+	if (!m_InputRecorder.IsRecording()) {
+		return;
+	}
+
+	enginetool::InputEvent frame;
+	frame.type = enginetool::InputEventType::Frame;
+	frame.tick = m_TickIndex;
+	frame.alpha = alpha;
+	m_InputRecorder.Record(frame);
 }
 
 void PuffinEngine::UpdateGui(){
+	PUFFIN_PROFILE_ZONE("PuffinEngine::UpdateGui");
 	if (m_GameStarted) {
 		m_GUIMainHub.setPlayerHealth(
 			scene_1.GetMainCharacterHealthRatio(),
@@ -223,6 +376,7 @@ void PuffinEngine::CreateSemaphores() {
 }
 
 void PuffinEngine::DrawFrame() {
+	PUFFIN_PROFILE_ZONE("PuffinEngine::DrawFrame");
 	uint32_t imageIndex;
 	VkResult result = vkAcquireNextImageKHR(m_Device.get(), m_SwapChain.get(), std::numeric_limits<uint64_t>::max(), imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
 
@@ -402,10 +556,20 @@ void PuffinEngine::CharacterCallback(GLFWwindow* window, unsigned int codepoint)
 
 void PuffinEngine::CursorPositionCallback(GLFWwindow* window, double xpos, double ypos) {
 	PuffinEngine* app = reinterpret_cast<PuffinEngine*>(glfwGetWindowUserPointer(window));
-	app->scene_1.currentCamera->MouseMove(xpos, ypos, app->width, app->height, 0.005f);
-	app->m_MousePicker.CalculateNormalisedDeviceCoordinates(xpos, ypos);
+	if (app->m_InputReplay.IsActive()) {
+		return;
+	}
+	app->RecordInput(enginetool::InputEventType::CursorPosition, 0, 0, xpos, ypos);
+	app->OnCursorPosition(xpos, ypos);
+}
+
+void PuffinEngine::OnCursorPosition(double x, double y) {
+	xpos = x;
+	ypos = y;
+	scene_1.currentCamera->MouseMove(x, y, width, height, 0.005f);
+	m_MousePicker.CalculateNormalisedDeviceCoordinates(x, y);
 	ImGuiIO& io = ImGui::GetIO();
-	io.MousePos = ImVec2((float)xpos, (float)ypos);
+	io.MousePos = ImVec2((float)x, (float)y);
 }
 
 
@@ -419,7 +583,16 @@ void PuffinEngine::FramebufferSizeCallback(GLFWwindow* window, int width, int he
 
 void PuffinEngine::KeyCallback(GLFWwindow* window, int key, int scancode, int event, int mods) {
 	PuffinEngine* app = reinterpret_cast<PuffinEngine*>(glfwGetWindowUserPointer(window));
-	app->PressKey(key);
+	(void)mods; // Modifiers are not reliable across systems
+	if (app->m_InputReplay.IsActive()) {
+		return;
+	}
+	app->RecordInput(enginetool::InputEventType::Key, key, event, 0.0, 0.0);
+	app->OnKey(key, event);
+}
+
+void PuffinEngine::OnKey(int key, int event) {
+	PressKey(key, event);
 	
 	ImGuiIO& io = ImGui::GetIO();
 	if (event == GLFW_PRESS)
@@ -427,7 +600,6 @@ void PuffinEngine::KeyCallback(GLFWwindow* window, int key, int scancode, int ev
 	if (event == GLFW_RELEASE)
 		io.KeysDown[key] = false;
 
-	(void)mods; // Modifiers are not reliable across systems
 	io.KeyCtrl = io.KeysDown[GLFW_KEY_LEFT_CONTROL] || io.KeysDown[GLFW_KEY_RIGHT_CONTROL];
 	io.KeyShift = io.KeysDown[GLFW_KEY_LEFT_SHIFT] || io.KeysDown[GLFW_KEY_RIGHT_SHIFT];
 	io.KeyAlt = io.KeysDown[GLFW_KEY_LEFT_ALT] || io.KeysDown[GLFW_KEY_RIGHT_ALT];
@@ -436,36 +608,42 @@ void PuffinEngine::KeyCallback(GLFWwindow* window, int key, int scancode, int ev
 
 void PuffinEngine::MouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
 	PuffinEngine* app = reinterpret_cast<PuffinEngine*>(glfwGetWindowUserPointer(window));
-	ImGuiIO& io = ImGui::GetIO();
+	if (app->m_InputReplay.IsActive()) {
+		return;
+	}
+	app->RecordInput(enginetool::InputEventType::MouseButton, button, action, 0.0, 0.0);
+	app->OnMouseButton(button, action);
+}
 
-	if (!app->m_GameStarted && button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS) {
-		const double startX1 = app->width * 0.5 - 90.0;
-		const double startX2 = app->width * 0.5 + 90.0;
-		const double startY1 = app->height * 0.5 - 45.0;
-		const double startY2 = app->height * 0.5 + 5.0;
-		const double quitY1 = app->height * 0.5 + 10.0;
-		const double quitY2 = app->height * 0.5 + 60.0;
+void PuffinEngine::OnMouseButton(int button, int action) {
+	if (!m_GameStarted && button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS) {
+		const double startX1 = width * 0.5 - 90.0;
+		const double startX2 = width * 0.5 + 90.0;
+		const double startY1 = height * 0.5 - 45.0;
+		const double startY2 = height * 0.5 + 5.0;
+		const double quitY1 = height * 0.5 + 10.0;
+		const double quitY2 = height * 0.5 + 60.0;
 
-		if (app->xpos >= startX1 && app->xpos <= startX2 && app->ypos >= startY1 && app->ypos <= startY2) {
-			app->StartGame();
+		if (xpos >= startX1 && xpos <= startX2 && ypos >= startY1 && ypos <= startY2) {
+			StartGame();
 			return;
 		}
 
-		if (app->xpos >= startX1 && app->xpos <= startX2 && app->ypos >= quitY1 && app->ypos <= quitY2) {
+		if (xpos >= startX1 && xpos <= startX2 && ypos >= quitY1 && ypos <= quitY2) {
 			glfwSetWindowShouldClose(window, GLFW_TRUE);
 			return;
 		}
 	}
 
-	if (app->m_GameStarted && button == GLFW_MOUSE_BUTTON_RIGHT && action == GLFW_PRESS) {
-		app->scene_1.DeSelect();
+	if (m_GameStarted && button == GLFW_MOUSE_BUTTON_RIGHT && action == GLFW_PRESS) {
+		scene_1.DeSelect();
 #if DEBUG_VERSION
 		std::cout << "You clicked right mouse button" << std::endl;
 #endif
 	}
 	
-	if (app->m_GameStarted && button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS) {
-		app->scene_1.HandleMouseClick();
+	if (m_GameStarted && button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS) {
+		scene_1.HandleMouseClick();
 #if DEBUG_VERSION
 		std::cout << "You clicked left mouse button" << std::endl;
 #endif
@@ -570,17 +748,16 @@ bool PuffinEngine::initDefaultKeysBindings(std::map<int, FuncPair>& functions )
 	return true;
 }
 
-void PuffinEngine::PressKey(int key) {
+void PuffinEngine::PressKey(int key, int action) {
 	if (!m_GameStarted) {
 		return;
 	}
 
-	int state = glfwGetKey(window, key);
-		
+	// The action comes with the event instead of glfwGetKey, so a replayed key behaves like the recorded one
 	if (functions.count(key)) {
-		if (state == GLFW_PRESS) 
+		if (action == GLFW_PRESS || action == GLFW_REPEAT) 
 			functions[key].first(&scene_1);
-		if (state == GLFW_RELEASE && functions[key].second!=nullptr)  
+		if (action == GLFW_RELEASE && functions[key].second!=nullptr)  
 			functions[key].second(&scene_1);
 	}
 }
@@ -667,6 +844,7 @@ void PuffinEngine::cleanUp() {
 	DestroyMaterialLibrary();
 	DestroyGUI();
 	deinitWorldClock();
+	DeInitInputCapture();
 
 	if (m_ScreenRenderPass.m_Initialized) {
 		m_ScreenRenderPass.deInit();
@@ -698,6 +876,10 @@ void PuffinEngine::deinitWorldClock() {
 	//
 }
 
+void PuffinEngine::DeInitInputCapture() {
+	m_InputRecorder.Close(m_TickIndex);
+}
+
 void PuffinEngine::DestroyMaterialLibrary() {
 	m_MaterialLibrary.DeInit();
 }
@@ -0,0 +1,365 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "headers/RayKernels.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PUFFIN_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PUFFIN_TARGET(isa) __attribute__((target(isa)))
+#else
+#define PUFFIN_TARGET(isa)
+#endif
+
+using namespace enginetool;
+
+namespace {
+	const float missed = std::numeric_limits<float>::infinity();
+
+	BoxArrays Offset(const BoxArrays& boxes, size_t first) {
+		BoxArrays rest;
+		for (int axis = 0; axis < 3; axis++) {
+			rest.min[axis] = boxes.min[axis] + first;
+			rest.max[axis] = boxes.max[axis] + first;
+		}
+		return rest;
+	}
+
+	RayArrays Offset(const RayArrays& rays, size_t first) {
+		RayArrays rest;
+		for (int axis = 0; axis < 3; axis++) {
+			rest.origin[axis] = rays.origin[axis] + first;
+			rest.dirFrac[axis] = rays.dirFrac[axis] + first;
+		}
+		return rest;
+	}
+
+	// ScenePart::RayIntersection, reduced to the distance
+	inline float Slab(const float* origin, const float* dirFrac, const float* min, const float* max) {
+		const float t1 = (min[0] - origin[0]) * dirFrac[0];
+		const float t2 = (max[0] - origin[0]) * dirFrac[0];
+		const float t3 = (min[1] - origin[1]) * dirFrac[1];
+		const float t4 = (max[1] - origin[1]) * dirFrac[1];
+		const float t5 = (min[2] - origin[2]) * dirFrac[2];
+		const float t6 = (max[2] - origin[2]) * dirFrac[2];
+
+		const float tmin = std::max(std::max(std::min(t1, t2), std::min(t3, t4)), std::min(t5, t6));
+		const float tmax = std::min(std::min(std::max(t1, t2), std::max(t3, t4)), std::max(t5, t6));
+		if (tmax < 0 || tmin > tmax) {
+			return missed;
+		}
+		return tmin;
+	}
+
+	inline float SlabBox(const float* origin, const float* dirFrac, const BoxArrays& boxes, size_t i) {
+		const float min[3] = { boxes.min[0][i], boxes.min[1][i], boxes.min[2][i] };
+		const float max[3] = { boxes.max[0][i], boxes.max[1][i], boxes.max[2][i] };
+		return Slab(origin, dirFrac, min, max);
+	}
+
+	void IntersectRayBoxesScalar(const float* origin, const float* dirFrac, const BoxArrays& boxes, size_t count, float* distances) {
+		for (size_t i = 0; i < count; i++) {
+			distances[i] = SlabBox(origin, dirFrac, boxes, i);
+		}
+	}
+
+	size_t NearestRayBoxScalar(const float* origin, const float* dirFrac, const BoxArrays& boxes, size_t count, float maxDistance, float& distance) {
+		size_t nearest = count;
+		float nearestDistance = maxDistance;
+		for (size_t i = 0; i < count; i++) {
+			const float t = SlabBox(origin, dirFrac, boxes, i);
+			if (t <= maxDistance && (nearest == count || t < nearestDistance)) {
+				nearest = i;
+				nearestDistance = t;
+			}
+		}
+		if (nearest != count) {
+			distance = nearestDistance;
+		}
+		return nearest;
+	}
+
+	void IntersectRaysBoxScalar(const RayArrays& rays, size_t count, const float* min, const float* max, float* distances) {
+		for (size_t i = 0; i < count; i++) {
+			const float origin[3] = { rays.origin[0][i], rays.origin[1][i], rays.origin[2][i] };
+			const float dirFrac[3] = { rays.dirFrac[0][i], rays.dirFrac[1][i], rays.dirFrac[2][i] };
+			distances[i] = Slab(origin, dirFrac, min, max);
+		}
+	}
+
+	// Vector paths finish the last few boxes with the next narrower path, whose hit only wins when strictly nearer,
+	// as its boxes all come after the ones already searched
+	size_t KeepNearer(size_t nearest, float& distance, size_t tailNearest, float tailDistance, size_t tailFirst, size_t count) {
+		if (tailNearest + tailFirst != count && (nearest == count || tailDistance < distance)) {
+			distance = tailDistance;
+			return tailFirst + tailNearest;
+		}
+		return nearest;
+	}
+
+#if PUFFIN_SIMD_X86
+	// Four lanes of Slab. std::min(a, b) is _mm_min_ps(b, a) and std::max likewise, so NaNs come out of the same operand.
+	PUFFIN_TARGET("sse2")
+	inline __m128 SlabSSE2(const __m128* origin, const __m128* dirFrac, const __m128* min, const __m128* max) {
+		__m128 tmin = _mm_setzero_ps();
+		__m128 tmax = _mm_setzero_ps();
+		for (int axis = 0; axis < 3; axis++) {
+			const __m128 t1 = _mm_mul_ps(_mm_sub_ps(min[axis], origin[axis]), dirFrac[axis]);
+			const __m128 t2 = _mm_mul_ps(_mm_sub_ps(max[axis], origin[axis]), dirFrac[axis]);
+			const __m128 enter = _mm_min_ps(t2, t1);
+			const __m128 leave = _mm_max_ps(t2, t1);
+			tmin = (axis == 0) ? enter : _mm_max_ps(enter, tmin);
+			tmax = (axis == 0) ? leave : _mm_min_ps(leave, tmax);
+		}
+		const __m128 miss = _mm_or_ps(_mm_cmplt_ps(tmax, _mm_setzero_ps()), _mm_cmpgt_ps(tmin, tmax));
+		return _mm_or_ps(_mm_and_ps(miss, _mm_set1_ps(missed)), _mm_andnot_ps(miss, tmin));
+	}
+
+	PUFFIN_TARGET("sse2")
+	void LoadBoxesSSE2(const BoxArrays& boxes, size_t i, __m128* min, __m128* max) {
+		for (int axis = 0; axis < 3; axis++) {
+			min[axis] = _mm_loadu_ps(boxes.min[axis] + i);
+			max[axis] = _mm_loadu_ps(boxes.max[axis] + i);
+		}
+	}
+
+	PUFFIN_TARGET("sse2")
+	void IntersectRayBoxesSSE2(const float* origin, const float* dirFrac, const BoxArrays& boxes, size_t count, float* distances) {
+		const __m128 rayOrigin[3] = { _mm_set1_ps(origin[0]), _mm_set1_ps(origin[1]), _mm_set1_ps(origin[2]) };
+		const __m128 rayDirFrac[3] = { _mm_set1_ps(dirFrac[0]), _mm_set1_ps(dirFrac[1]), _mm_set1_ps(dirFrac[2]) };
+
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4) {
+			__m128 min[3], max[3];
+			LoadBoxesSSE2(boxes, i, min, max);
+			_mm_storeu_ps(distances + i, SlabSSE2(rayOrigin, rayDirFrac, min, max));
+		}
+
+		IntersectRayBoxesScalar(origin, dirFrac, Offset(boxes, i), count - i, distances + i);
+	}
+
+	// Every lane keeps its own nearest box, the lanes are merged once at the end
+	PUFFIN_TARGET("sse2")
+	size_t NearestRayBoxSSE2(const float* origin, const float* dirFrac, const BoxArrays& boxes, size_t count, float maxDistance, float& distance) {
+		const __m128 rayOrigin[3] = { _mm_set1_ps(origin[0]), _mm_set1_ps(origin[1]), _mm_set1_ps(origin[2]) };
+		const __m128 rayDirFrac[3] = { _mm_set1_ps(dirFrac[0]), _mm_set1_ps(dirFrac[1]), _mm_set1_ps(dirFrac[2]) };
+		// Strictly below the next float up is the same as at most maxDistance
+		__m128 best = _mm_set1_ps(std::nextafter(maxDistance, missed));
+		__m128i bestIndex = _mm_set1_epi32(-1);
+		__m128i index = _mm_setr_epi32(0, 1, 2, 3);
+
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4) {
+			__m128 min[3], max[3];
+			LoadBoxesSSE2(boxes, i, min, max);
+			const __m128 t = SlabSSE2(rayOrigin, rayDirFrac, min, max);
+			const __m128 closer = _mm_cmplt_ps(t, best);
+			best = _mm_or_ps(_mm_and_ps(closer, t), _mm_andnot_ps(closer, best));
+			const __m128i closerIndex = _mm_castps_si128(closer);
+			bestIndex = _mm_or_si128(_mm_and_si128(closerIndex, index), _mm_andnot_si128(closerIndex, bestIndex));
+			index = _mm_add_epi32(index, _mm_set1_epi32(4));
+		}
+
+		float lanes[4];
+		int32_t laneIndices[4];
+		_mm_storeu_ps(lanes, best);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(laneIndices), bestIndex);
+		size_t nearest = count;
+		for (int lane = 0; lane < 4; lane++) {
+			if (laneIndices[lane] < 0) continue;
+			const size_t laneNearest = static_cast<size_t>(laneIndices[lane]);
+			if (nearest == count || lanes[lane] < distance || (lanes[lane] == distance && laneNearest < nearest)) {
+				nearest = laneNearest;
+				distance = lanes[lane];
+			}
+		}
+
+		float tailDistance = 0.0f;
+		const size_t tailNearest = NearestRayBoxScalar(origin, dirFrac, Offset(boxes, i), count - i, maxDistance, tailDistance);
+		return KeepNearer(nearest, distance, tailNearest, tailDistance, i, count);
+	}
+
+	PUFFIN_TARGET("sse2")
+	void IntersectRaysBoxSSE2(const RayArrays& rays, size_t count, const float* min, const float* max, float* distances) {
+		const __m128 boxMin[3] = { _mm_set1_ps(min[0]), _mm_set1_ps(min[1]), _mm_set1_ps(min[2]) };
+		const __m128 boxMax[3] = { _mm_set1_ps(max[0]), _mm_set1_ps(max[1]), _mm_set1_ps(max[2]) };
+
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4) {
+			__m128 origin[3], dirFrac[3];
+			for (int axis = 0; axis < 3; axis++) {
+				origin[axis] = _mm_loadu_ps(rays.origin[axis] + i);
+				dirFrac[axis] = _mm_loadu_ps(rays.dirFrac[axis] + i);
+			}
+			_mm_storeu_ps(distances + i, SlabSSE2(origin, dirFrac, boxMin, boxMax));
+		}
+
+		IntersectRaysBoxScalar(Offset(rays, i), count - i, min, max, distances + i);
+	}
+
+	// Eight lanes of Slab, same operand order as the SSE2 path. No FMA, it would round differently from the scalar path.
+	PUFFIN_TARGET("avx2")
+	inline __m256 SlabAVX2(const __m256* origin, const __m256* dirFrac, const __m256* min, const __m256* max) {
+		__m256 tmin = _mm256_setzero_ps();
+		__m256 tmax = _mm256_setzero_ps();
+		for (int axis = 0; axis < 3; axis++) {
+			const __m256 t1 = _mm256_mul_ps(_mm256_sub_ps(min[axis], origin[axis]), dirFrac[axis]);
+			const __m256 t2 = _mm256_mul_ps(_mm256_sub_ps(max[axis], origin[axis]), dirFrac[axis]);
+			const __m256 enter = _mm256_min_ps(t2, t1);
+			const __m256 leave = _mm256_max_ps(t2, t1);
+			tmin = (axis == 0) ? enter : _mm256_max_ps(enter, tmin);
+			tmax = (axis == 0) ? leave : _mm256_min_ps(leave, tmax);
+		}
+		const __m256 miss = _mm256_or_ps(_mm256_cmp_ps(tmax, _mm256_setzero_ps(), _CMP_LT_OQ), _mm256_cmp_ps(tmin, tmax, _CMP_GT_OQ));
+		return _mm256_blendv_ps(tmin, _mm256_set1_ps(missed), miss);
+	}
+
+	PUFFIN_TARGET("avx2")
+	void LoadBoxesAVX2(const BoxArrays& boxes, size_t i, __m256* min, __m256* max) {
+		for (int axis = 0; axis < 3; axis++) {
+			min[axis] = _mm256_loadu_ps(boxes.min[axis] + i);
+			max[axis] = _mm256_loadu_ps(boxes.max[axis] + i);
+		}
+	}
+
+	PUFFIN_TARGET("avx2")
+	void IntersectRayBoxesAVX2(const float* origin, const float* dirFrac, const BoxArrays& boxes, size_t count, float* distances) {
+		const __m256 rayOrigin[3] = { _mm256_set1_ps(origin[0]), _mm256_set1_ps(origin[1]), _mm256_set1_ps(origin[2]) };
+		const __m256 rayDirFrac[3] = { _mm256_set1_ps(dirFrac[0]), _mm256_set1_ps(dirFrac[1]), _mm256_set1_ps(dirFrac[2]) };
+
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8) {
+			__m256 min[3], max[3];
+			LoadBoxesAVX2(boxes, i, min, max);
+			_mm256_storeu_ps(distances + i, SlabAVX2(rayOrigin, rayDirFrac, min, max));
+		}
+
+		IntersectRayBoxesSSE2(origin, dirFrac, Offset(boxes, i), count - i, distances + i);
+	}
+
+	PUFFIN_TARGET("avx2")
+	size_t NearestRayBoxAVX2(const float* origin, const float* dirFrac, const BoxArrays& boxes, size_t count, float maxDistance, float& distance) {
+		const __m256 rayOrigin[3] = { _mm256_set1_ps(origin[0]), _mm256_set1_ps(origin[1]), _mm256_set1_ps(origin[2]) };
+		const __m256 rayDirFrac[3] = { _mm256_set1_ps(dirFrac[0]), _mm256_set1_ps(dirFrac[1]), _mm256_set1_ps(dirFrac[2]) };
+		__m256 best = _mm256_set1_ps(std::nextafter(maxDistance, missed));
+		__m256i bestIndex = _mm256_set1_epi32(-1);
+		__m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8) {
+			__m256 min[3], max[3];
+			LoadBoxesAVX2(boxes, i, min, max);
+			const __m256 t = SlabAVX2(rayOrigin, rayDirFrac, min, max);
+			const __m256 closer = _mm256_cmp_ps(t, best, _CMP_LT_OQ);
+			best = _mm256_blendv_ps(best, t, closer);
+			bestIndex = _mm256_blendv_epi8(bestIndex, index, _mm256_castps_si256(closer));
+			index = _mm256_add_epi32(index, _mm256_set1_epi32(8));
+		}
+
+		float lanes[8];
+		int32_t laneIndices[8];
+		_mm256_storeu_ps(lanes, best);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(laneIndices), bestIndex);
+		size_t nearest = count;
+		for (int lane = 0; lane < 8; lane++) {
+			if (laneIndices[lane] < 0) continue;
+			const size_t laneNearest = static_cast<size_t>(laneIndices[lane]);
+			if (nearest == count || lanes[lane] < distance || (lanes[lane] == distance && laneNearest < nearest)) {
+				nearest = laneNearest;
+				distance = lanes[lane];
+			}
+		}
+
+		float tailDistance = 0.0f;
+		const size_t tailNearest = NearestRayBoxSSE2(origin, dirFrac, Offset(boxes, i), count - i, maxDistance, tailDistance);
+		return KeepNearer(nearest, distance, tailNearest, tailDistance, i, count);
+	}
+
+	PUFFIN_TARGET("avx2")
+	void IntersectRaysBoxAVX2(const RayArrays& rays, size_t count, const float* min, const float* max, float* distances) {
+		const __m256 boxMin[3] = { _mm256_set1_ps(min[0]), _mm256_set1_ps(min[1]), _mm256_set1_ps(min[2]) };
+		const __m256 boxMax[3] = { _mm256_set1_ps(max[0]), _mm256_set1_ps(max[1]), _mm256_set1_ps(max[2]) };
+
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8) {
+			__m256 origin[3], dirFrac[3];
+			for (int axis = 0; axis < 3; axis++) {
+				origin[axis] = _mm256_loadu_ps(rays.origin[axis] + i);
+				dirFrac[axis] = _mm256_loadu_ps(rays.dirFrac[axis] + i);
+			}
+			_mm256_storeu_ps(distances + i, SlabAVX2(origin, dirFrac, boxMin, boxMax));
+		}
+
+		IntersectRaysBoxSSE2(Offset(rays, i), count - i, min, max, distances + i);
+	}
+#endif
+
+	SimdLevel Clamp(SimdLevel level) {
+		return (static_cast<int>(level) > static_cast<int>(GetSupportedSimdLevel())) ? GetSupportedSimdLevel() : level;
+	}
+}
+
+// ---------------- Main functions ------------------ //
+
+void enginetool::IntersectRayBoxes(const float* origin, const float* dirFrac, const BoxArrays& boxes, size_t count, float* distances) {
+	IntersectRayBoxes(GetSimdLevel(), origin, dirFrac, boxes, count, distances);
+}
+
+void enginetool::IntersectRayBoxes(SimdLevel level, const float* origin, const float* dirFrac, const BoxArrays& boxes, size_t count, float* distances) {
+	switch (Clamp(level)) {
+#if PUFFIN_SIMD_X86
+	case SimdLevel::AVX2:
+		IntersectRayBoxesAVX2(origin, dirFrac, boxes, count, distances);
+		return;
+	case SimdLevel::SSE2:
+		IntersectRayBoxesSSE2(origin, dirFrac, boxes, count, distances);
+		return;
+#endif
+	default:
+		IntersectRayBoxesScalar(origin, dirFrac, boxes, count, distances);
+		return;
+	}
+}
+
+size_t enginetool::NearestRayBox(const float* origin, const float* dirFrac, const BoxArrays& boxes, size_t count, float maxDistance, float& distance) {
+	return NearestRayBox(GetSimdLevel(), origin, dirFrac, boxes, count, maxDistance, distance);
+}
+
+size_t enginetool::NearestRayBox(SimdLevel level, const float* origin, const float* dirFrac, const BoxArrays& boxes, size_t count, float maxDistance, float& distance) {
+	maxDistance = std::min(maxDistance, std::numeric_limits<float>::max()); // misses are at infinity
+	switch (Clamp(level)) {
+#if PUFFIN_SIMD_X86
+	case SimdLevel::AVX2:
+		return NearestRayBoxAVX2(origin, dirFrac, boxes, count, maxDistance, distance);
+	case SimdLevel::SSE2:
+		return NearestRayBoxSSE2(origin, dirFrac, boxes, count, maxDistance, distance);
+#endif
+	default:
+		return NearestRayBoxScalar(origin, dirFrac, boxes, count, maxDistance, distance);
+	}
+}
+
+void enginetool::IntersectRaysBox(const RayArrays& rays, size_t count, const float* min, const float* max, float* distances) {
+	IntersectRaysBox(GetSimdLevel(), rays, count, min, max, distances);
+}
+
+void enginetool::IntersectRaysBox(SimdLevel level, const RayArrays& rays, size_t count, const float* min, const float* max, float* distances) {
+	switch (Clamp(level)) {
+#if PUFFIN_SIMD_X86
+	case SimdLevel::AVX2:
+		IntersectRaysBoxAVX2(rays, count, min, max, distances);
+		return;
+	case SimdLevel::SSE2:
+		IntersectRaysBoxSSE2(rays, count, min, max, distances);
+		return;
+#endif
+	default:
+		IntersectRaysBoxScalar(rays, count, min, max, distances);
+		return;
+	}
+}
\ No newline at end of file
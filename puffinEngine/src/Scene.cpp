@@ -1,7 +1,11 @@
 #include <algorithm> // "max" and "min" in VkExtent2D
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <map>
 #include <random>
+#include <unordered_map>
 #include <filesystem>
 
 #include "LoadFile.cpp"
@@ -35,6 +39,7 @@ using namespace puffinengine::tool;
 //[[--------------- Constructors and dectructors ---------------]]
 
 Scene::Scene() {
+	world = { &broadphase, &restingBroadphase, &rayTree, &groundTree, &heightfield };
 #if DEBUG_VERSION
 	std::cout << "Scene object created\n";
 #endif 
@@ -109,23 +114,19 @@ void Scene::init(GLFWwindow* window, Device* device, SwapChain* swapChain, Rende
 	CreateCommandBuffers();
 	CreateReflectionCommandBuffer();
 	CreateRefractionCommandBuffer();
+	BuildSimulationTaskGraph();
+	BuildFrameTaskGraph();
 }
 
 void Scene::update() {
-	UpdatePositions();
-
-	std::vector<std::function<void()>> stageOne = {task1, task3, task4, task5, task6, task7, task8, task9, task10};
-	ProcesTasksMultithreaded(threadPool, stageOne);
+	PUFFIN_PROFILE_ZONE("Scene::update");
+	simulationTaskGraph.Run(threadPool);
+}
 
-#if DEBUG_VERSION
-	CreateCommandBuffers();
-	CreateReflectionCommandBuffer();
-	CreateRefractionCommandBuffer();
-#else
-	CreateCommandBuffers();
-	CreateReflectionCommandBuffer();
-	CreateRefractionCommandBuffer();
-#endif 
+void Scene::PrepareFrame(float alpha) {
+	PUFFIN_PROFILE_ZONE("Scene::PrepareFrame");
+	interpolationAlpha = alpha;
+	frameTaskGraph.Run(threadPool);
 }
 
 void Scene::cleanUpForSwapchain() {
@@ -303,9 +304,9 @@ void Scene::CreateGraphicsPipeline() {
 	VkPipelineViewportStateCreateInfo ViewportState = {};
 	ViewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
 	ViewportState.viewportCount = 1;
-	ViewportState.pViewports = &viewport;
+	ViewportState.pViewports = nullptr; // dynamic, set while recording
 	ViewportState.scissorCount = 1;
-	ViewportState.pScissors = &scissor;
+	ViewportState.pScissors = nullptr;
 
 	VkPipelineMultisampleStateCreateInfo Multisample = {}; // configures multisampling, is one of the ways to perform anti-aliasing
 	Multisample.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
@@ -644,25 +645,38 @@ void Scene::CreateGraphicsPipeline() {
 	vkDestroyShaderModule(m_Device->get(), vertCloudsShaderModule, nullptr);
 }
 
-void Scene::ProcesTasksMultithreaded(enginetool::ThreadPool* threadPool, std::vector<std::function<void()>>& tasks){
-	if (!threadPool || threadPool->threads.empty()) {
-		while (!tasks.empty()) {
-			tasks.back()();
-			tasks.pop_back();
-		}
-		return;
-	}
+void Scene::BuildSimulationTaskGraph() {
+	simulationTaskGraph.Clear();
+	simulationTaskGraph.AddTask("UpdatePositions", std::bind(&Scene::UpdatePositions, this), {}, {"actors", "cameras", "mainCharacter"});
 
-	while(!tasks.empty()){
-		size_t i = 0;		
-		while (i < threadPool->threads.size() && !tasks.empty()) {
-			threadPool->threads[i]->AddJob(tasks.back());
-			tasks.pop_back();
-			++i;
-		}		
-	}
+#if DEBUG_VERSION
+	std::ofstream graphFile("simulationTaskGraph.dot");
+	simulationTaskGraph.DumpGraphviz(graphFile);
+#endif
+}
+
+void Scene::BuildFrameTaskGraph() {
+	frameTaskGraph.Clear();
+	frameTaskGraph.AddTask("InterpolateTransforms", std::bind(&Scene::InterpolateTransforms, this), {"actors", "cameras", "mainCharacter"}, {"renderTransforms"});
+	frameTaskGraph.AddTask("UpdateSkyboxUniformBuffer", std::bind(&Scene::UpdateSkyboxUniformBuffer, this), {"renderTransforms"}, {"uboSkybox"});
+	frameTaskGraph.AddTask("UpdateUniformBufferParameters", std::bind(&Scene::UpdateUniformBufferParameters, this), {"renderTransforms"}, {"uboParameters"});
+	frameTaskGraph.AddTask("UpdateStaticUniformBuffer", std::bind(&Scene::UpdateStaticUniformBuffer, this), {"renderTransforms"}, {"uboStatic", "mousePicker"});
+	// Culls with the camera matrices UpdateStaticUniformBuffer just wrote
+	frameTaskGraph.AddTask("CheckActorsVisibility", std::bind(&Scene::CheckActorsVisibility, this), {"uboStatic"}, {"visibility"});
+	frameTaskGraph.AddTask("UpdateSelectionIndicatorUniformBuffer", std::bind(&Scene::UpdateSelectionIndicatorUniformBuffer, this), {"renderTransforms"}, {"uboSelectionIndicator"});
+	frameTaskGraph.AddTask("UpdateOffscreenUniformBuffer", std::bind(&Scene::UpdateOffscreenUniformBuffer, this), {"renderTransforms"}, {"uboOffscreen"});
+	frameTaskGraph.AddTask("UpdateDynamicUniformBuffer", std::bind(&Scene::UpdateDynamicUniformBuffer, this), {"mainCharacter"}, {"uboDynamic"});
+	frameTaskGraph.AddTask("UpdateOceanUniformBuffer", std::bind(&Scene::UpdateOceanUniformBuffer, this), {"renderTransforms"}, {"uboOcean"});
+	frameTaskGraph.AddTask("UpdateCloudsUniformBuffer", std::bind(&Scene::UpdateCloudsUniformBuffer, this), {"renderTransforms"}, {"uboClouds"});
+	// Recording only references the uniform buffers, it does not read their contents, and each pass has its own command pool.
+	frameTaskGraph.AddTask("CreateCommandBuffers", std::bind(&Scene::CreateCommandBuffers, this), {"renderTransforms", "visibility", "mousePicker"}, {"commandBuffers", "selectRay"});
+	frameTaskGraph.AddTask("CreateReflectionCommandBuffer", std::bind(&Scene::CreateReflectionCommandBuffer, this), {"renderTransforms", "visibility"}, {"reflectionCommandBuffer"});
+	frameTaskGraph.AddTask("CreateRefractionCommandBuffer", std::bind(&Scene::CreateRefractionCommandBuffer, this), {"renderTransforms", "visibility"}, {"refractionCommandBuffer"});
 
-	threadPool->Hold();
+#if DEBUG_VERSION
+	std::ofstream graphFile("frameTaskGraph.dot");
+	frameTaskGraph.DumpGraphviz(graphFile);
+#endif
 }
 
 void Scene::CreateCommandBuffers() {
@@ -671,6 +685,13 @@ void Scene::CreateCommandBuffers() {
 		commandBuffers.clear();
 	}
 
+	// Resolved once for every swapchain image; a destroyed skybox, sea or selected actor draws nothing
+	const Skybox* skybox = actorHandles.Get(skyboxHandle);
+	const Sea* sea = actorHandles.Get(seaHandle);
+	const uint32_t skyboxIndexCount = skybox ? static_cast<uint32_t>(skybox->indices.size()) : 0;
+	const uint32_t seaIndexCount = sea ? static_cast<uint32_t>(sea->indices.size()) : 0;
+	Actor* selected = actorHandles.Get(selectedActor);
+
 	VkCommandBufferBeginInfo beginInfo = {};
 	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
@@ -705,25 +726,27 @@ void Scene::CreateCommandBuffers() {
 		vkBeginCommandBuffer(commandBuffers[i], &beginInfo);
 		vkCmdBeginRenderPass(commandBuffers[i], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
 		
-		viewport.x = 0.0f;
-		viewport.y = 0.0f;
-		viewport.width = (float)p_SwapChain->getExtent().width;
-		viewport.height = (float)p_SwapChain->getExtent().height;
-		viewport.minDepth = 0.0f;
-		viewport.maxDepth = 1.0f;
-		vkCmdSetViewport(commandBuffers[i], 0, 1, &viewport);
-
-		scissor.offset = { 0, 0 }; // scissor rectangle covers framebuffer entirely
-		scissor.extent = p_SwapChain->getExtent();
-		vkCmdSetScissor(commandBuffers[i], 0, 1, &scissor);
+		VkViewport cmdViewport = {};
+		cmdViewport.x = 0.0f;
+		cmdViewport.y = 0.0f;
+		cmdViewport.width = (float)p_SwapChain->getExtent().width;
+		cmdViewport.height = (float)p_SwapChain->getExtent().height;
+		cmdViewport.minDepth = 0.0f;
+		cmdViewport.maxDepth = 1.0f;
+		vkCmdSetViewport(commandBuffers[i], 0, 1, &cmdViewport);
+
+		VkRect2D cmdScissor = {};
+		cmdScissor.offset = { 0, 0 }; // scissor rectangle covers framebuffer entirely
+		cmdScissor.extent = p_SwapChain->getExtent();
+		vkCmdSetScissor(commandBuffers[i], 0, 1, &cmdScissor);
 
 		VkDeviceSize offsets[1] = { 0 };
 
-		if(displaySelectionIndicator && selectedActor!=nullptr) {
-			float pointerOffset = selectedActor->position.y + abs(selectedActor->assignedMesh->aabb.max.y)+abs(selectionIndicatorMesh->aabb.max.y)+0.25f;
+		if(displaySelectionIndicator && selected!=nullptr) {
+			float pointerOffset = selected->RenderPosition().y + abs(selected->assignedMesh->aabb.max.y)+abs(selectionIndicatorMesh->aabb.max.y)+0.25f;
 			pushConstants[0].renderLimitPlane = glm::vec4(0.0f, 0.0f, 0.0f, horizon );
-			pushConstants[0].color = selectedActor->CalculateSelectionIndicatorColor();
-			pushConstants[0].pos = glm::vec3(selectedActor->position.x, pointerOffset, selectedActor->position.z);
+			pushConstants[0].color = selected->CalculateSelectionIndicatorColor();
+			pushConstants[0].pos = glm::vec3(selected->RenderPosition().x, pointerOffset, selected->RenderPosition().z);
 			vkCmdPushConstants(commandBuffers[i], pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(Constants), &pushConstants[0]);
 			
 			vkCmdBindDescriptorSets(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 5, 1, &selectionIndicatorDescriptorSet, 0, nullptr);
@@ -738,7 +761,7 @@ void Scene::CreateCommandBuffers() {
 			vkCmdBindVertexBuffers(commandBuffers[i], 0, 1, &m_VertexBuffersSkybox.getBuffer(), offsets);
 			vkCmdBindIndexBuffer(commandBuffers[i], m_IndexBuffersSkybox.getBuffer(), 0, VK_INDEX_TYPE_UINT32);
 			vkCmdBindPipeline(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, (displayWireframe) ? (skyboxWireframePipeline) : (skyboxPipeline));
-			vkCmdDrawIndexed(commandBuffers[i], static_cast<uint32_t>(std::dynamic_pointer_cast<Skybox>(skyboxes[0])->indices.size()), 1, 0, 0, 0);
+			vkCmdDrawIndexed(commandBuffers[i], skyboxIndexCount, 1, 0, 0, 0);
 		}
 
 		if (displayMainCharacter) {
@@ -748,7 +771,7 @@ void Scene::CreateCommandBuffers() {
 			descriptorSets[0] = mainCharacter->assignedMaterial->descriptorSet;
 			vkCmdBindDescriptorSets(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, static_cast<uint32_t>(descriptorSets.size()), descriptorSets.data(), 0, nullptr);
 			vkCmdBindPipeline(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, (displayWireframe) ? (pbrWireframePipeline) : (*mainCharacter->assignedMaterial->assignedPipeline));
-			pushConstants[0].pos = mainCharacter->position;
+			pushConstants[0].pos = mainCharacter->RenderPosition();
 			pushConstants[0].renderLimitPlane = glm::vec4(0.0f, 0.0f, 0.0f, horizon);
 			vkCmdPushConstants(commandBuffers[i], pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(Constants), &pushConstants[0]);
 			vkCmdDrawIndexed(commandBuffers[i], mainCharacter->assignedMesh->indexCount, 1, 0, mainCharacter->assignedMesh->indexBase, 0);
@@ -759,23 +782,36 @@ void Scene::CreateCommandBuffers() {
 			vkCmdBindVertexBuffers(commandBuffers[i], 0, 1, &m_VertexBuffersOcean.getBuffer(), offsets);
 			vkCmdBindIndexBuffer(commandBuffers[i], m_IndexBuffersOcean.getBuffer(), 0, VK_INDEX_TYPE_UINT32);
 			vkCmdBindPipeline(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, (displayWireframe) ? (oceanWireframePipeline) : (oceanPipeline));
-			vkCmdDrawIndexed(commandBuffers[i], static_cast<uint32_t>(std::dynamic_pointer_cast<Sea>(seas[0])->indices.size()), 1, 0, 0, 0);
+			vkCmdDrawIndexed(commandBuffers[i], seaIndexCount, 1, 0, 0, 0);
 		}
 
 		if (displaySceneGeometry) {
 			vkCmdBindVertexBuffers(commandBuffers[i], 0, 1, &m_VertexBuffersMeshLibraryObjects.getBuffer(), offsets);
 			vkCmdBindIndexBuffer(commandBuffers[i], m_IndexBuffersMeshLibraryObjects.getBuffer(), 0, VK_INDEX_TYPE_UINT32);
 
-			for (const auto& a : actors) {
-				if(a->visible) {
-					std::array<VkDescriptorSet, 1> descriptorSets;
-					descriptorSets[0] = a->assignedMaterial->descriptorSet;
-					vkCmdBindDescriptorSets(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, static_cast<uint32_t>(descriptorSets.size()), descriptorSets.data(), 0, nullptr);
-					vkCmdBindPipeline(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, (displayWireframe) ? (pbrWireframePipeline) : (*a->assignedMaterial->assignedPipeline));
-					pushConstants[0].pos = a->position;
-					pushConstants[0].renderLimitPlane = glm::vec4(0.0f, 0.0f, 0.0f, horizon );
+			for (const Actor* a : visibleActors) {
+				std::array<VkDescriptorSet, 1> descriptorSets;
+				descriptorSets[0] = a->assignedMaterial->descriptorSet;
+				vkCmdBindDescriptorSets(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, static_cast<uint32_t>(descriptorSets.size()), descriptorSets.data(), 0, nullptr);
+				vkCmdBindPipeline(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, (displayWireframe) ? (pbrWireframePipeline) : (*a->assignedMaterial->assignedPipeline));
+				pushConstants[0].pos = a->RenderPosition();
+				pushConstants[0].renderLimitPlane = glm::vec4(0.0f, 0.0f, 0.0f, horizon );
+				vkCmdPushConstants(commandBuffers[i], pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(Constants), &pushConstants[0]);
+				vkCmdDrawIndexed(commandBuffers[i], a->assignedMesh->indexCount, 1, 0, a->assignedMesh->indexBase, 0);
+			}
+
+			// Batches bind their material once and go through the same pipelines as actors, one draw per visible instance.
+			// A batch added since the last culling is drawn from the next frame on.
+			for (size_t b = 0; b < std::min(instanceBatches.size(), visibleInstances.size()); b++) {
+				const auto& batch = instanceBatches[b];
+				if (visibleInstances[b].empty()) continue;
+				vkCmdBindDescriptorSets(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &batch.material->descriptorSet, 0, nullptr);
+				vkCmdBindPipeline(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, (displayWireframe) ? (pbrWireframePipeline) : (*batch.material->assignedPipeline));
+				pushConstants[0].renderLimitPlane = glm::vec4(0.0f, 0.0f, 0.0f, horizon);
+				for (uint32_t instance : visibleInstances[b]) {
+					pushConstants[0].pos = batch.instances[instance].pos;
 					vkCmdPushConstants(commandBuffers[i], pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(Constants), &pushConstants[0]);
-					vkCmdDrawIndexed(commandBuffers[i], a->assignedMesh->indexCount, 1, 0, a->assignedMesh->indexBase, 0);
+					vkCmdDrawIndexed(commandBuffers[i], batch.mesh->indexCount, 1, 0, batch.mesh->indexBase, 0);
 				}
 			}
 		}
@@ -806,12 +842,10 @@ void Scene::CreateCommandBuffers() {
 			vkCmdBindIndexBuffer(commandBuffers[i], m_IndexBuffersAABB.getBuffer() , 0, VK_INDEX_TYPE_UINT32);
 			vkCmdBindDescriptorSets(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 6, 1, &aabbDescriptorSet, 0, nullptr);
 			vkCmdBindPipeline(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, aabbPipeline);
-			for (const auto& a : actors) {
-				if(a->visible) {
-					pushConstants[0].pos = a->position;
-					vkCmdPushConstants(commandBuffers[i], pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(Constants), &pushConstants[0]);
-					vkCmdDrawIndexed(commandBuffers[i], 24, 1, 0, a->assignedMesh->indexBaseAabb, 0);
-				}
+			for (const Actor* a : visibleActors) {
+				pushConstants[0].pos = a->RenderPosition();
+				vkCmdPushConstants(commandBuffers[i], pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(Constants), &pushConstants[0]);
+				vkCmdDrawIndexed(commandBuffers[i], 24, 1, 0, a->assignedMesh->indexBaseAabb, 0);
 			}
 		}
 
@@ -867,6 +901,9 @@ void Scene::CreateReflectionCommandBuffer() {
 		reflectionCmdBuff = VK_NULL_HANDLE;
 	}
 
+	const Skybox* skybox = actorHandles.Get(skyboxHandle);
+	const uint32_t skyboxIndexCount = skybox ? static_cast<uint32_t>(skybox->indices.size()) : 0;
+
 	VkCommandBufferBeginInfo beginInfo = {};
 	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
@@ -896,18 +933,20 @@ void Scene::CreateReflectionCommandBuffer() {
 	ErrorCheck(vkBeginCommandBuffer(reflectionCmdBuff, &beginInfo));
 	vkCmdBeginRenderPass(reflectionCmdBuff, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
 		
-	viewport.x = 0.0f;
-	viewport.y = 0.0f;
-	viewport.width = (float)p_SwapChain->getExtent().width;
-	viewport.height = (float)p_SwapChain->getExtent().height;
-	viewport.minDepth = 0.0f;
-	viewport.maxDepth = 1.0f;
-	vkCmdSetViewport(reflectionCmdBuff, 0, 1, &viewport);
-
-	scissor.offset = { 0, 0 }; // scissor rectangle covers framebuffer entirely
-	scissor.extent.width = p_SwapChain->getExtent().width;
-	scissor.extent.height = p_SwapChain->getExtent().height;
-	vkCmdSetScissor(reflectionCmdBuff, 0, 1, &scissor);
+	VkViewport cmdViewport = {};
+	cmdViewport.x = 0.0f;
+	cmdViewport.y = 0.0f;
+	cmdViewport.width = (float)p_SwapChain->getExtent().width;
+	cmdViewport.height = (float)p_SwapChain->getExtent().height;
+	cmdViewport.minDepth = 0.0f;
+	cmdViewport.maxDepth = 1.0f;
+	vkCmdSetViewport(reflectionCmdBuff, 0, 1, &cmdViewport);
+
+	VkRect2D cmdScissor = {};
+	cmdScissor.offset = { 0, 0 }; // scissor rectangle covers framebuffer entirely
+	cmdScissor.extent.width = p_SwapChain->getExtent().width;
+	cmdScissor.extent.height = p_SwapChain->getExtent().height;
+	vkCmdSetScissor(reflectionCmdBuff, 0, 1, &cmdScissor);
 
 	VkDeviceSize offsets[1] = { 0 };
 
@@ -917,7 +956,7 @@ void Scene::CreateReflectionCommandBuffer() {
 		vkCmdBindVertexBuffers(reflectionCmdBuff, 0, 1, &m_VertexBuffersSkybox.getBuffer(), offsets);
 		vkCmdBindIndexBuffer(reflectionCmdBuff, m_IndexBuffersSkybox.getBuffer(), 0, VK_INDEX_TYPE_UINT32);
 		vkCmdBindPipeline(reflectionCmdBuff, VK_PIPELINE_BIND_POINT_GRAPHICS, skyboxReflectionPipeline);
-		vkCmdDrawIndexed(reflectionCmdBuff, static_cast<uint32_t>(std::dynamic_pointer_cast<Skybox>(skyboxes[0])->indices.size()), 1, 0, 0, 0);
+		vkCmdDrawIndexed(reflectionCmdBuff, skyboxIndexCount, 1, 0, 0, 0);
 	}
 
 	// 3d object
@@ -931,12 +970,25 @@ void Scene::CreateReflectionCommandBuffer() {
 		vkCmdBindDescriptorSets(reflectionCmdBuff, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, static_cast<uint32_t>(descriptorSets.size()), descriptorSets.data(), 0, nullptr);
 		vkCmdBindPipeline(reflectionCmdBuff, VK_PIPELINE_BIND_POINT_GRAPHICS, pbrReflectionPipeline);
 		
-		pushConstants[1].pos = actors[j]->position;
-		pushConstants[1].renderLimitPlane = (currentCamera->position.y<0) ? (glm::vec4(0.0f, -1.0f, 0.0f, -0.0f)) : (glm::vec4(0.0f, 1.0f, 0.0f, -0.0f));
+		pushConstants[1].pos = actors[j]->RenderPosition();
+		pushConstants[1].renderLimitPlane = (currentCamera->RenderPosition().y<0) ? (glm::vec4(0.0f, -1.0f, 0.0f, -0.0f)) : (glm::vec4(0.0f, 1.0f, 0.0f, -0.0f));
 		vkCmdPushConstants(reflectionCmdBuff, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(Constants), &pushConstants[1]);
 		vkCmdDrawIndexed(reflectionCmdBuff, actors[j]->assignedMesh->indexCount, 1, 0, actors[j]->assignedMesh->indexBase, 0);
 	}
 
+	for (size_t b = 0; b < std::min(instanceBatches.size(), reflectedInstances.size()); b++) {
+		const auto& batch = instanceBatches[b];
+		if (reflectedInstances[b].empty()) continue;
+		vkCmdBindDescriptorSets(reflectionCmdBuff, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &batch.material->reflectDescriptorSet, 0, nullptr);
+		vkCmdBindPipeline(reflectionCmdBuff, VK_PIPELINE_BIND_POINT_GRAPHICS, pbrReflectionPipeline);
+		pushConstants[1].renderLimitPlane = (currentCamera->RenderPosition().y<0) ? (glm::vec4(0.0f, -1.0f, 0.0f, -0.0f)) : (glm::vec4(0.0f, 1.0f, 0.0f, -0.0f));
+		for (uint32_t instance : reflectedInstances[b]) {
+			pushConstants[1].pos = batch.instances[instance].pos;
+			vkCmdPushConstants(reflectionCmdBuff, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(Constants), &pushConstants[1]);
+			vkCmdDrawIndexed(reflectionCmdBuff, batch.mesh->indexCount, 1, 0, batch.mesh->indexBase, 0);
+		}
+	}
+
 	vkCmdEndRenderPass(reflectionCmdBuff);
 	ErrorCheck(vkEndCommandBuffer(reflectionCmdBuff));
 }
@@ -947,6 +999,9 @@ void Scene::CreateRefractionCommandBuffer() {
 		refractionCmdBuff = VK_NULL_HANDLE;
 	}
 
+	const Skybox* skybox = actorHandles.Get(skyboxHandle);
+	const uint32_t skyboxIndexCount = skybox ? static_cast<uint32_t>(skybox->indices.size()) : 0;
+
 	VkCommandBufferBeginInfo beginInfo = {};
 	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
@@ -976,18 +1031,20 @@ void Scene::CreateRefractionCommandBuffer() {
 	ErrorCheck(vkBeginCommandBuffer(refractionCmdBuff, &beginInfo));
 	vkCmdBeginRenderPass(refractionCmdBuff, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
 		
-	viewport.x = 0.0f;
-	viewport.y = 0.0f;
-	viewport.width = (float)p_SwapChain->getExtent().width;
-	viewport.height = (float)p_SwapChain->getExtent().height;
-	viewport.minDepth = 0.0f;
-	viewport.maxDepth = 1.0f;
-	vkCmdSetViewport(refractionCmdBuff, 0, 1, &viewport);
-
-	scissor.offset = { 0, 0 }; // scissor rectangle covers framebuffer entirely
-	scissor.extent.width = p_SwapChain->getExtent().width;
-	scissor.extent.height = p_SwapChain->getExtent().height;
-	vkCmdSetScissor(refractionCmdBuff, 0, 1, &scissor);
+	VkViewport cmdViewport = {};
+	cmdViewport.x = 0.0f;
+	cmdViewport.y = 0.0f;
+	cmdViewport.width = (float)p_SwapChain->getExtent().width;
+	cmdViewport.height = (float)p_SwapChain->getExtent().height;
+	cmdViewport.minDepth = 0.0f;
+	cmdViewport.maxDepth = 1.0f;
+	vkCmdSetViewport(refractionCmdBuff, 0, 1, &cmdViewport);
+
+	VkRect2D cmdScissor = {};
+	cmdScissor.offset = { 0, 0 }; // scissor rectangle covers framebuffer entirely
+	cmdScissor.extent.width = p_SwapChain->getExtent().width;
+	cmdScissor.extent.height = p_SwapChain->getExtent().height;
+	vkCmdSetScissor(refractionCmdBuff, 0, 1, &cmdScissor);
 
 	VkDeviceSize offsets[1] = { 0 };
 
@@ -997,7 +1054,7 @@ void Scene::CreateRefractionCommandBuffer() {
 		vkCmdBindVertexBuffers(refractionCmdBuff, 0, 1, &m_VertexBuffersSkybox.getBuffer(), offsets);
 		vkCmdBindIndexBuffer(refractionCmdBuff, m_IndexBuffersSkybox.getBuffer(), 0, VK_INDEX_TYPE_UINT32);
 		vkCmdBindPipeline(refractionCmdBuff, VK_PIPELINE_BIND_POINT_GRAPHICS, skyboxRefractionPipeline);
-		vkCmdDrawIndexed(refractionCmdBuff, static_cast<uint32_t>(std::dynamic_pointer_cast<Skybox>(skyboxes[0])->indices.size()), 1, 0, 0, 0);
+		vkCmdDrawIndexed(refractionCmdBuff, skyboxIndexCount, 1, 0, 0, 0);
 	}
 
 	// 3d object
@@ -1010,12 +1067,25 @@ void Scene::CreateRefractionCommandBuffer() {
 		vkCmdBindDescriptorSets(refractionCmdBuff, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, static_cast<uint32_t>(descriptorSets.size()), descriptorSets.data(), 0, nullptr);
 		vkCmdBindPipeline(refractionCmdBuff, VK_PIPELINE_BIND_POINT_GRAPHICS, pbrRefractionPipeline);
 		
-		pushConstants[2].pos = actors[j]->position;
+		pushConstants[2].pos = actors[j]->RenderPosition();
 		pushConstants[2].renderLimitPlane = glm::vec4(0.0f, -1.0f, 0.0f, 0.0f );
 		vkCmdPushConstants(refractionCmdBuff, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(Constants), &pushConstants[2]);
 		vkCmdDrawIndexed(refractionCmdBuff, actors[j]->assignedMesh->indexCount, 1, 0, actors[j]->assignedMesh->indexBase, 0);
 	}
 
+	for (size_t b = 0; b < std::min(instanceBatches.size(), visibleInstances.size()); b++) {
+		const auto& batch = instanceBatches[b];
+		if (visibleInstances[b].empty()) continue;
+		vkCmdBindDescriptorSets(refractionCmdBuff, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &batch.material->refractDescriptorSet, 0, nullptr);
+		vkCmdBindPipeline(refractionCmdBuff, VK_PIPELINE_BIND_POINT_GRAPHICS, pbrRefractionPipeline);
+		pushConstants[2].renderLimitPlane = glm::vec4(0.0f, -1.0f, 0.0f, 0.0f );
+		for (uint32_t instance : visibleInstances[b]) {
+			pushConstants[2].pos = batch.instances[instance].pos;
+			vkCmdPushConstants(refractionCmdBuff, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(Constants), &pushConstants[2]);
+			vkCmdDrawIndexed(refractionCmdBuff, batch.mesh->indexCount, 1, 0, batch.mesh->indexBase, 0);
+		}
+	}
+
 	vkCmdEndRenderPass(refractionCmdBuff);
 	ErrorCheck(vkEndCommandBuffer(refractionCmdBuff));
 }
@@ -1114,29 +1184,131 @@ void Scene::RandomPositions() {
 	}
 }
 
+// Same steps as T::UpdatePosition, with the approach and integration done for the whole type at once over the awake part of its motion store.
+// Actors whose motion has converged then fall asleep, leaving the bucket and the awake part of the store.
+template<typename T>
+void Scene::UpdateBucket(std::vector<T*>& bucket, enginetool::MotionStore& motion, float dt) {
+	enginetool::ParallelFor(threadPool, 0, bucket.size(), actorsPerJob, [&bucket](size_t first, size_t last) {
+		for (size_t i = first; i < last; i++) bucket[i]->BeginMove();
+	});
+	enginetool::ParallelFor(threadPool, 0, motion.GetAwakeCount(), actorsPerJob * 16, [&motion, dt](size_t first, size_t last) {
+		enginetool::ApproachAndIntegrate(&motion.positions[first].x, &motion.movements[first].x, &motion.movementGoals[first].x, (last - first) * 3, dt * T::approachRate, dt);
+	});
+	enginetool::ParallelFor(threadPool, 0, bucket.size(), actorsPerJob, [&bucket](size_t first, size_t last) {
+		for (size_t i = first; i < last; i++) bucket[i]->EndMove();
+	});
+	// Serial, sleeping moves slots around in the store
+	bucket.erase(std::remove_if(bucket.begin(), bucket.end(), [this](T* actor) {
+		if (!actor->TrySleep()) return false;
+		settledActors.push_back(actor);
+		return true;
+	}), bucket.end());
+}
+
 void Scene::UpdatePositions() {
-	for(const auto& a : actors) a->UpdatePosition((float)mainClock->fixedTimeValue);
-	for(const auto& c : sceneCameras) c->UpdatePosition((float)mainClock->fixedTimeValue);
-	mainCharacter->UpdatePosition((float)mainClock->fixedTimeValue);
+	const float dt = (float)mainClock->fixedTimeValue;
+
+	for (Actor* actor : wokenActors) {
+		actor->inRestingBroadphase = false; // its box there goes stale once it moves
+		AddToBucket(actor);
+	}
+	wokenActors.clear();
+
+	UpdateRayQueries();
+	UpdateBroadphase();
+
+	// Actors only read each other's AABBs while sensing and only write their own state while moving, so both passes split freely over threads.
+	// Sleeping actors sense nothing; others still see their cached AABBs.
+	auto senseSurroundings = [this](auto& bucket) {
+		enginetool::ParallelFor(threadPool, 0, bucket.size(), actorsPerJob, [&bucket](size_t first, size_t last) {
+			for (size_t i = first; i < last; i++) bucket[i]->SenseSurroundings();
+		});
+	};
+	senseSurroundings(landscapeBucket);
+	senseSurroundings(sphereLightBucket);
+	senseSurroundings(characterBucket);
+	senseSurroundings(otherActors);
+	ResolveContacts();
+	mainCharacter->SenseSurroundings();
+	mainCharacter->CheckCollisions(); // it is not in the broadphase, so it tests its own box
+
+	// Tick state of every awake actor, cameras and main character included, is one linear copy per motion store.
+	for (enginetool::MotionStore* store : { &motionStore, &landscapeMotion, &sphereLightMotion, &characterMotion }) {
+		enginetool::ParallelFor(threadPool, 0, store->GetAwakeCount(), actorsPerJob * 16, [store](size_t first, size_t last) {
+			store->StoreTickState(first, last);
+		});
+	}
+
+	UpdateBucket(landscapeBucket, landscapeMotion, dt);
+	UpdateBucket(sphereLightBucket, sphereLightMotion, dt);
+	UpdateBucket(characterBucket, characterMotion, dt);
+	enginetool::ParallelFor(threadPool, 0, otherActors.size(), actorsPerJob, [this, dt](size_t first, size_t last) {
+		for (size_t i = first; i < last; i++) otherActors[i]->UpdatePosition(dt);
+	});
+	for (const auto& c : sceneCameras) {
+		c->StoreTickState();
+		c->UpdatePosition(dt);
+	}
+	mainCharacter->UpdatePosition(dt);
+}
+
+// Collisions of the whole tick: overlapping pairs are found in parallel, then answered in one serial loop in contact order, so
+// which actors reflect and the order they wake in do not depend on the threads. Only awake characters turn back, as when each
+// of them tested its own box while sensing, so of the resting actors only those touching an awake character are looked at.
+void Scene::ResolveContacts() {
+	static_assert(sizeof(enginetool::ScenePart::AABB) == 6 * sizeof(float), "the narrowphase reads an AABB as six floats");
+	const float* boxes = reinterpret_cast<const float*>(contactBoxes.data());
+	contacts.clear();
+	narrowphase.FindContacts(threadPool, broadphase, boxes, contacts);
+
+	restingPairs.clear();
+	for (Character* character : characterBucket) {
+		const uint32_t id = character->rayTreeId;
+		restingCandidates.clear();
+		restingBroadphase.Query(&contactBoxes[id].min.x, &contactBoxes[id].max.x, restingCandidates);
+		for (uint32_t other : restingCandidates) {
+			if (actors[other]->inRestingBroadphase) restingPairs.emplace_back(std::min(id, other), std::max(id, other));
+		}
+	}
+	narrowphase.FindContacts(threadPool, restingPairs, boxes, contacts);
+	for (const enginetool::Narrowphase::Contact& contact : contacts) {
+		for (uint32_t id : { contact.first, contact.second }) {
+			Actor* actor = actors[id].get();
+			if (actor->GetType() == ActorType::Character && !actor->IsSleeping()) actor->SetState(ActorState::Reflection);
+		}
+	}
+}
+
+void Scene::InterpolateTransforms() {
+	const float alpha = interpolationAlpha;
+	// Sleeping actors were left with their render position on their position
+	for (enginetool::MotionStore* store : { &motionStore, &landscapeMotion, &sphereLightMotion, &characterMotion }) {
+		enginetool::ParallelFor(threadPool, 0, store->GetAwakeCount(), actorsPerJob * 16, [store, alpha](size_t first, size_t last) {
+			store->Interpolate(alpha, first, last);
+		});
+	}
+	// Cameras also blend their view point
+	for(const auto& c : sceneCameras) c->Interpolate(alpha);
 }
 
 void Scene::HandleMouseClick() {
-	if(selectedActor == nullptr) {
+	Actor* selected = actorHandles.Get(selectedActor);
+	if(selected == nullptr) {
 		SelectActor();
 		std::cout << "Selected"<< std::endl;
 	}
 	else {
-		glm::vec3 indicatedTarget = selectedActor->position; 
+		glm::vec3 indicatedTarget = selected->Position(); 
 		if(FindDestinationPosition(indicatedTarget)) {
-			selectedActor->destinationPoint = indicatedTarget;
-			selectedActor->ChangePosition();
+			selected->destinationPoint = indicatedTarget;
+			selected->ChangePosition();
 			std::cout << "Position changed"<< std::endl;
 		}
 	}
 }
 
 float Scene::GetMainCharacterHealthRatio() const {
-	const Character* character = dynamic_cast<const Character*>(mainCharacter.get());
+	const Character* character = mainCharacter.get();
 	if (!character || character->maxHealth == 0) {
 		return 0.0f;
 	}
@@ -1146,97 +1318,298 @@ float Scene::GetMainCharacterHealthRatio() const {
 }
 
 int Scene::GetMainCharacterCurrentHealth() const {
-	const Character* character = dynamic_cast<const Character*>(mainCharacter.get());
+	const Character* character = mainCharacter.get();
 	return character ? character->currentHealth : 0;
 }
 
 unsigned int Scene::GetMainCharacterMaxHealth() const {
-	const Character* character = dynamic_cast<const Character*>(mainCharacter.get());
+	const Character* character = mainCharacter.get();
 	return character ? character->maxHealth : 0;
 }
 
-void Scene::CheckActorsVisibility(){
-	for(auto& a : actors) CheckIfItIsVisible(a);
+// Frustum culling with the camera of UpdateStaticUniformBuffer. Boxes are moved to where actors are drawn this frame, between
+// their last two ticks, and culled in parallel chunks; the visible actors are then listed in the order of actors.
+void Scene::CheckActorsVisibility() {
+	const glm::mat4 viewProjection = UBOSG.proj * UBOSG.view;
+	const enginetool::Frustum frustum = enginetool::ExtractFrustum(&viewProjection[0][0]);
+	const size_t count = actors.size();
+	cullBounds.resize(count * 6);
+	actorVisibility.resize(count);
+	enginetool::BoxArrays boxes;
+	for (int axis = 0; axis < 3; axis++) {
+		boxes.min[axis] = cullBounds.data() + axis * count;
+		boxes.max[axis] = cullBounds.data() + (axis + 3) * count;
+	}
+
+	enginetool::ParallelFor(threadPool, 0, count, actorsPerJob * 16, [this, &frustum, &boxes, count](size_t first, size_t last) {
+		for (size_t i = first; i < last; i++) {
+			const enginetool::ScenePart::AABB& aabb = actors[i]->CurrentAabb();
+			const glm::vec3 shift = actors[i]->RenderPosition() - actors[i]->Position();
+			for (int axis = 0; axis < 3; axis++) {
+				cullBounds[axis * count + i] = aabb.min[axis] + shift[axis];
+				cullBounds[(axis + 3) * count + i] = aabb.max[axis] + shift[axis];
+			}
+		}
+		enginetool::BoxArrays chunk;
+		for (int axis = 0; axis < 3; axis++) {
+			chunk.min[axis] = boxes.min[axis] + first;
+			chunk.max[axis] = boxes.max[axis] + first;
+		}
+		enginetool::CullBoxes(frustum, chunk, last - first, &actorVisibility[first]);
+	});
+
+	visibleActors.clear();
+	for (size_t i = 0; i < count; i++) {
+		if (actorVisibility[i]) visibleActors.push_back(actors[i].get());
+	}
+
+	// The reflection pass draws the scene mirrored in y with the same camera, see UpdateOffscreenUniformBuffer, so what it
+	// shows is what this frustum sees of the mirror image; refraction uses the camera as it is and draws visibleInstances.
+	const glm::mat4 mirroredViewProjection = viewProjection * glm::scale(glm::mat4(1.0f), glm::vec3(1.0f, -1.0f, 1.0f));
+	CheckInstancesVisibility(frustum, enginetool::ExtractFrustum(&mirroredViewProjection[0][0]));
+}
+
+// Instances are culled like actors, box by box, once the bounds of their batch were found inside the frustum. Their boxes
+// are the mesh's box moved to every position; instances do not move, so there is nothing to interpolate.
+void Scene::CheckInstancesVisibility(const enginetool::Frustum& frustum, const enginetool::Frustum& mirrored) {
+	auto boxVisible = [](const enginetool::Frustum& planes, const enginetool::ScenePart::AABB& aabb) {
+		enginetool::BoxArrays box;
+		for (int axis = 0; axis < 3; axis++) {
+			box.min[axis] = &aabb.min[axis];
+			box.max[axis] = &aabb.max[axis];
+		}
+		uint8_t visible = 0;
+		enginetool::CullBoxes(planes, box, 1, &visible);
+		return visible != 0;
+	};
+
+	visibleInstances.resize(instanceBatches.size());
+	reflectedInstances.resize(instanceBatches.size());
+	for (size_t b = 0; b < instanceBatches.size(); b++) {
+		const enginetool::InstanceBatch& batch = instanceBatches[b];
+		visibleInstances[b].clear();
+		reflectedInstances[b].clear();
+		const bool seen = !batch.instances.empty() && boxVisible(frustum, batch.bounds);
+		const bool reflected = !batch.instances.empty() && boxVisible(mirrored, batch.bounds);
+		if (!seen && !reflected) continue;
+
+		const size_t count = batch.instances.size();
+		instanceCullBounds.resize(count * 6);
+		instanceVisibility.assign(count, 0);
+		reflectedVisibility.assign(count, 0);
+		enginetool::BoxArrays boxes;
+		for (int axis = 0; axis < 3; axis++) {
+			boxes.min[axis] = instanceCullBounds.data() + axis * count;
+			boxes.max[axis] = instanceCullBounds.data() + (axis + 3) * count;
+		}
+
+		enginetool::ParallelFor(threadPool, 0, count, actorsPerJob * 16, [this, &batch, &boxes, &frustum, &mirrored, seen, reflected, count](size_t first, size_t last) {
+			for (size_t i = first; i < last; i++) {
+				for (int axis = 0; axis < 3; axis++) {
+					instanceCullBounds[axis * count + i] = batch.instances[i].pos[axis] + batch.mesh->aabb.min[axis];
+					instanceCullBounds[(axis + 3) * count + i] = batch.instances[i].pos[axis] + batch.mesh->aabb.max[axis];
+				}
+			}
+			enginetool::BoxArrays chunk;
+			for (int axis = 0; axis < 3; axis++) {
+				chunk.min[axis] = boxes.min[axis] + first;
+				chunk.max[axis] = boxes.max[axis] + first;
+			}
+			if (seen) enginetool::CullBoxes(frustum, chunk, last - first, &instanceVisibility[first]);
+			if (reflected) enginetool::CullBoxes(mirrored, chunk, last - first, &reflectedVisibility[first]);
+		});
+
+		for (size_t i = 0; i < count; i++) {
+			if (instanceVisibility[i]) visibleInstances[b].push_back(static_cast<uint32_t>(i));
+			if (reflectedVisibility[i]) reflectedInstances[b].push_back(static_cast<uint32_t>(i));
+		}
+	}
 }
 
-void Scene::CheckIfItIsVisible(std::shared_ptr<Actor>& actorToCheck) {
-	float distance = glm::distance(mainCharacter->position, actorToCheck->position);
-	if(distance>3000.0f) 
-		actorToCheck->visible=false;
-	else actorToCheck->visible=true;
+// Picking goes on from an actor's box into the triangles of its mesh, so a click beside the mesh passes the actor.
+// Defined before its callers, which need the lambda type.
+auto Scene::MeshHitTest(const glm::vec3& rayOrigin, const glm::vec3& rayDirection) const {
+	return [this, rayOrigin, rayDirection](uint32_t id, float enter, float limit, float& distance) {
+		return id < actors.size() && actors[id]->RayHitsMesh(rayOrigin, rayDirection, enter, limit, distance);
+	};
 }
 
 void Scene::SelectActor() {
-	glm::vec3 dirFrac;
-	dirFrac.x = 1.0f / m_MousePicker->GetRayDirection().x;
-	dirFrac.y = 1.0f / m_MousePicker->GetRayDirection().y;
-	dirFrac.z = 1.0f / m_MousePicker->GetRayDirection().z;
-	for (auto const& a : actors) {
-		if(enginetool::ScenePart::RayIntersection(m_MousePicker->hitPoint, dirFrac, m_MousePicker->GetRayOrigin(), m_MousePicker->GetRayDirection(), a->currentAabb)) {
-			std::cout << "Hit point: " << m_MousePicker->hitPoint.x << " " << m_MousePicker->hitPoint.y << " " << m_MousePicker->hitPoint.z << "\n";
-			selectedActor=a;
-			std::cout << "Selected object: " << selectedActor->name << std::endl;
-			break;
-		}
+	UpdateRayQueries(); // actors may have moved, spawned or despawned since the last tick
+	const glm::vec3 rayOrigin = m_MousePicker->GetRayOrigin();
+	const glm::vec3 rayDirection = m_MousePicker->GetRayDirection();
+	const enginetool::AabbTree::RayHit hit = rayTree.Raycast(&rayOrigin.x, &rayDirection.x, std::numeric_limits<float>::max(), enginetool::AabbTree::none, MeshHitTest(rayOrigin, rayDirection));
+	if (hit.id < actors.size()) {
+		const auto& a = actors[hit.id];
+		m_MousePicker->hitPoint = rayOrigin + rayDirection * hit.distance;
+		std::cout << "Hit point: " << m_MousePicker->hitPoint.x << " " << m_MousePicker->hitPoint.y << " " << m_MousePicker->hitPoint.z << "\n";
+		selectedActor=a->handle;
+		std::cout << "Selected object: " << actorNames.Lookup(a->name) << std::endl;
 	}
 }
 
 bool Scene::FindDestinationPosition(glm::vec3& destinationPoint) {
-	glm::vec3 dirFrac;
-	dirFrac.x = 1.0f / m_MousePicker->GetRayDirection().x;
-	dirFrac.y = 1.0f / m_MousePicker->GetRayDirection().y;
-	dirFrac.z = 1.0f / m_MousePicker->GetRayDirection().z;
-
-	glm::vec3 rayOrigin = m_MousePicker->GetRayOrigin();
-
-	for (auto const& a : actors) {
-		if(enginetool::ScenePart::RayIntersection(m_MousePicker->hitPoint, dirFrac, rayOrigin, m_MousePicker->GetRayDirection(), a->currentAabb) && selectedActor!=a) {
-			destinationPoint = m_MousePicker->hitPoint;
-			std::cout << "Position found"<< std::endl;
-			return true;
-		}
+	UpdateRayQueries();
+	const glm::vec3 rayOrigin = m_MousePicker->GetRayOrigin();
+	const glm::vec3 rayDirection = m_MousePicker->GetRayDirection();
+	const Actor* selected = actorHandles.Get(selectedActor);
+	const uint32_t ignore = (selected != nullptr) ? selected->rayTreeId : enginetool::AabbTree::none;
+
+	const enginetool::AabbTree::RayHit hit = rayTree.Raycast(&rayOrigin.x, &rayDirection.x, std::numeric_limits<float>::max(), ignore, MeshHitTest(rayOrigin, rayDirection));
+	if (hit.id < actors.size()) {
+		m_MousePicker->hitPoint = rayOrigin + rayDirection * hit.distance;
+		destinationPoint = m_MousePicker->hitPoint;
+		std::cout << "Position found"<< std::endl;
+		return true;
 	}
 	return false;	
 }
 
+// Actors whose boxes may have changed since the last tick: the awake ones, those woken since and those that fell asleep after
+// restingBroadphase was built. Every other actor has slept in place since then.
+void Scene::CollectMovingActors() {
+	// A settled actor that woke again is back in its bucket
+	settledActors.erase(std::remove_if(settledActors.begin(), settledActors.end(), [](const Actor* actor) { return !actor->IsSleeping(); }), settledActors.end());
+
+	movingActors.clear();
+	movingActors.insert(movingActors.end(), landscapeBucket.begin(), landscapeBucket.end());
+	movingActors.insert(movingActors.end(), sphereLightBucket.begin(), sphereLightBucket.end());
+	movingActors.insert(movingActors.end(), characterBucket.begin(), characterBucket.end());
+	movingActors.insert(movingActors.end(), otherActors.begin(), otherActors.end());
+	movingActors.insert(movingActors.end(), wokenActors.begin(), wokenActors.end());
+	movingActors.insert(movingActors.end(), settledActors.begin(), settledActors.end());
+}
+
+// Only the moving actors are put in the grid each tick. The resting grid is built again when actors were added or removed, or
+// once the actors that fell asleep since are an eighth of all actors, so a rebuild is paid for by the actors that settled.
+void Scene::UpdateBroadphase() {
+	contactBoxes.resize(actors.size());
+	if (restingChanged || settledActors.size() > actors.size() / 8) {
+		restingBroadphase.Clear();
+		for (const auto& actor : actors) {
+			actor->inRestingBroadphase = actor->IsSleeping();
+			if (!actor->inRestingBroadphase) continue;
+			const enginetool::ScenePart::AABB& aabb = actor->CurrentAabb();
+			restingBroadphase.Insert(actor->rayTreeId, &aabb.min.x, &aabb.max.x);
+			contactBoxes[actor->rayTreeId] = aabb;
+		}
+		restingBroadphase.Build();
+		settledActors.clear();
+		restingChanged = false;
+		CollectMovingActors();
+	}
+
+	broadphase.Clear();
+	for (Actor* actor : movingActors) {
+		const enginetool::ScenePart::AABB& aabb = actor->CurrentAabb();
+		broadphase.Insert(actor->rayTreeId, &aabb.min.x, &aabb.max.x);
+		contactBoxes[actor->rayTreeId] = aabb;
+	}
+	broadphase.Build();
+}
+
+// Box i of rayTree is always actors[i], groundTree holds the other actors in the same order. They are built again when actors
+// were added or removed, or refitting has left one twice as costly to search as a fresh build; otherwise only the boxes of the
+// moving actors are refit. Landscapes are the static ground: they are baked into the heightfield, again only when one of them
+// moved. Only a landscape with a flat top has its height baked, the ground over any other one is found on its triangles.
+void Scene::UpdateRayQueries() {
+	CollectMovingActors();
+	const bool rebuild = actorsChanged || rayTree.NeedsRebuild() || groundTree.NeedsRebuild();
+	if (rebuild) {
+		rayTree.Clear();
+		groundTree.Clear();
+		groundBoxes.assign(actors.size(), enginetool::AabbTree::none);
+		for (size_t i = 0; i < actors.size(); i++) {
+			const uint32_t id = static_cast<uint32_t>(i);
+			const enginetool::ScenePart::AABB& aabb = actors[i]->CurrentAabb();
+			actors[i]->rayTreeId = id;
+			rayTree.Insert(id, &aabb.min.x, &aabb.max.x);
+			if (actors[i]->GetType() != ActorType::Landscape) {
+				groundBoxes[i] = static_cast<uint32_t>(groundTree.GetCount());
+				groundTree.Insert(id, &aabb.min.x, &aabb.max.x);
+			}
+		}
+		rayTree.Build();
+		groundTree.Build();
+	}
+	else {
+		movedBoxes.clear();
+		movedGroundBoxes.clear();
+		for (const Actor* actor : movingActors) {
+			const uint32_t id = actor->rayTreeId;
+			const enginetool::ScenePart::AABB& aabb = actor->CurrentAabb();
+			rayTree.UpdateBox(id, &aabb.min.x, &aabb.max.x);
+			movedBoxes.push_back(id);
+			if (groundBoxes[id] != enginetool::AabbTree::none) {
+				groundTree.UpdateBox(groundBoxes[id], &aabb.min.x, &aabb.max.x);
+				movedGroundBoxes.push_back(groundBoxes[id]);
+			}
+		}
+		rayTree.Refit(movedBoxes);
+		groundTree.Refit(movedGroundBoxes);
+	}
+
+	bool staticsMoved = actorsChanged;
+	for (size_t i = 0; i < movingActors.size() && !staticsMoved; i++) {
+		const Actor* actor = movingActors[i];
+		if (actor->GetType() != ActorType::Landscape) continue;
+		const enginetool::ScenePart::AABB& aabb = actor->CurrentAabb();
+		const enginetool::ScenePart::AABB& baked = staticBoxes[actor->rayTreeId];
+		staticsMoved = baked.min != aabb.min || baked.max != aabb.max;
+	}
+	actorsChanged = false;
+
+	if (staticsMoved) {
+		staticBoxes.resize(actors.size());
+		heightfield.Clear();
+		for (size_t i = 0; i < actors.size(); i++) {
+			const Actor& a = *actors[i];
+			if (a.GetType() != ActorType::Landscape) continue;
+			staticBoxes[i] = a.CurrentAabb();
+			heightfield.Insert(&a.CurrentAabb().min.x, &a.CurrentAabb().max.x, a.assignedMesh == nullptr || a.assignedMesh->flatTop);
+		}
+		heightfield.Build();
+	}
+}
+
 void Scene::DeSelect() {
 	//selectedActor->movementGoal = glm::vec3(0.0f, 0.0f, 0.0f);
-	selectedActor = nullptr;
+	selectedActor = enginetool::Handle<Actor>();
 	std::cout << "Deselected" << std::endl;
 }
 
 void Scene::UpdateStaticUniformBuffer() {
 	UBOSG.proj = glm::perspective(glm::radians(currentCamera->FOV), (float)p_SwapChain->getExtent().width / (float)p_SwapChain->getExtent().height, currentCamera->clippingNear, currentCamera->clippingFar);
 	UBOSG.proj[1][1] *= -1; //since the Y axis of Vulkan NDC points down
-	UBOSG.view = glm::lookAt(currentCamera->position, currentCamera->view, currentCamera->up);
+	UBOSG.view = glm::lookAt(currentCamera->RenderPosition(), currentCamera->renderView, currentCamera->up);
 	UBOSG.model = glm::mat4(1.0f);
-	UBOSG.cameraPos = glm::vec3(currentCamera->position);
+	UBOSG.cameraPos = glm::vec3(currentCamera->RenderPosition());
 	memcpy(m_UboStillObjects.getMapped(), &UBOSG, sizeof(UBOSG));
 	memcpy(m_UboLine.getMapped(), &UBOSG, sizeof(UBOSG));
-	m_MousePicker->UpdateMousePicker(UBOSG.view, UBOSG.proj, currentCamera);
+	m_MousePicker->UpdateMousePicker(UBOSG.view, UBOSG.proj, currentCamera.get());
 }
 
 void Scene::UpdateCloudsUniformBuffer() {
 	UBOC.proj = glm::perspective(glm::radians(currentCamera->FOV), (float)p_SwapChain->getExtent().width / (float)p_SwapChain->getExtent().height, currentCamera->clippingNear, currentCamera->clippingFar);
 	UBOC.proj[1][1] *= -1; 
-	UBOC.view = glm::lookAt(currentCamera->position, currentCamera->view, currentCamera->up);
+	UBOC.view = glm::lookAt(currentCamera->RenderPosition(), currentCamera->renderView, currentCamera->up);
 	UBOC.time = (float)mainClock->totalElapsedTime;
 	// fixed position
 	//UBOC.view[3][0] *= 0;
 	//UBOC.view[3][1] *= 0;
 	//UBOC.view[3][2] *= 0;
-	UBOC.view = glm::lookAt(currentCamera->position, currentCamera->view, currentCamera->up);
+	UBOC.view = glm::lookAt(currentCamera->RenderPosition(), currentCamera->renderView, currentCamera->up);
 	UBOC.model = glm::mat4(1.0f);
-	UBOC.cameraPos = currentCamera->position;
+	UBOC.cameraPos = currentCamera->RenderPosition();
 	m_UboClouds.copy(sizeof(UBOC), &UBOC);
 } 
 
 void Scene::UpdateSelectionIndicatorUniformBuffer() {
 	UBOSI.proj = glm::perspective(glm::radians(currentCamera->FOV), (float)p_SwapChain->getExtent().width / (float)p_SwapChain->getExtent().height, currentCamera->clippingNear, currentCamera->clippingFar);
 	UBOSI.proj[1][1] *= -1; 
-	UBOSI.view = glm::lookAt(currentCamera->position, currentCamera->view, currentCamera->up);
+	UBOSI.view = glm::lookAt(currentCamera->RenderPosition(), currentCamera->renderView, currentCamera->up);
 	UBOSI.model = glm::rotate(glm::mat4(1.0f), (float)mainClock->totalElapsedTime * glm::radians(90.0f), currentCamera->up);
-	UBOSI.cameraPos = glm::vec3(currentCamera->position);
+	UBOSI.cameraPos = glm::vec3(currentCamera->RenderPosition());
 	UBOSI.time = (float)mainClock->totalElapsedTime;
 	memcpy(m_UboSlectionIndicator.getMapped(), &UBOSI, sizeof(UBOSI));
 }
@@ -1244,9 +1617,9 @@ void Scene::UpdateSelectionIndicatorUniformBuffer() {
 void Scene::UpdateOffscreenUniformBuffer() {
 	UBOO.proj = glm::perspective(glm::radians(currentCamera->FOV), (float)p_SwapChain->getExtent().width / (float)p_SwapChain->getExtent().height, currentCamera->clippingNear, currentCamera->clippingFar);
 	UBOO.proj[1][1] *= -1; 
-	UBOO.view = glm::lookAt(currentCamera->position, currentCamera->view, currentCamera->up);
+	UBOO.view = glm::lookAt(currentCamera->RenderPosition(), currentCamera->renderView, currentCamera->up);
 	UBOO.model = glm::mat4(1.0f);
-	UBOO.cameraPos = glm::vec3(currentCamera->position);
+	UBOO.cameraPos = glm::vec3(currentCamera->RenderPosition());
 	memcpy(m_UboRefraction.getMapped(), &UBOO, sizeof(UBOO));
 	UBOO.view[1][0] *= -1;
 	UBOO.view[1][1] *= -1;
@@ -1256,9 +1629,14 @@ void Scene::UpdateOffscreenUniformBuffer() {
 }
 
 void Scene::UpdateUniformBufferParameters() {
-	UBOP.light_col = std::dynamic_pointer_cast<SphereLight>(actors[2])->GetLightColor();
+	const SphereLight* light = actorHandles.Get(sceneLightHandle);
+	if (light == nullptr) {
+		return;
+	}
+
+	UBOP.light_col = light->GetLightColor();
 	UBOP.exposure = 2.5f;
-	UBOP.light_pos[0] = actors[2]->position;
+	UBOP.light_pos[0] = light->RenderPosition();
 	memcpy(m_UboParameters.getMapped(), &UBOP, sizeof(UBOP));
 	memcpy(m_UboRefractionParameters.getMapped(), &UBOP, sizeof(UBOP));
 
@@ -1671,10 +2049,10 @@ void Scene::UpdateDynamicUniformBuffer() {
 
 	// Static positions for flame origins
 	static glm::vec3 flamePositions[4] = {
-		glm::vec3(mainCharacter->position.x - 5.0f, mainCharacter->position.y, mainCharacter->position.z - 5.0f), // Flame 1 position
-		glm::vec3(mainCharacter->position.x + 5.0f, mainCharacter->position.y, mainCharacter->position.z - 5.0f),  // Flame 2 position
-		glm::vec3(mainCharacter->position.x - 5.0f, mainCharacter->position.y, mainCharacter->position.z + 5.0f),  // Flame 3 position
-		glm::vec3(mainCharacter->position.x + 5.0f, mainCharacter->position.y, mainCharacter->position.z + 5.0f)    // Flame 4 position
+		glm::vec3(mainCharacter->Position().x - 5.0f, mainCharacter->Position().y, mainCharacter->Position().z - 5.0f), // Flame 1 position
+		glm::vec3(mainCharacter->Position().x + 5.0f, mainCharacter->Position().y, mainCharacter->Position().z - 5.0f),  // Flame 2 position
+		glm::vec3(mainCharacter->Position().x - 5.0f, mainCharacter->Position().y, mainCharacter->Position().z + 5.0f),  // Flame 3 position
+		glm::vec3(mainCharacter->Position().x + 5.0f, mainCharacter->Position().y, mainCharacter->Position().z + 5.0f)    // Flame 4 position
 	};
 
 	// Particle lifecycle timers
@@ -1743,7 +2121,7 @@ void Scene::UpdateDynamicUniformBuffer() {
 void Scene::UpdateSkyboxUniformBuffer() {
 	UBOSB.proj = glm::perspective(glm::radians(currentCamera->FOV), (float)p_SwapChain->getExtent().width / (float)p_SwapChain->getExtent().height, currentCamera->clippingNear, currentCamera->clippingFar);
 	UBOSB.proj[1][1] *= -1;
-	UBOSB.view = glm::lookAt(currentCamera->position, currentCamera->view, currentCamera->up);
+	UBOSB.view = glm::lookAt(currentCamera->RenderPosition(), currentCamera->renderView, currentCamera->up);
 	UBOSB.view[3][0] *= 0;
 	UBOSB.view[3][1] *= 0;
 	UBOSB.view[3][2] *= 0;
@@ -1762,8 +2140,8 @@ void Scene::UpdateOceanUniformBuffer() {
 	UBOSE.model = glm::mat4(1.0f);
 	UBOSE.proj = glm::perspective(glm::radians(currentCamera->FOV), (float)p_SwapChain->getExtent().width / (float)p_SwapChain->getExtent().height, currentCamera->clippingNear, currentCamera->clippingFar);
 	UBOSE.proj[1][1] *= -1;
-	UBOSE.view = glm::lookAt(currentCamera->position, currentCamera->view, currentCamera->up);
-	UBOSE.cameraPos = currentCamera->position;
+	UBOSE.view = glm::lookAt(currentCamera->RenderPosition(), currentCamera->renderView, currentCamera->up);
+	UBOSE.cameraPos = currentCamera->RenderPosition();
 	UBOSE.time = (float)mainClock->totalElapsedTime;
 	memcpy(m_UboOcean.getMapped(), &UBOSE, sizeof(UBOSE));
 }
@@ -2577,18 +2955,45 @@ void Scene::CreateSelectRay() {
 }
 
 void Scene::LoadAssets() {
+	PUFFIN_PROFILE_ZONE("Scene::LoadAssets");
 	InitMaterials();
 	CreateSelectRay();
 	PrepeareMainCharacter(m_MeshLibrary->meshes["sphere"]);
 	
 	// Scene objects/actors
 	CreateCloud("Test cloud", "Look, I am flying", glm::vec3(0.0f, 0.0f, 0.0f), m_MeshLibrary->meshes["sphere"]);
-	CreateSkybox("Test skybox", "Here must be green car, hello! Lorem Ipsum ;)", glm::vec3(0.0f, 0.0f, 0.0f), horizon);
-	CreateSea("Test sea", "I am part of terrain, hello!", glm::vec3(0.0f, 0.0f, 0.0f));
-	CreateLandscape("Test object amelinium teapot", "You can't paint this!", glm::vec3(-7.0f, 0.0f, 20.0f), m_MeshLibrary->meshes["teapot"], materialLibrary->materials["chrome"]);
+	skyboxHandle = CreateSkybox("Test skybox", "Here must be green car, hello! Lorem Ipsum ;)", glm::vec3(0.0f, 0.0f, 0.0f), horizon);
+	seaHandle = CreateSea("Test sea", "I am part of terrain, hello!", glm::vec3(0.0f, 0.0f, 0.0f));
 	CreateCamera("Test Camera", "Temporary object created for testing purpose", glm::vec3(30.0f, 40.0f, 3.0f), m_MeshLibrary->meshes["box"], materialLibrary->materials["default"]);
+
+	// PUFFIN_LOAD_SCENE=<file> takes the scenery from a snapshot instead of building it, PUFFIN_SAVE_SCENE=<file> writes it out
+	const char* loadPath = std::getenv("PUFFIN_LOAD_SCENE");
+	if (loadPath == nullptr || !LoadSnapshot(loadPath)) {
+		if (loadPath != nullptr) {
+			std::cerr << "could not load scene snapshot " << loadPath << std::endl;
+		}
+		CreateScenery();
+	}
+	// PUFFIN_LOAD_INSTANCES=<file> adds the static instance batches of an instance file on top of the scenery
+	if (const char* instancesPath = std::getenv("PUFFIN_LOAD_INSTANCES")) {
+		if (!LoadInstances(instancesPath)) {
+			std::cerr << "could not load instance file " << instancesPath << std::endl;
+		}
+	}
+	if (const char* savePath = std::getenv("PUFFIN_SAVE_SCENE")) {
+		if (!SaveSnapshot(savePath)) {
+			std::cerr << "could not save scene snapshot " << savePath << std::endl;
+		}
+	}
+
+	currentCamera = std::static_pointer_cast<Camera>(sceneCameras[0]); // only cameras go into sceneCameras
+	m_MousePicker->UpdateMousePicker(UBOSG.view, UBOSG.proj, currentCamera.get());
+}
+
+void Scene::CreateScenery() {
+	CreateLandscape("Test object amelinium teapot", "You can't paint this!", glm::vec3(-7.0f, 0.0f, 20.0f), m_MeshLibrary->meshes["teapot"], materialLibrary->materials["chrome"]);
 	CreateCharacter("Test Character", "Temporary object created for testing purpose", glm::vec3(20.0f, 20.0f,/*1968.5f*/ 10.0f), m_MeshLibrary->meshes["human"], materialLibrary->materials["character"]);
-	CreateSphereLight("Test Light", "Lorem ipsum light", glm::vec3(0.0f, 6.0f, 17.0f), m_MeshLibrary->meshes["sphere"]);
+	sceneLightHandle = CreateSphereLight("Test Light", "Lorem ipsum light", glm::vec3(0.0f, 6.0f, 17.0f), m_MeshLibrary->meshes["sphere"]);
 	
 	CreateLandscape("Test object plane", "I am simple plane, boring", glm::vec3(10.0f, -16.0f, -20.0f), m_MeshLibrary->meshes["plane"], materialLibrary->materials["rust"]);
 	CreateLandscape("Test object small green box ", "I am simple 10cm box, watch me", glm::vec3(15.0f, 7.0f, 2.0f), m_MeshLibrary->meshes["box"], materialLibrary->materials["plastic"]);
@@ -2613,70 +3018,279 @@ void Scene::LoadAssets() {
 	CreateLandscape("Visibility test post 12", "Do you see me?", glm::vec3(0.0f, 0.0f, 12000.0f), m_MeshLibrary->meshes["human"], materialLibrary->materials["default"]);
 
 	CreateLandscape("coin", "lorem ipsum", glm::vec3(0.0f, 50.0f, 100.0f), m_MeshLibrary->meshes["coin"], materialLibrary->materials["gold"]);
-			
-	currentCamera = std::dynamic_pointer_cast<Camera>(sceneCameras[0]);
-	m_MousePicker->UpdateMousePicker(UBOSG.view, UBOSG.proj, currentCamera);
 }
 
 void Scene::PrepeareMainCharacter(enginetool::ScenePart &mesh) {
-	mainCharacter = std::make_unique<MainCharacter>("Temp", "Brave hero", glm::vec3(0.0f, 0.0f, 0.0f), ActorType::MainCharacter, actors);
-	dynamic_cast<MainCharacter*>(mainCharacter.get())->Init(1000, 1000, 100);
+	mainCharacter = std::make_unique<MainCharacter>(actorNames.Intern("Temp"), actorNames.Intern("Brave hero"), glm::vec3(0.0f, 0.0f, 0.0f), ActorType::MainCharacter, actors, motionStore);
+	mainCharacter->Init(1000, 1000, 100);
+	world.Attach(*mainCharacter);
 	mainCharacter->assignedMesh = &mesh;
 	mainCharacter->assignedMaterial = &materialLibrary->materials["default"];
 }
 
-void Scene::CreateCamera(std::string name, std::string description, glm::vec3 position, enginetool::ScenePart &mesh, enginetool::SceneMaterial &material) {
-	std::shared_ptr<Actor> camera = std::make_shared<Camera>(name, description, position, ActorType::Camera, actors);
-	std::dynamic_pointer_cast<Camera>(camera)->Init(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 60.0f, 0.001f, 200000.0f, 3.14f, 0.0f);
+bool Scene::DestroyActor(enginetool::Handle<Actor> handle) {
+	return Despawn({ handle }) == 1;
+}
+
+size_t Scene::Despawn(const std::vector<enginetool::Handle<Actor>>& handles) {
+	return ActorRoster::Despawn(handles, { &visibleActors }, { &sceneCameras, &seas, &skyboxes, &clouds });
+}
+
+enginetool::InstanceBatch& Scene::FindInstanceBatch(const std::string& meshName, const std::string& materialName) {
+	for (auto& batch : instanceBatches) {
+		if (batch.meshName == meshName && batch.materialName == materialName) {
+			return batch;
+		}
+	}
+
+	// find, not operator[], so a typo does not quietly add an empty mesh or material to the libraries
+	auto mesh = m_MeshLibrary->meshes.find(meshName);
+	auto material = materialLibrary->materials.find(materialName);
+	if (mesh == m_MeshLibrary->meshes.end() || material == materialLibrary->materials.end()) {
+		throw std::runtime_error("instance batch refers to unknown mesh or material!");
+	}
+
+	enginetool::InstanceBatch batch;
+	batch.meshName = meshName;
+	batch.materialName = materialName;
+	batch.mesh = &mesh->second;
+	batch.material = &material->second;
+	instanceBatches.push_back(std::move(batch));
+	return instanceBatches.back();
+}
+
+void Scene::PlaceInstances(const std::string& meshName, const std::string& materialName, const std::vector<enginetool::InstanceLayout>& instances) {
+	FindInstanceBatch(meshName, materialName).Add(instances.data(), instances.size());
+}
+
+bool Scene::LoadInstances(const std::string& path) {
+	std::vector<enginetool::InstanceBatch> loaded;
+	if (!enginetool::instancing::Load(path, loaded)) {
+		return false;
+	}
+	for (const auto& batch : loaded) {
+		PlaceInstances(batch.meshName, batch.materialName, batch.instances);
+	}
+	return true;
+}
+
+bool Scene::SaveInstances(const std::string& path) const {
+	return enginetool::instancing::Save(path, instanceBatches);
+}
+
+bool Scene::SaveSnapshot(const std::string& path) {
+	PUFFIN_PROFILE_ZONE("Scene::SaveSnapshot");
+	std::unordered_map<const enginetool::ScenePart*, const std::string*> meshNames;
+	for (const auto& mesh : m_MeshLibrary->meshes) {
+		meshNames.emplace(&mesh.second, &mesh.first);
+	}
+	std::unordered_map<const enginetool::SceneMaterial*, const std::string*> materialNames;
+	for (const auto& material : materialLibrary->materials) {
+		materialNames.emplace(&material.second, &material.first);
+	}
+
+	const SphereLight* sceneLight = actorHandles.Get(sceneLightHandle);
+	enginetool::SceneSnapshotWriter writer;
+	for (const auto& a : actors) {
+		const ActorType type = a->GetType();
+		if (type != ActorType::Landscape && type != ActorType::SphereLight && type != ActorType::Character) {
+			continue;
+		}
+		auto mesh = meshNames.find(a->assignedMesh);
+		auto material = materialNames.find(a->assignedMaterial);
+		if (mesh == meshNames.end() || material == materialNames.end()) {
+			return false;
+		}
+
+		enginetool::snapshot::ActorRecord record = {};
+		record.type = static_cast<uint32_t>(type);
+		record.name = writer.AddString(actorNames.Lookup(a->name));
+		record.description = writer.AddString(actorNames.Lookup(a->GetDescription()));
+		record.mesh = writer.AddString(*mesh->second);
+		record.material = writer.AddString(*material->second);
+		const glm::vec3& position = a->Position();
+		record.position[0] = position.x;
+		record.position[1] = position.y;
+		record.position[2] = position.z;
+
+		if (type == ActorType::Landscape) {
+			const Landscape* landscape = static_cast<const Landscape*>(a.get());
+			record.maxHealth = landscape->maxHealth;
+			record.currentHealth = landscape->currentHealth;
+		}
+		else if (type == ActorType::Character) {
+			const Character* character = static_cast<const Character*>(a.get());
+			record.maxHealth = character->maxHealth;
+			record.currentHealth = character->currentHealth;
+			record.gold = character->gold;
+		}
+		else {
+			const glm::vec3 color = static_cast<const SphereLight*>(a.get())->GetLightColor();
+			record.lightColor[0] = color.x;
+			record.lightColor[1] = color.y;
+			record.lightColor[2] = color.z;
+			if (a.get() == sceneLight) {
+				writer.SetSceneLight(static_cast<uint32_t>(writer.GetActorCount()));
+			}
+		}
+		writer.AddActor(record);
+	}
+
+	for (const auto& batch : instanceBatches) {
+		writer.AddBatch(batch.meshName, batch.materialName, batch.instances.empty() ? nullptr : &batch.instances[0].pos.x, batch.instances.size());
+	}
+	return writer.Save(path);
+}
+
+bool Scene::LoadSnapshot(const std::string& path) {
+	PUFFIN_PROFILE_ZONE("Scene::LoadSnapshot");
+	enginetool::SceneSnapshot snapshot;
+	if (!snapshot.Open(path)) {
+		return false;
+	}
+	const enginetool::snapshot::Header& header = snapshot.GetHeader();
+	const enginetool::snapshot::ActorRecord* records = snapshot.GetActors();
+	const enginetool::snapshot::BatchRecord* batches = snapshot.GetBatches();
+
+	// Every reference is resolved before anything is created, so a snapshot made with other assets adds no half scene.
+	// Meshes and materials are looked up once per distinct name, not once per actor.
+	std::vector<enginetool::ScenePart*> meshes(header.stringCount, nullptr);
+	std::vector<enginetool::SceneMaterial*> materials(header.stringCount, nullptr);
+	auto resolve = [&](uint32_t mesh, uint32_t material) {
+		if (meshes[mesh] == nullptr) {
+			auto found = m_MeshLibrary->meshes.find(snapshot.GetString(mesh));
+			meshes[mesh] = (found != m_MeshLibrary->meshes.end()) ? &found->second : nullptr;
+		}
+		if (materials[material] == nullptr) {
+			auto found = materialLibrary->materials.find(snapshot.GetString(material));
+			materials[material] = (found != materialLibrary->materials.end()) ? &found->second : nullptr;
+		}
+		return meshes[mesh] != nullptr && materials[material] != nullptr;
+	};
+
+	std::map<ActorType, size_t> counts;
+	for (uint32_t i = 0; i < header.actorCount; i++) {
+		const ActorType type = static_cast<ActorType>(records[i].type);
+		if (type != ActorType::Landscape && type != ActorType::SphereLight && type != ActorType::Character) {
+			return false;
+		}
+		if (!resolve(records[i].mesh, records[i].material)) {
+			return false;
+		}
+		counts[type]++;
+	}
+	for (uint32_t i = 0; i < header.batchCount; i++) {
+		if (!resolve(batches[i].mesh, batches[i].material)) {
+			return false;
+		}
+	}
+
+	std::vector<enginetool::NameId> names(header.stringCount);
+	for (uint32_t i = 0; i < header.stringCount; i++) {
+		names[i] = actorNames.Intern(snapshot.GetString(i));
+	}
+
+	landscapePool.Reserve(counts[ActorType::Landscape]);
+	sphereLightPool.Reserve(counts[ActorType::SphereLight]);
+	characterPool.Reserve(counts[ActorType::Character]);
+	enginetool::ReserveMore(landscapeBucket, counts[ActorType::Landscape]);
+	enginetool::ReserveMore(sphereLightBucket, counts[ActorType::SphereLight]);
+	enginetool::ReserveMore(characterBucket, counts[ActorType::Character]);
+	for (const auto& count : counts) {
+		MotionStoreFor(count.first).Reserve(count.second);
+	}
+	enginetool::ReserveMore(actors, header.actorCount);
+
+	for (uint32_t i = 0; i < header.actorCount; i++) {
+		const enginetool::snapshot::ActorRecord& record = records[i];
+		const ActorType type = static_cast<ActorType>(record.type);
+		const glm::vec3 position(record.position[0], record.position[1], record.position[2]);
+		if (type == ActorType::Landscape) {
+			enginetool::Handle<Landscape> handle;
+			SpawnActor(landscapePool, type, names[record.name], names[record.description], position, *meshes[record.mesh], *materials[record.material], handle)->Init(record.maxHealth, record.currentHealth);
+		}
+		else if (type == ActorType::Character) {
+			enginetool::Handle<Character> handle;
+			SpawnActor(characterPool, type, names[record.name], names[record.description], position, *meshes[record.mesh], *materials[record.material], handle)->Init(record.maxHealth, record.currentHealth, record.gold);
+		}
+		else {
+			enginetool::Handle<SphereLight> handle;
+			SpawnActor(sphereLightPool, type, names[record.name], names[record.description], position, *meshes[record.mesh], *materials[record.material], handle)->SetLightColor(glm::vec3(record.lightColor[0], record.lightColor[1], record.lightColor[2]));
+			if (i == header.sceneLight) {
+				sceneLightHandle = handle;
+			}
+		}
+	}
+
+	// Positions in the file are packed like InstanceLayout, batches copy them straight out of the mapping
+	static_assert(sizeof(enginetool::InstanceLayout) == 3 * sizeof(float), "instance positions are stored as packed floats");
+	const enginetool::InstanceLayout* positions = reinterpret_cast<const enginetool::InstanceLayout*>(snapshot.GetInstancePositions());
+	for (uint32_t i = 0; i < header.batchCount; i++) {
+		enginetool::InstanceBatch& batch = FindInstanceBatch(snapshot.GetString(batches[i].mesh), snapshot.GetString(batches[i].material));
+		enginetool::ReserveMore(batch.instances, batches[i].instanceCount);
+		batch.Add(positions + batches[i].firstInstance, batches[i].instanceCount);
+	}
+	return true;
+}
+
+enginetool::Handle<Camera> Scene::CreateCamera(std::string name, std::string description, glm::vec3 position, enginetool::ScenePart &mesh, enginetool::SceneMaterial &material) {
+	std::shared_ptr<Camera> camera = std::make_shared<Camera>(actorNames.Intern(name), actorNames.Intern(description), position, ActorType::Camera, actors, motionStore);
+	camera->Init(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 60.0f, 0.001f, 200000.0f, 3.14f, 0.0f);
 	camera->assignedMesh = &mesh;
 	camera->assignedMaterial = &material; 
+	enginetool::Handle<Camera> handle = actorHandles.Insert(camera.get());
+	camera->handle = handle;
 	sceneCameras.emplace_back(std::move(camera));
+	return handle;
 }
 
-void Scene::CreateCharacter(std::string name, std::string description, glm::vec3 position, enginetool::ScenePart &mesh, enginetool::SceneMaterial &material) {
-	std::shared_ptr<Actor> character = std::make_shared<Character>(name, description, position, ActorType::Character, actors);
-	std::dynamic_pointer_cast<Character>(character)->Init(1000, 1000, 100);
-	character->assignedMesh = &mesh;
-	character->assignedMaterial = &material;
-	actors.emplace_back(std::move(character));
+enginetool::Handle<Character> Scene::CreateCharacter(std::string name, std::string description, glm::vec3 position, enginetool::ScenePart &mesh, enginetool::SceneMaterial &material) {
+	enginetool::Handle<Character> handle;
+	SpawnActor(characterPool, ActorType::Character, actorNames.Intern(name), actorNames.Intern(description), position, mesh, material, handle)->Init(1000, 1000, 100);
+	return handle;
 }
 
-void Scene::CreateSphereLight(std::string name, std::string description, glm::vec3 position, enginetool::ScenePart &mesh) {
-	std::shared_ptr<Actor> light = std::make_shared<SphereLight>(name, description, position, ActorType::SphereLight, actors);
-	std::dynamic_pointer_cast<SphereLight>(light)->SetLightColor(glm::vec3(255.0f, 197.0f, 143.0f));  //2600K 100W
-	light->assignedMesh = &mesh;
-	light->assignedMaterial = &materialLibrary->materials["default"];
-	actors.emplace_back(std::move(light));
+enginetool::Handle<SphereLight> Scene::CreateSphereLight(std::string name, std::string description, glm::vec3 position, enginetool::ScenePart &mesh) {
+	enginetool::Handle<SphereLight> handle;
+	SpawnActor(sphereLightPool, ActorType::SphereLight, actorNames.Intern(name), actorNames.Intern(description), position, mesh, materialLibrary->materials["default"], handle)->SetLightColor(glm::vec3(255.0f, 197.0f, 143.0f));  //2600K 100W
+	return handle;
 }
 
-void Scene::CreateLandscape(std::string name, std::string description, glm::vec3 position, enginetool::ScenePart &mesh, enginetool::SceneMaterial &material) {
-	std::shared_ptr<Actor> stillObject = std::make_shared<Landscape>(name, description, position, ActorType::Landscape, actors);
-	std::dynamic_pointer_cast<Landscape>(stillObject)->Init(1000, 1000);
-	stillObject->assignedMesh = &mesh;
-	stillObject->assignedMaterial = &material;
-	actors.emplace_back(std::move(stillObject));
+enginetool::Handle<Landscape> Scene::CreateLandscape(std::string name, std::string description, glm::vec3 position, enginetool::ScenePart &mesh, enginetool::SceneMaterial &material) {
+	enginetool::Handle<Landscape> handle;
+	SpawnActor(landscapePool, ActorType::Landscape, actorNames.Intern(name), actorNames.Intern(description), position, mesh, material, handle)->Init(1000, 1000);
+	return handle;
 }
 
-void Scene::CreateCloud(std::string name, std::string description, glm::vec3 position, enginetool::ScenePart &mesh) {
-	std::shared_ptr<Actor> cloud = std::make_shared<Cloud>(name, description, position, ActorType::Cloud, actors);
+enginetool::Handle<Cloud> Scene::CreateCloud(std::string name, std::string description, glm::vec3 position, enginetool::ScenePart &mesh) {
+	std::shared_ptr<Cloud> cloud = std::make_shared<Cloud>(actorNames.Intern(name), actorNames.Intern(description), position, ActorType::Cloud, actors, motionStore);
 	cloud->assignedMesh = &mesh;
+	enginetool::Handle<Cloud> handle = actorHandles.Insert(cloud.get());
+	cloud->handle = handle;
 	clouds.emplace_back(std::move(cloud));
+	return handle;
 }
 
-void Scene::CreateSea(std::string name, std::string description, glm::vec3 position) {
-	std::shared_ptr<Actor> sea = std::make_shared<Sea>(name, description, position, ActorType::Sea, actors);
-	std::dynamic_pointer_cast<Sea>(sea)->CreateMesh();
-	CreateVertexBuffer(std::dynamic_pointer_cast<Sea>(sea)->vertices, m_VertexBuffersOcean);
-	CreateIndexBuffer(std::dynamic_pointer_cast<Sea>(sea)->indices, m_IndexBuffersOcean);
+enginetool::Handle<Sea> Scene::CreateSea(std::string name, std::string description, glm::vec3 position) {
+	std::shared_ptr<Sea> sea = std::make_shared<Sea>(actorNames.Intern(name), actorNames.Intern(description), position, ActorType::Sea, actors, motionStore);
+	sea->CreateMesh();
+	CreateVertexBuffer(sea->vertices, m_VertexBuffersOcean);
+	CreateIndexBuffer(sea->indices, m_IndexBuffersOcean);
+	enginetool::Handle<Sea> handle = actorHandles.Insert(sea.get());
+	sea->handle = handle;
 	seas.emplace_back(std::move(sea));
+	return handle;
 }
 
-void Scene::CreateSkybox(std::string name, std::string description, glm::vec3 position, float horizon) {
-	std::shared_ptr<Actor> skybox = std::make_shared<Skybox>(name, description, position, ActorType::Skybox, actors, horizon);
-	std::dynamic_pointer_cast<Skybox>(skybox)->CreateMesh();
-	CreateVertexBuffer(std::dynamic_pointer_cast<Skybox>(skybox)->vertices, m_VertexBuffersSkybox);
-	CreateIndexBuffer(std::dynamic_pointer_cast<Skybox>(skybox)->indices, m_IndexBuffersSkybox);
+enginetool::Handle<Skybox> Scene::CreateSkybox(std::string name, std::string description, glm::vec3 position, float horizon) {
+	std::shared_ptr<Skybox> skybox = std::make_shared<Skybox>(actorNames.Intern(name), actorNames.Intern(description), position, ActorType::Skybox, actors, motionStore, horizon);
+	skybox->CreateMesh();
+	CreateVertexBuffer(skybox->vertices, m_VertexBuffersSkybox);
+	CreateIndexBuffer(skybox->indices, m_IndexBuffersSkybox);
+	enginetool::Handle<Skybox> handle = actorHandles.Insert(skybox.get());
+	skybox->handle = handle;
 	skyboxes.emplace_back(std::move(skybox));
+	return handle;
 }
 
 // ------------------ Buffers ---------------------- //
@@ -2788,15 +3402,15 @@ void Scene::MoveMainCharacterLeft() {mainCharacter->SetState(ActorState::WalkLef
 void Scene::MoveMainCharacterRight() {mainCharacter->SetState(ActorState::WalkRight);}
 void Scene::StopMainCharacter() {mainCharacter->SetState(ActorState::Idle);}
 
-void Scene::MoveSelectedActorForward() {if (selectedActor!=nullptr) {selectedActor->onManualControl(); selectedActor->Dolly(150.0f);}}
-void Scene::MoveSelectedActorBackward() {if (selectedActor!=nullptr) {selectedActor->onManualControl(); selectedActor->Dolly(-150.0f);}}
-void Scene::StopSelectedActorForwardBackward() {if (selectedActor!=nullptr) {selectedActor->offManualControl(); selectedActor->Dolly(0.0f);}}
-void Scene::MoveSelectedActorLeft() {if (selectedActor!=nullptr) {selectedActor->onManualControl(); selectedActor->Strafe(-150.0f);}}
-void Scene::MoveSelectedActorRight() {if (selectedActor!=nullptr) {selectedActor->onManualControl(); selectedActor->Strafe(150.0f); }}
-void Scene::StopSelectedActorLeftRight() {if (selectedActor!=nullptr) {selectedActor->offManualControl(); selectedActor->Strafe(0.0f);}}
-void Scene::MoveSelectedActorUp() {if (selectedActor!=nullptr) {selectedActor->onManualControl(); selectedActor->Pedestal(150.0f);}}
-void Scene::MoveSelectedActorDown() {if (selectedActor!=nullptr) {selectedActor->onManualControl(); selectedActor->Pedestal(-150.0f);}}
-void Scene::StopSelectedActorUpDown() {if (selectedActor!=nullptr) {selectedActor->offManualControl(); selectedActor->Strafe(0.0f);}}
+void Scene::MoveSelectedActorForward() {if (Actor* selected = actorHandles.Get(selectedActor)) {selected->onManualControl(); selected->Dolly(150.0f);}}
+void Scene::MoveSelectedActorBackward() {if (Actor* selected = actorHandles.Get(selectedActor)) {selected->onManualControl(); selected->Dolly(-150.0f);}}
+void Scene::StopSelectedActorForwardBackward() {if (Actor* selected = actorHandles.Get(selectedActor)) {selected->offManualControl(); selected->Dolly(0.0f);}}
+void Scene::MoveSelectedActorLeft() {if (Actor* selected = actorHandles.Get(selectedActor)) {selected->onManualControl(); selected->Strafe(-150.0f);}}
+void Scene::MoveSelectedActorRight() {if (Actor* selected = actorHandles.Get(selectedActor)) {selected->onManualControl(); selected->Strafe(150.0f); }}
+void Scene::StopSelectedActorLeftRight() {if (Actor* selected = actorHandles.Get(selectedActor)) {selected->offManualControl(); selected->Strafe(0.0f);}}
+void Scene::MoveSelectedActorUp() {if (Actor* selected = actorHandles.Get(selectedActor)) {selected->onManualControl(); selected->Pedestal(150.0f);}}
+void Scene::MoveSelectedActorDown() {if (Actor* selected = actorHandles.Get(selectedActor)) {selected->onManualControl(); selected->Pedestal(-150.0f);}}
+void Scene::StopSelectedActorUpDown() {if (Actor* selected = actorHandles.Get(selectedActor)) {selected->offManualControl(); selected->Strafe(0.0f);}}
 
 void Scene::WireframeToggle() {displayWireframe = !displayWireframe;}
 void Scene::AabbToggle() {displayAabb = !displayAabb;}
@@ -0,0 +1,224 @@
+#include <cstring>
+#include <fstream>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "headers/SceneSnapshot.hpp"
+
+using namespace enginetool;
+
+namespace {
+	uint32_t Align(size_t offset) {
+		return static_cast<uint32_t>((offset + 3) & ~size_t(3));
+	}
+
+	template<typename T>
+	void WriteBlock(std::ostream& stream, const std::vector<T>& block, uint32_t offset) {
+		while (static_cast<uint32_t>(stream.tellp()) < offset) {
+			stream.put('\0');
+		}
+		if (!block.empty()) {
+			stream.write(reinterpret_cast<const char*>(block.data()), block.size() * sizeof(T));
+		}
+	}
+}
+
+// ---------------- Writing ------------------------- //
+
+uint32_t SceneSnapshotWriter::AddString(const std::string& text) {
+	auto found = stringIndices.find(text);
+	if (found != stringIndices.end()) {
+		return found->second;
+	}
+
+	const uint32_t index = static_cast<uint32_t>(stringTable.size());
+	stringTable.push_back(static_cast<uint32_t>(characters.size()));
+	characters.append(text);
+	characters.push_back('\0');
+	stringIndices.emplace(text, index);
+	return index;
+}
+
+void SceneSnapshotWriter::AddActor(const snapshot::ActorRecord& actor) {
+	actors.push_back(actor);
+}
+
+void SceneSnapshotWriter::AddBatch(const std::string& mesh, const std::string& material, const float* positions, size_t instanceCount) {
+	snapshot::BatchRecord batch;
+	batch.mesh = AddString(mesh);
+	batch.material = AddString(material);
+	batch.firstInstance = static_cast<uint32_t>(this->positions.size() / 3);
+	batch.instanceCount = static_cast<uint32_t>(instanceCount);
+	this->positions.insert(this->positions.end(), positions, positions + instanceCount * 3);
+	batches.push_back(batch);
+}
+
+bool SceneSnapshotWriter::Save(const std::string& path) const {
+	snapshot::Header header = {};
+	std::memcpy(header.magic, snapshot::magic, sizeof(header.magic));
+	header.version = snapshot::fileVersion;
+	header.headerSize = sizeof(snapshot::Header);
+	header.byteOrder = snapshot::byteOrderMark;
+	header.actorCount = static_cast<uint32_t>(actors.size());
+	header.actorsOffset = Align(sizeof(snapshot::Header));
+	header.batchCount = static_cast<uint32_t>(batches.size());
+	header.batchesOffset = Align(header.actorsOffset + actors.size() * sizeof(snapshot::ActorRecord));
+	header.instanceCount = static_cast<uint32_t>(positions.size() / 3);
+	header.instancesOffset = Align(header.batchesOffset + batches.size() * sizeof(snapshot::BatchRecord));
+	header.stringCount = static_cast<uint32_t>(stringTable.size());
+	header.stringTableOffset = Align(header.instancesOffset + positions.size() * sizeof(float));
+	header.charactersSize = static_cast<uint32_t>(characters.size());
+	header.charactersOffset = Align(header.stringTableOffset + stringTable.size() * sizeof(uint32_t));
+	header.sceneLight = sceneLight;
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	WriteBlock(file, actors, header.actorsOffset);
+	WriteBlock(file, batches, header.batchesOffset);
+	WriteBlock(file, positions, header.instancesOffset);
+	WriteBlock(file, stringTable, header.stringTableOffset);
+	WriteBlock(file, std::vector<char>(characters.begin(), characters.end()), header.charactersOffset);
+	return static_cast<bool>(file);
+}
+
+// ---------------- Reading ------------------------- //
+
+SceneSnapshot::~SceneSnapshot() {
+	Close();
+}
+
+bool SceneSnapshot::Open(const std::string& path) {
+	Close();
+
+#ifdef __linux__
+	const int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	struct stat status;
+	if (fstat(fd, &status) == 0 && status.st_size >= static_cast<off_t>(sizeof(snapshot::Header))) {
+		void* view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (view != MAP_FAILED) {
+			data = static_cast<const char*>(view);
+			size = static_cast<size_t>(status.st_size);
+			mapped = true;
+		}
+	}
+	close(fd);
+#endif
+
+	if (!data) {
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file.is_open()) {
+			return false;
+		}
+		buffer.resize(static_cast<size_t>(file.tellg()));
+		file.seekg(0);
+		if (!file.read(buffer.data(), buffer.size())) {
+			buffer.clear();
+			return false;
+		}
+		data = buffer.data();
+		size = buffer.size();
+	}
+
+	if (!Validate()) {
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void SceneSnapshot::Close() {
+#ifdef __linux__
+	if (mapped) {
+		munmap(const_cast<char*>(data), size);
+	}
+#endif
+	data = nullptr;
+	size = 0;
+	mapped = false;
+	buffer.clear();
+	buffer.shrink_to_fit();
+}
+
+bool SceneSnapshot::Validate() const {
+	if (size < sizeof(snapshot::Header)) {
+		return false;
+	}
+
+	const snapshot::Header& header = GetHeader();
+	if (std::memcmp(header.magic, snapshot::magic, sizeof(header.magic)) != 0 || header.version != snapshot::fileVersion
+		|| header.headerSize != sizeof(snapshot::Header) || header.byteOrder != snapshot::byteOrderMark) {
+		return false;
+	}
+
+	// Offsets and counts are 32 bit, so none of these products overflow 64 bit sums
+	auto fits = [this](uint64_t offset, uint64_t bytes) { return offset % 4 == 0 && offset + bytes <= size; };
+	if (!fits(header.actorsOffset, uint64_t(header.actorCount) * sizeof(snapshot::ActorRecord))
+		|| !fits(header.batchesOffset, uint64_t(header.batchCount) * sizeof(snapshot::BatchRecord))
+		|| !fits(header.instancesOffset, uint64_t(header.instanceCount) * 3 * sizeof(float))
+		|| !fits(header.stringTableOffset, uint64_t(header.stringCount) * sizeof(uint32_t))
+		|| !fits(header.charactersOffset, header.charactersSize)) {
+		return false;
+	}
+	// With a terminator at the very end, every string that starts inside the characters also ends there
+	if (header.charactersSize > 0 && data[header.charactersOffset + header.charactersSize - 1] != '\0') {
+		return false;
+	}
+	const uint32_t* stringTable = reinterpret_cast<const uint32_t*>(data + header.stringTableOffset);
+	for (uint32_t i = 0; i < header.stringCount; i++) {
+		if (stringTable[i] >= header.charactersSize) {
+			return false;
+		}
+	}
+	if (header.sceneLight != snapshot::none && header.sceneLight >= header.actorCount) {
+		return false;
+	}
+
+	const snapshot::ActorRecord* actors = GetActors();
+	for (uint32_t i = 0; i < header.actorCount; i++) {
+		if (!GetString(actors[i].name) || !GetString(actors[i].description) || !GetString(actors[i].mesh) || !GetString(actors[i].material)) {
+			return false;
+		}
+	}
+	const snapshot::BatchRecord* batches = GetBatches();
+	for (uint32_t i = 0; i < header.batchCount; i++) {
+		if (!GetString(batches[i].mesh) || !GetString(batches[i].material)
+			|| uint64_t(batches[i].firstInstance) + batches[i].instanceCount > header.instanceCount) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// ---------------- Records ------------------------- //
+
+const snapshot::ActorRecord* SceneSnapshot::GetActors() const {
+	return reinterpret_cast<const snapshot::ActorRecord*>(data + GetHeader().actorsOffset);
+}
+
+const snapshot::BatchRecord* SceneSnapshot::GetBatches() const {
+	return reinterpret_cast<const snapshot::BatchRecord*>(data + GetHeader().batchesOffset);
+}
+
+const float* SceneSnapshot::GetInstancePositions() const {
+	return reinterpret_cast<const float*>(data + GetHeader().instancesOffset);
+}
+
+const char* SceneSnapshot::GetString(uint32_t index) const {
+	const snapshot::Header& header = GetHeader();
+	if (index >= header.stringCount) {
+		return nullptr;
+	}
+	return data + header.charactersOffset + reinterpret_cast<const uint32_t*>(data + header.stringTableOffset)[index];
+}
\ No newline at end of file
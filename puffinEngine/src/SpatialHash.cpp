@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <cmath>
+
+#include "headers/SpatialHash.hpp"
+
+using namespace enginetool;
+
+namespace {
+	// Far beyond any scene, and far enough from the int32 limits that cell arithmetic never overflows
+	const float cellLimit = 1.0e9f;
+
+	int32_t ToCell(float value, float inverseCellSize) {
+		float cell = std::floor(value * inverseCellSize);
+		if (!(cell > -cellLimit)) cell = -cellLimit; // NaN lands here as well
+		if (cell > cellLimit) cell = cellLimit;
+		return static_cast<int32_t>(cell);
+	}
+}
+
+SpatialHash::SpatialHash(float cellSize) {
+	SetCellSize(cellSize);
+}
+
+void SpatialHash::SetCellSize(float size) {
+	cellSize = size;
+	inverseCellSize = 1.0f / size;
+}
+
+// ---------------- Building ------------------------ //
+
+void SpatialHash::Clear() {
+	ids.clear();
+	ranges.clear();
+	largeBoxes.clear();
+	entries.clear();
+	slotStarts.clear();
+	slotMask = 0;
+}
+
+void SpatialHash::Insert(uint32_t id, const float* min, const float* max) {
+	ids.push_back(id);
+	ranges.push_back(ToCells(min, max));
+}
+
+void SpatialHash::Build() {
+	entries.clear();
+	largeBoxes.clear();
+
+	size_t entryCount = 0;
+	for (uint32_t box = 0; box < ranges.size(); box++) {
+		const uint64_t cells = CellCount(ranges[box]);
+		if (cells > maxCellsPerBox) {
+			largeBoxes.push_back(box);
+		}
+		else {
+			entryCount += static_cast<size_t>(cells);
+		}
+	}
+
+	// At least twice as many slots as entries keeps unrelated cells from sharing a slot most of the time
+	uint32_t slotCount = 16;
+	while (slotCount < entryCount * 2) slotCount *= 2;
+	slotMask = slotCount - 1;
+
+	// Counting sort by slot: count, prefix sum, scatter
+	slotStarts.assign(slotCount + 1, 0);
+	entries.resize(entryCount);
+	auto forEachCell = [this](uint32_t box, auto&& body) {
+		const CellRange& range = ranges[box];
+		int32_t cell[3];
+		for (cell[0] = range.min[0]; cell[0] <= range.max[0]; cell[0]++) {
+			for (cell[1] = range.min[1]; cell[1] <= range.max[1]; cell[1]++) {
+				for (cell[2] = range.min[2]; cell[2] <= range.max[2]; cell[2]++) {
+					body(cell);
+				}
+			}
+		}
+	};
+	size_t large = 0;
+	for (uint32_t box = 0; box < ranges.size(); box++) {
+		if (large < largeBoxes.size() && largeBoxes[large] == box) {
+			large++;
+			continue;
+		}
+		forEachCell(box, [this](const int32_t* cell) { slotStarts[Slot(cell) + 1]++; });
+	}
+	for (uint32_t slot = 0; slot < slotCount; slot++) {
+		slotStarts[slot + 1] += slotStarts[slot];
+	}
+	std::vector<uint32_t> next(slotStarts.begin(), slotStarts.end() - 1);
+	large = 0;
+	for (uint32_t box = 0; box < ranges.size(); box++) {
+		if (large < largeBoxes.size() && largeBoxes[large] == box) {
+			large++;
+			continue;
+		}
+		forEachCell(box, [&](const int32_t* cell) {
+			Entry& entry = entries[next[Slot(cell)]++];
+			entry.box = box;
+			std::copy(cell, cell + 3, entry.cell);
+		});
+	}
+}
+
+// ---------------- Queries ------------------------- //
+
+void SpatialHash::Query(const float* min, const float* max, std::vector<uint32_t>& candidates) const {
+	const CellRange query = ToCells(min, max);
+	for (uint32_t box : largeBoxes) {
+		if (Overlaps(query, ranges[box])) {
+			candidates.push_back(ids[box]);
+		}
+	}
+	if (entries.empty()) {
+		return;
+	}
+
+	// A query as large as a large box would visit more cells than there are entries, so it walks the entries instead
+	if (CellCount(query) > entries.size()) {
+		for (const Entry& entry : entries) {
+			if (Overlaps(query, ranges[entry.box]) && IsFirstSharedCell(query, ranges[entry.box], entry.cell)) {
+				candidates.push_back(ids[entry.box]);
+			}
+		}
+		return;
+	}
+
+	int32_t cell[3];
+	for (cell[0] = query.min[0]; cell[0] <= query.max[0]; cell[0]++) {
+		for (cell[1] = query.min[1]; cell[1] <= query.max[1]; cell[1]++) {
+			for (cell[2] = query.min[2]; cell[2] <= query.max[2]; cell[2]++) {
+				const uint32_t slot = Slot(cell);
+				for (uint32_t i = slotStarts[slot]; i < slotStarts[slot + 1]; i++) {
+					const Entry& entry = entries[i];
+					if (std::equal(cell, cell + 3, entry.cell) && IsFirstSharedCell(query, ranges[entry.box], cell)) {
+						candidates.push_back(ids[entry.box]);
+					}
+				}
+			}
+		}
+	}
+}
+
+void SpatialHash::FindPairs(std::vector<std::pair<uint32_t, uint32_t>>& pairs) const {
+	FindPairs(pairs, 0, 1);
+}
+
+void SpatialHash::FindPairs(std::vector<std::pair<uint32_t, uint32_t>>& pairs, uint32_t part, uint32_t partCount) const {
+	auto add = [this, &pairs](uint32_t a, uint32_t b) {
+		pairs.emplace_back(std::min(ids[a], ids[b]), std::max(ids[a], ids[b]));
+	};
+	// Part p takes the p-th share of the slots and of the large boxes
+	auto share = [partCount](size_t count, uint32_t p) {
+		return static_cast<size_t>(static_cast<uint64_t>(count) * p / partCount);
+	};
+
+	const size_t slotCount = slotStarts.empty() ? 0 : slotStarts.size() - 1;
+	for (size_t slot = share(slotCount, part); slot < share(slotCount, part + 1); slot++) {
+		for (uint32_t i = slotStarts[slot]; i < slotStarts[slot + 1]; i++) {
+			const Entry& a = entries[i];
+			for (uint32_t j = i + 1; j < slotStarts[slot + 1]; j++) {
+				const Entry& b = entries[j];
+				if (std::equal(a.cell, a.cell + 3, b.cell) && IsFirstSharedCell(ranges[a.box], ranges[b.box], a.cell)) {
+					add(a.box, b.box);
+				}
+			}
+		}
+	}
+
+	// Large boxes are few, so testing them against every box stays linear
+	for (size_t i = share(largeBoxes.size(), part); i < share(largeBoxes.size(), part + 1); i++) {
+		const uint32_t large = largeBoxes[i];
+		for (uint32_t box = 0; box < ranges.size(); box++) {
+			const bool otherLarge = std::binary_search(largeBoxes.begin(), largeBoxes.end(), box);
+			if (box == large || (otherLarge && box < large)) {
+				continue;
+			}
+			if (Overlaps(ranges[large], ranges[box])) {
+				add(large, box);
+			}
+		}
+	}
+}
+
+// ---------------- Cells --------------------------- //
+
+SpatialHash::CellRange SpatialHash::ToCells(const float* min, const float* max) const {
+	CellRange range;
+	for (int axis = 0; axis < 3; axis++) {
+		range.min[axis] = ToCell(min[axis], inverseCellSize);
+		range.max[axis] = std::max(range.min[axis], ToCell(max[axis], inverseCellSize));
+	}
+	return range;
+}
+
+uint64_t SpatialHash::CellCount(const CellRange& range) {
+	// Stops growing once past any entry count, so ranges near the cell limit cannot overflow
+	uint64_t count = 1;
+	for (int axis = 0; axis < 3 && count <= UINT32_MAX; axis++) {
+		count *= static_cast<uint64_t>(range.max[axis] - range.min[axis]) + 1;
+	}
+	return count;
+}
+
+uint32_t SpatialHash::Slot(const int32_t* cell) const {
+	const uint32_t hash = (static_cast<uint32_t>(cell[0]) * 73856093u) ^ (static_cast<uint32_t>(cell[1]) * 19349663u) ^ (static_cast<uint32_t>(cell[2]) * 83492791u);
+	return hash & slotMask;
+}
+
+bool SpatialHash::IsFirstSharedCell(const CellRange& a, const CellRange& b, const int32_t* cell) {
+	for (int axis = 0; axis < 3; axis++) {
+		if (cell[axis] != std::max(a.min[axis], b.min[axis])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool SpatialHash::Overlaps(const CellRange& a, const CellRange& b) {
+	for (int axis = 0; axis < 3; axis++) {
+		if (a.max[axis] < b.min[axis] || b.max[axis] < a.min[axis]) {
+			return false;
+		}
+	}
+	return true;
+}
\ No newline at end of file
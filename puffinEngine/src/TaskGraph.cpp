@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <iostream>
+
+#include "headers/TaskGraph.hpp"
+
+using namespace enginetool;
+
+// ------- Constructors and dectructors ------------- //
+
+TaskGraph::TaskGraph() {
+#if DEBUG_VERSION
+	std::cout << "Task graph created\n";
+#endif 
+}
+
+TaskGraph::~TaskGraph() {
+#if DEBUG_VERSION
+	std::cout << "Task graph destroyed\n";
+#endif 
+}
+
+// ---------------- Main functions ------------------ //
+
+uint32_t TaskGraph::AddTask(const std::string& name, std::function<void()> function, const std::vector<std::string>& reads, const std::vector<std::string>& writes) {
+	const uint32_t index = static_cast<uint32_t>(tasks.size());
+
+	Task task;
+	task.name = name;
+	task.function = std::move(function);
+	task.reads = reads;
+	task.writes = writes;
+
+	// read after write
+	for (const auto& resource : reads) {
+		const ResourceState& state = resources[resource];
+		if (state.lastWriter >= 0) {
+			task.dependencies.push_back(static_cast<uint32_t>(state.lastWriter));
+		}
+	}
+
+	// write after write and write after read
+	for (const auto& resource : writes) {
+		const ResourceState& state = resources[resource];
+		if (state.lastWriter >= 0) {
+			task.dependencies.push_back(static_cast<uint32_t>(state.lastWriter));
+		}
+		task.dependencies.insert(task.dependencies.end(), state.readersSinceWrite.begin(), state.readersSinceWrite.end());
+	}
+
+	std::sort(task.dependencies.begin(), task.dependencies.end());
+	task.dependencies.erase(std::unique(task.dependencies.begin(), task.dependencies.end()), task.dependencies.end());
+
+	for (const auto& resource : reads) {
+		resources[resource].readersSinceWrite.push_back(index);
+	}
+
+	for (const auto& resource : writes) {
+		ResourceState& state = resources[resource];
+		state.lastWriter = index;
+		state.readersSinceWrite.clear();
+	}
+
+	for (const auto dependency : task.dependencies) {
+		tasks[dependency].successors.push_back(index);
+	}
+
+	tasks.push_back(std::move(task));
+	return index;
+}
+
+void TaskGraph::Clear() {
+	tasks.clear();
+	resources.clear();
+}
+
+void TaskGraph::Run(ThreadPool* threadPool) {
+	// Tasks are only allowed to depend on earlier ones, so insertion order is always a valid serial schedule.
+	if (!threadPool || threadPool->threads.empty()) {
+		for (auto& task : tasks) {
+			PUFFIN_PROFILE_ZONE(task.name.c_str());
+			task.function();
+		}
+		return;
+	}
+
+	if (pendingCapacity < tasks.size()) {
+		pendingDependencies.reset(new std::atomic<uint32_t>[tasks.size()]);
+		pendingCapacity = tasks.size();
+	}
+
+	for (size_t i = 0; i < tasks.size(); i++) {
+		pendingDependencies[i].store(static_cast<uint32_t>(tasks[i].dependencies.size()), std::memory_order_relaxed);
+	}
+
+	// Jobs capture one pointer and an index, small enough for std::function to keep them off the heap.
+	JobCounter counter;
+	RunContext context = { this, threadPool, &counter };
+	for (uint32_t i = 0; i < static_cast<uint32_t>(tasks.size()); i++) {
+		if (tasks[i].dependencies.empty()) {
+			const RunContext* shared = &context;
+			threadPool->Submit([shared, i]() { shared->graph->RunTask(i, *shared); }, counter);
+		}
+	}
+
+	threadPool->Wait(counter);
+}
+
+void TaskGraph::RunTask(uint32_t task, const RunContext& context) {
+	{
+		PUFFIN_PROFILE_ZONE(tasks[task].name.c_str());
+		tasks[task].function();
+	}
+
+	// Successors are submitted before this job finishes, so the counter cannot reach zero in between.
+	for (const auto successor : tasks[task].successors) {
+		if (pendingDependencies[successor].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			const RunContext* shared = &context;
+			context.threadPool->Submit([shared, successor]() { shared->graph->RunTask(successor, *shared); }, *context.counter);
+		}
+	}
+}
+
+// ------------------ Inspection -------------------- //
+
+void TaskGraph::DumpGraphviz(std::ostream& stream) const {
+	stream << "digraph TaskGraph {\n";
+	stream << "\trankdir=LR;\n";
+	stream << "\tnode [shape=box];\n";
+
+	for (size_t i = 0; i < tasks.size(); i++) {
+		stream << "\tt" << i << " [label=\"" << tasks[i].name;
+		if (!tasks[i].reads.empty()) {
+			stream << "\\nreads:";
+			for (const auto& resource : tasks[i].reads) stream << " " << resource;
+		}
+		if (!tasks[i].writes.empty()) {
+			stream << "\\nwrites:";
+			for (const auto& resource : tasks[i].writes) stream << " " << resource;
+		}
+		stream << "\"];\n";
+	}
+
+	for (uint32_t i = 0; i < static_cast<uint32_t>(tasks.size()); i++) {
+		for (const auto dependency : tasks[i].dependencies) {
+			stream << "\tt" << dependency << " -> t" << i << " [label=\"" << DescribeEdge(dependency, i) << "\"];\n";
+		}
+	}
+
+	stream << "}\n";
+}
+
+std::string TaskGraph::DescribeEdge(uint32_t from, uint32_t to) const {
+	std::string label;
+	auto contains = [](const std::vector<std::string>& list, const std::string& resource) {
+		return std::find(list.begin(), list.end(), resource) != list.end();
+	};
+
+	for (const auto& resource : tasks[from].writes) {
+		if (contains(tasks[to].reads, resource) || contains(tasks[to].writes, resource)) {
+			label += label.empty() ? resource : ", " + resource;
+		}
+	}
+
+	for (const auto& resource : tasks[from].reads) {
+		if (contains(tasks[to].writes, resource) && !contains(tasks[from].writes, resource)) {
+			label += label.empty() ? resource : ", " + resource;
+		}
+	}
+
+	return label;
+}
@@ -0,0 +1,350 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <numeric>
+
+#include "headers/TriangleBvh.hpp"
+
+using namespace enginetool;
+
+namespace {
+	const char bvhMagic[4] = { 'P', 'B', 'V', 'H' };
+	const uint32_t bvhVersion = 1;
+
+	void Empty(float* min, float* max) {
+		std::fill(min, min + 3, std::numeric_limits<float>::max());
+		std::fill(max, max + 3, std::numeric_limits<float>::lowest());
+	}
+
+	void Grow(float* min, float* max, const float* point) {
+		for (int axis = 0; axis < 3; axis++) {
+			min[axis] = std::min(min[axis], point[axis]);
+			max[axis] = std::max(max[axis], point[axis]);
+		}
+	}
+
+	void GrowTriangle(float* min, float* max, const float* corners) {
+		for (int corner = 0; corner < 3; corner++) Grow(min, max, corners + corner * 3);
+	}
+
+	float HalfArea(const float* min, const float* max) {
+		const float x = max[0] - min[0];
+		const float y = max[1] - min[1];
+		const float z = max[2] - min[2];
+		return x * y + y * z + z * x;
+	}
+
+	// Slab test of the part of the ray in [minDistance, maxDistance]
+	bool HitsBox(const float* min, const float* max, const float* origin, const float* dirFrac, float minDistance, float maxDistance, float& enter) {
+		float tmin = minDistance, tmax = maxDistance;
+		for (int axis = 0; axis < 3; axis++) {
+			const float t1 = (min[axis] - origin[axis]) * dirFrac[axis];
+			const float t2 = (max[axis] - origin[axis]) * dirFrac[axis];
+			tmin = std::max(tmin, std::min(t1, t2));
+			tmax = std::min(tmax, std::max(t1, t2));
+		}
+		enter = tmin;
+		return tmin <= tmax;
+	}
+
+	// Moller-Trumbore, both faces
+	bool HitsTriangle(const float* corners, const float* origin, const float* direction, float& distance) {
+		float edge1[3], edge2[3], fromCorner[3];
+		for (int axis = 0; axis < 3; axis++) {
+			edge1[axis] = corners[3 + axis] - corners[axis];
+			edge2[axis] = corners[6 + axis] - corners[axis];
+			fromCorner[axis] = origin[axis] - corners[axis];
+		}
+		const float p[3] = { direction[1] * edge2[2] - direction[2] * edge2[1], direction[2] * edge2[0] - direction[0] * edge2[2], direction[0] * edge2[1] - direction[1] * edge2[0] };
+		const float determinant = edge1[0] * p[0] + edge1[1] * p[1] + edge1[2] * p[2];
+		if (determinant == 0.0f) {
+			return false; // the ray runs along the triangle's plane
+		}
+		const float inverse = 1.0f / determinant;
+		const float u = (fromCorner[0] * p[0] + fromCorner[1] * p[1] + fromCorner[2] * p[2]) * inverse;
+		if (u < 0.0f || u > 1.0f) {
+			return false;
+		}
+		const float q[3] = { fromCorner[1] * edge1[2] - fromCorner[2] * edge1[1], fromCorner[2] * edge1[0] - fromCorner[0] * edge1[2], fromCorner[0] * edge1[1] - fromCorner[1] * edge1[0] };
+		const float v = (direction[0] * q[0] + direction[1] * q[1] + direction[2] * q[2]) * inverse;
+		if (v < 0.0f || u + v > 1.0f) {
+			return false;
+		}
+		distance = (edge2[0] * q[0] + edge2[1] * q[1] + edge2[2] * q[2]) * inverse;
+		return true;
+	}
+}
+
+// ---------------- Building ------------------------ //
+
+std::vector<float> TriangleBvh::GatherCorners(const float* positions, size_t stride, const uint32_t* indices, size_t indexCount) {
+	std::vector<float> gathered;
+	gathered.reserve(indexCount / 3 * 9);
+	for (size_t i = 0; i < indexCount / 3 * 3; i++) {
+		const float* position = reinterpret_cast<const float*>(reinterpret_cast<const char*>(positions) + indices[i] * stride);
+		gathered.insert(gathered.end(), position, position + 3);
+	}
+	return gathered;
+}
+
+// FNV-1a over the bytes of the corners
+uint64_t TriangleBvh::Hash(const std::vector<float>& corners) {
+	uint64_t hash = 14695981039346656037ull;
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(corners.data());
+	for (size_t i = 0; i < corners.size() * sizeof(float); i++) {
+		hash = (hash ^ bytes[i]) * 1099511628211ull;
+	}
+	return hash;
+}
+
+void TriangleBvh::Build(const float* positions, size_t stride, const uint32_t* indices, size_t indexCount) {
+	nodes.clear();
+	corners = GatherCorners(positions, stride, indices, indexCount);
+	sourceHash = Hash(corners);
+	const uint32_t triangleCount = static_cast<uint32_t>(GetTriangleCount());
+	if (triangleCount == 0) {
+		return;
+	}
+
+	std::vector<float> centroids(triangleCount * 3);
+	for (uint32_t i = 0; i < triangleCount; i++) {
+		for (int axis = 0; axis < 3; axis++) {
+			centroids[i * 3 + axis] = (corners[i * 9 + axis] + corners[i * 9 + 3 + axis] + corners[i * 9 + 6 + axis]) / 3.0f;
+		}
+	}
+	std::vector<uint32_t> order(triangleCount);
+	std::iota(order.begin(), order.end(), 0);
+	nodes.reserve(triangleCount * 2);
+	BuildNode(order, centroids, 0, triangleCount);
+
+	std::vector<float> sorted(corners.size());
+	for (uint32_t i = 0; i < triangleCount; i++) {
+		std::copy(corners.begin() + order[i] * 9, corners.begin() + order[i] * 9 + 9, sorted.begin() + i * 9);
+	}
+	corners.swap(sorted);
+}
+
+void TriangleBvh::BuildNode(std::vector<uint32_t>& order, const std::vector<float>& centroids, uint32_t first, uint32_t count) {
+	const uint32_t index = static_cast<uint32_t>(nodes.size());
+	nodes.emplace_back();
+
+	Node node;
+	float centroidMin[3], centroidMax[3];
+	Empty(node.min, node.max);
+	Empty(centroidMin, centroidMax);
+	for (uint32_t i = first; i < first + count; i++) {
+		GrowTriangle(node.min, node.max, &corners[order[i] * 9]);
+		Grow(centroidMin, centroidMax, &centroids[order[i] * 3]);
+	}
+	node.first = first;
+	node.count = count;
+	nodes[index] = node;
+	if (count == 1) {
+		return;
+	}
+
+	int axis = 0;
+	for (int i = 1; i < 3; i++) {
+		if (centroidMax[i] - centroidMin[i] > centroidMax[axis] - centroidMin[axis]) axis = i;
+	}
+	const float extent = centroidMax[axis] - centroidMin[axis];
+
+	uint32_t middle = first + count / 2; // triangles around one spot cannot be told apart, so they are halved
+	if (extent > 0.0f) {
+		// Surface area heuristic over binned centroids, as in AabbTree
+		float binMin[binCount][3], binMax[binCount][3];
+		uint32_t binCounts[binCount] = {};
+		for (uint32_t bin = 0; bin < binCount; bin++) Empty(binMin[bin], binMax[bin]);
+		const float scale = binCount / extent;
+		auto binOf = [&](uint32_t triangle) {
+			return std::min(binCount - 1, static_cast<uint32_t>((centroids[triangle * 3 + axis] - centroidMin[axis]) * scale));
+		};
+		for (uint32_t i = first; i < first + count; i++) {
+			const uint32_t bin = binOf(order[i]);
+			binCounts[bin]++;
+			GrowTriangle(binMin[bin], binMax[bin], &corners[order[i] * 9]);
+		}
+
+		float rightCosts[binCount];
+		float sideMin[3], sideMax[3];
+		Empty(sideMin, sideMax);
+		uint32_t sideCount = 0;
+		for (uint32_t bin = binCount - 1; bin > 0; bin--) {
+			if (binCounts[bin] > 0) {
+				for (int i = 0; i < 3; i++) {
+					sideMin[i] = std::min(sideMin[i], binMin[bin][i]);
+					sideMax[i] = std::max(sideMax[i], binMax[bin][i]);
+				}
+			}
+			sideCount += binCounts[bin];
+			rightCosts[bin] = (sideCount > 0) ? HalfArea(sideMin, sideMax) * sideCount : 0.0f;
+		}
+		Empty(sideMin, sideMax);
+		sideCount = 0;
+		float bestCost = std::numeric_limits<float>::max();
+		uint32_t bestSplit = 1;
+		for (uint32_t split = 1; split < binCount; split++) {
+			if (binCounts[split - 1] > 0) {
+				for (int i = 0; i < 3; i++) {
+					sideMin[i] = std::min(sideMin[i], binMin[split - 1][i]);
+					sideMax[i] = std::max(sideMax[i], binMax[split - 1][i]);
+				}
+			}
+			sideCount += binCounts[split - 1];
+			const float cost = ((sideCount > 0) ? HalfArea(sideMin, sideMax) * sideCount : 0.0f) + rightCosts[split];
+			if (sideCount > 0 && sideCount < count && cost < bestCost) {
+				bestCost = cost;
+				bestSplit = split;
+			}
+		}
+
+		const float area = HalfArea(node.min, node.max);
+		const float splitCost = (area > 0.0f) ? 1.0f + bestCost / area : 1.0f;
+		if (count <= maxLeafSize && static_cast<float>(count) <= splitCost) {
+			return;
+		}
+		middle = static_cast<uint32_t>(std::partition(order.begin() + first, order.begin() + first + count, [&](uint32_t triangle) { return binOf(triangle) < bestSplit; }) - order.begin());
+	}
+	else if (count <= maxLeafSize) {
+		return;
+	}
+
+	nodes[index].count = 0;
+	BuildNode(order, centroids, first, middle - first);
+	nodes[index].first = static_cast<uint32_t>(nodes.size());
+	BuildNode(order, centroids, middle, first + count - middle);
+}
+
+// ---------------- Cache file ---------------------- //
+
+bool TriangleBvh::Save(const std::string& path) const {
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	Header header = {};
+	std::memcpy(header.magic, bvhMagic, sizeof(header.magic));
+	header.version = bvhVersion;
+	header.triangleCount = static_cast<uint32_t>(GetTriangleCount());
+	header.nodeCount = static_cast<uint32_t>(nodes.size());
+	header.sourceHash = sourceHash;
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(nodes.data()), nodes.size() * sizeof(Node));
+	file.write(reinterpret_cast<const char*>(corners.data()), corners.size() * sizeof(float));
+	return file.good();
+}
+
+bool TriangleBvh::Load(const std::string& path, const float* positions, size_t stride, const uint32_t* indices, size_t indexCount) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	// Triangles come back grouped by leaf, so the file is matched to the mesh by the hash of the corners in mesh order
+	Header header;
+	const uint64_t expectedHash = Hash(GatherCorners(positions, stride, indices, indexCount));
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, bvhMagic, sizeof(header.magic)) != 0 ||
+		header.version != bvhVersion || header.triangleCount != indexCount / 3 || header.sourceHash != expectedHash ||
+		header.nodeCount > header.triangleCount * 2) {
+		return false;
+	}
+
+	std::vector<Node> loadedNodes(header.nodeCount);
+	std::vector<float> loadedCorners(static_cast<size_t>(header.triangleCount) * 9);
+	file.read(reinterpret_cast<char*>(loadedNodes.data()), loadedNodes.size() * sizeof(Node));
+	file.read(reinterpret_cast<char*>(loadedCorners.data()), loadedCorners.size() * sizeof(float));
+	if (!file || file.peek() != std::ifstream::traits_type::eof()) {
+		return false;
+	}
+
+	nodes.swap(loadedNodes);
+	corners.swap(loadedCorners);
+	sourceHash = header.sourceHash;
+	if (!IsValid()) {
+		nodes.clear();
+		corners.clear();
+		return false;
+	}
+	return true;
+}
+
+// Children always come after their parent and leaves stay inside the triangles, so a damaged file cannot send a query astray
+bool TriangleBvh::IsValid() const {
+	if (nodes.empty() != corners.empty()) {
+		return false;
+	}
+	const size_t triangleCount = GetTriangleCount();
+	for (size_t i = 0; i < nodes.size(); i++) {
+		const Node& node = nodes[i];
+		if (node.count > 0) {
+			if (node.first > triangleCount || node.count > triangleCount - node.first) return false;
+		}
+		else if (i + 1 >= nodes.size() || node.first <= i + 1 || node.first >= nodes.size()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// ---------------- Queries ------------------------- //
+
+bool TriangleBvh::Raycast(const float* origin, const float* direction, float minDistance, float maxDistance, float& distance) const {
+	if (nodes.empty()) {
+		return false;
+	}
+
+	const float dirFrac[3] = { 1.0f / direction[0], 1.0f / direction[1], 1.0f / direction[2] };
+	float enter;
+	if (!HitsBox(nodes[0].min, nodes[0].max, origin, dirFrac, minDistance, maxDistance, enter)) {
+		return false;
+	}
+
+	struct Entry {
+		uint32_t node;
+		float enter;
+	};
+	thread_local std::vector<Entry> stack; // queries run on several threads
+	stack.clear();
+	stack.push_back({ 0, enter });
+	bool found = false;
+	while (!stack.empty()) {
+		const Entry entry = stack.back();
+		stack.pop_back();
+		if (entry.enter > maxDistance) {
+			continue; // a nearer triangle was found after this node was pushed
+		}
+
+		const Node& node = nodes[entry.node];
+		if (node.count > 0) {
+			for (uint32_t i = node.first; i < node.first + node.count; i++) {
+				float t;
+				if (HitsTriangle(&corners[i * 9], origin, direction, t) && t >= minDistance && t <= maxDistance) {
+					maxDistance = t;
+					found = true;
+				}
+			}
+			continue;
+		}
+
+		// The nearer child goes on top, so it is searched first and can rule out the other
+		Entry children[2] = { { entry.node + 1, 0.0f }, { node.first, 0.0f } };
+		bool hit[2];
+		for (int i = 0; i < 2; i++) {
+			const Node& child = nodes[children[i].node];
+			hit[i] = HitsBox(child.min, child.max, origin, dirFrac, minDistance, maxDistance, children[i].enter);
+		}
+		if (hit[0] && hit[1] && children[0].enter < children[1].enter) {
+			std::swap(children[0], children[1]);
+		}
+		for (int i = 0; i < 2; i++) {
+			if (hit[i]) stack.push_back(children[i]);
+		}
+	}
+
+	if (found) {
+		distance = maxDistance;
+	}
+	return found;
+}
\ No newline at end of file
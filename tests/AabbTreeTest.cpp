@@ -0,0 +1,197 @@
+#include <random>
+
+#include "AabbTreeTest.hpp"
+
+namespace {
+    struct Box {
+        float min[3];
+        float max[3];
+    };
+
+    // Nearest box the way the scene found it before, by testing every one
+    bool LinearRaycast(const std::vector<Box>& boxes, const float* origin, const float* direction, float maxDistance, float& nearest) {
+        bool found = false;
+        for (const Box& box : boxes) {
+            float tmin = std::numeric_limits<float>::lowest();
+            float tmax = std::numeric_limits<float>::max();
+            for (int axis = 0; axis < 3; axis++) {
+                const float t1 = (box.min[axis] - origin[axis]) * (1.0f / direction[axis]);
+                const float t2 = (box.max[axis] - origin[axis]) * (1.0f / direction[axis]);
+                tmin = std::max(tmin, std::min(t1, t2));
+                tmax = std::min(tmax, std::max(t1, t2));
+            }
+            if (tmax >= 0 && tmin <= tmax && tmin <= maxDistance && (!found || tmin < nearest)) {
+                nearest = tmin;
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    std::vector<Box> RandomBoxes(std::mt19937& random, size_t count) {
+        std::uniform_real_distribution<float> place(-1000.0f, 1000.0f);
+        std::uniform_real_distribution<float> size(1.0f, 40.0f);
+        std::vector<Box> boxes(count);
+        for (Box& box : boxes) {
+            for (int axis = 0; axis < 3; axis++) {
+                box.min[axis] = place(random);
+                box.max[axis] = box.min[axis] + size(random);
+            }
+        }
+        return boxes;
+    }
+
+    void ExpectSameHits(const enginetool::AabbTree& tree, const std::vector<Box>& boxes, std::mt19937& random) {
+        std::uniform_real_distribution<float> place(-1200.0f, 1200.0f);
+        std::uniform_real_distribution<float> turn(-1.0f, 1.0f);
+        for (int i = 0; i < 500; i++) {
+            const float origin[3] = { place(random), place(random), place(random) };
+            const float direction[3] = { turn(random), turn(random), turn(random) };
+            const float maxDistance = (i % 2 == 0) ? std::numeric_limits<float>::max() : 400.0f;
+
+            float nearest = 0.0f;
+            const bool expected = LinearRaycast(boxes, origin, direction, maxDistance, nearest);
+            const enginetool::AabbTree::RayHit hit = tree.Raycast(origin, direction, maxDistance);
+            ASSERT_EQ(expected, hit.id != enginetool::AabbTree::RayHit().id);
+            EXPECT_EQ(expected, tree.RaycastAny(origin, direction, maxDistance));
+            if (expected) {
+                EXPECT_EQ(nearest, hit.distance);
+            }
+        }
+    }
+}
+
+TEST_F(AabbTreeTest, RaysMatchLinearScan){
+    std::mt19937 random(20);
+    const std::vector<Box> boxes = RandomBoxes(random, 2000);
+    for (uint32_t i = 0; i < boxes.size(); i++) uut.Insert(i, boxes[i].min, boxes[i].max);
+    uut.Build();
+    EXPECT_FALSE(uut.NeedsRebuild());
+    ExpectSameHits(uut, boxes, random);
+
+    const float origin[3] = { 0.0f, 0.0f, 0.0f };
+    const float direction[3] = { 1.0f, 0.0f, 0.0f };
+    enginetool::AabbTree::RayHit first = uut.Raycast(origin, direction, 1.0e9f);
+    if (first.id != enginetool::AabbTree::RayHit().id) {
+        EXPECT_NE(first.id, uut.Raycast(origin, direction, 1.0e9f, first.id).id);
+    }
+}
+
+TEST_F(AabbTreeTest, RefitFollowsMovingBoxes){
+    std::mt19937 random(21);
+    std::vector<Box> boxes = RandomBoxes(random, 2000);
+    for (uint32_t i = 0; i < boxes.size(); i++) uut.Insert(i, boxes[i].min, boxes[i].max);
+    uut.Build();
+
+    std::uniform_real_distribution<float> step(-5.0f, 5.0f);
+    for (uint32_t i = 0; i < boxes.size(); i++) {
+        for (int axis = 0; axis < 3; axis++) {
+            const float move = step(random);
+            boxes[i].min[axis] += move;
+            boxes[i].max[axis] += move;
+        }
+        uut.UpdateBox(i, boxes[i].min, boxes[i].max);
+    }
+    uut.Refit();
+    EXPECT_FALSE(uut.NeedsRebuild());
+    ExpectSameHits(uut, boxes, random);
+
+    // Shuffled positions leave every node spanning the whole scene
+    const std::vector<Box> shuffled = RandomBoxes(random, boxes.size());
+    for (uint32_t i = 0; i < shuffled.size(); i++) uut.UpdateBox(i, shuffled[i].min, shuffled[i].max);
+    uut.Refit();
+    EXPECT_TRUE(uut.NeedsRebuild());
+    ExpectSameHits(uut, shuffled, random);
+    uut.Build();
+    EXPECT_FALSE(uut.NeedsRebuild());
+}
+
+TEST_F(AabbTreeTest, RefitOfSomeBoxesMatchesFullRefit){
+    std::mt19937 random(33);
+    std::vector<Box> boxes = RandomBoxes(random, 2000);
+    for (uint32_t i = 0; i < boxes.size(); i++) uut.Insert(i, boxes[i].min, boxes[i].max);
+    uut.Build();
+    enginetool::AabbTree full = uut;
+
+    // A few boxes move a long way, some barely, the rest stay where they were
+    std::uniform_real_distribution<float> step(-300.0f, 300.0f);
+    std::vector<uint32_t> moved;
+    for (uint32_t i = 0; i < boxes.size(); i += 37) {
+        const float scale = (i % 2 == 0) ? 1.0f : 0.001f;
+        for (int axis = 0; axis < 3; axis++) {
+            const float move = step(random) * scale;
+            boxes[i].min[axis] += move;
+            boxes[i].max[axis] += move;
+        }
+        uut.UpdateBox(i, boxes[i].min, boxes[i].max);
+        full.UpdateBox(i, boxes[i].min, boxes[i].max);
+        moved.push_back(i);
+    }
+    uut.Refit(moved);
+    full.Refit();
+    EXPECT_EQ(full.NeedsRebuild(), uut.NeedsRebuild());
+    ExpectSameHits(uut, boxes, random);
+
+    const float down[3] = { 0.0f, -1.0f, 0.0f };
+    for (uint32_t i : moved) {
+        const float origin[3] = { (boxes[i].min[0] + boxes[i].max[0]) * 0.5f, 2000.0f, (boxes[i].min[2] + boxes[i].max[2]) * 0.5f };
+        const enginetool::AabbTree::RayHit expected = full.Raycast(origin, down, 4000.0f);
+        const enginetool::AabbTree::RayHit hit = uut.Raycast(origin, down, 4000.0f);
+        EXPECT_EQ(expected.id, hit.id);
+        EXPECT_EQ(expected.distance, hit.distance);
+    }
+}
+
+TEST_F(AabbTreeTest, ProbeDownFindsHighestGround){
+    const float origin[3] = { 0.0f, 50.0f, 0.0f };
+    EXPECT_EQ(enginetool::AabbTree::RayHit().id, uut.ProbeDown(origin, -20.0f).id);
+
+    const Box plane = { { -500.0f, -1.0f, -500.0f }, { 500.0f, 0.0f, 500.0f } };
+    const Box crate = { { -5.0f, 0.0f, -5.0f }, { 5.0f, 10.0f, 5.0f } };
+    const Box self = { { -10.0f, 45.0f, -10.0f }, { 10.0f, 116.0f, 10.0f } };
+    const Box roof = { { -50.0f, 200.0f, -50.0f }, { 50.0f, 210.0f, 50.0f } };
+    const Box pit = { { -5.0f, -100.0f, 100.0f }, { 5.0f, -90.0f, 110.0f } };
+    uut.Insert(1, plane.min, plane.max);
+    uut.Insert(2, crate.min, crate.max);
+    uut.Insert(3, self.min, self.max);
+    uut.Insert(4, roof.min, roof.max);
+    uut.Insert(5, pit.min, pit.max);
+    uut.Build();
+
+    enginetool::AabbTree::RayHit ground = uut.ProbeDown(origin, -20.0f, 3);
+    EXPECT_EQ(2u, ground.id);
+    EXPECT_EQ(10.0f, origin[1] - ground.distance);
+
+    // Standing inside a box lands on its top, above the origin
+    ground = uut.ProbeDown(origin, -20.0f);
+    EXPECT_EQ(3u, ground.id);
+    EXPECT_EQ(116.0f, origin[1] - ground.distance);
+
+    // Nothing between the origin and the floor
+    const float overPit[3] = { 0.0f, 50.0f, 105.0f };
+    EXPECT_EQ(1u, uut.ProbeDown(overPit, -20.0f).id);
+    const float inPit[3] = { 0.0f, -50.0f, 105.0f };
+    EXPECT_EQ(enginetool::AabbTree::RayHit().id, uut.ProbeDown(inPit, -20.0f).id);
+}
+
+TEST_F(AabbTreeTest, ExactTestDecidesWhatInABoxIsHit){
+    const Box crate = { { -5.0f, 0.0f, -5.0f }, { 5.0f, 10.0f, 5.0f } };
+    const Box hollow = { { -10.0f, 20.0f, -10.0f }, { 10.0f, 30.0f, 10.0f } };
+    uut.Insert(1, crate.min, crate.max);
+    uut.Insert(2, hollow.min, hollow.max);
+    uut.Build();
+
+    // The hollow box has nothing inside, the crate's contents sit a little below its top
+    const std::vector<uint32_t> solid = { 0, 1, 0 };
+    const float inset = 2.0f;
+    std::vector<uint32_t> tested;
+    const float origin[3] = { 0.0f, 50.0f, 0.0f };
+    const enginetool::AabbTree::RayHit ground = uut.ProbeDown(origin, -20.0f, enginetool::AabbTree::none, [&](uint32_t id, float enter, float limit, float& distance) {
+        tested.push_back(id);
+        distance = enter + inset;
+        return solid[id] != 0 && distance <= limit;
+    });
+    EXPECT_EQ(1u, ground.id);
+    EXPECT_EQ(8.0f, origin[1] - ground.distance);
+    EXPECT_EQ((std::vector<uint32_t>{ 2, 1 }), tested);
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "../puffinEngine/src/AabbTree.cpp"
+
+class AabbTreeTest : public ::testing::Test
+{
+public:
+    enginetool::AabbTree uut;
+};
\ No newline at end of file
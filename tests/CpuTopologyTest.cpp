@@ -0,0 +1,24 @@
+#include "CpuTopologyTest.hpp"
+
+TEST_F(CpuTopologyTest, ParsesCpuLists){
+    EXPECT_EQ(std::vector<uint32_t>({0, 1, 2, 3, 8, 10, 11}), enginetool::CpuTopology::ParseCpuList("0-3,8,10-11"));
+    EXPECT_TRUE(enginetool::CpuTopology::ParseCpuList("").empty());
+}
+
+TEST_F(CpuTopologyTest, CountsCoresAndDomains){
+    EXPECT_EQ(4u, uut.GetPhysicalCoreCount());
+    EXPECT_EQ(2u, uut.GetL3DomainCount());
+    EXPECT_EQ(3u, uut.RecommendedWorkerCount(0));
+}
+
+TEST_F(CpuTopologyTest, PicksLocalCoresThenSiblingsAndReservedCoreLast){
+    EXPECT_EQ(std::vector<uint32_t>({1, 2, 3}), uut.PickWorkerCpus(0, 3));
+    EXPECT_EQ(std::vector<uint32_t>({0, 2, 3, 4, 6, 7, 1}), uut.PickWorkerCpus(5, 7));
+    EXPECT_EQ(std::vector<uint32_t>({1, 2, 3, 5, 6, 7, 4}), uut.PickWorkerCpus(0, 16));
+}
+
+TEST_F(CpuTopologyTest, DetectsSomething){
+    const enginetool::CpuTopology detected = enginetool::CpuTopology::Detect();
+    EXPECT_FALSE(detected.GetCpus().empty());
+    EXPECT_GE(detected.GetPhysicalCoreCount(), 1u);
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "../puffinEngine/src/CpuTopology.cpp"
+
+class CpuTopologyTest : public ::testing::Test
+{
+public:
+    // Two L3 domains with two SMT cores each: cpus 0-3 are the first threads, 4-7 their siblings.
+    void SetUp() override {
+        for (uint32_t id = 0; id < 8; id++) {
+            enginetool::LogicalCpu cpu;
+            cpu.id = id;
+            cpu.core = id % 4;
+            cpu.l3Domain = (id % 4) < 2 ? 0 : 2;
+            uut.AddCpu(cpu);
+        }
+    }
+
+    enginetool::CpuTopology uut;
+};
\ No newline at end of file
@@ -0,0 +1,56 @@
+#include <thread>
+
+#include "FrameAllocatorTest.hpp"
+
+TEST_F(FrameAllocatorTest, AllocatesAlignedFromOneBlock){
+    void* first = uut.Allocate(3, 1);
+    void* second = uut.Allocate(8, 16);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(second) % 16);
+    EXPECT_GT(second, first);
+    EXPECT_EQ(1u, uut.GetBlockCount());
+}
+
+TEST_F(FrameAllocatorTest, MergesOverflowBlocksOnReset){
+    for (int i = 0; i < 10; i++) {
+        uut.Allocate(100, 8);
+    }
+    EXPECT_GT(uut.GetBlockCount(), 1u);
+    const size_t capacity = uut.GetCapacity();
+
+    uut.Reset();
+    EXPECT_EQ(1u, uut.GetBlockCount());
+    EXPECT_EQ(capacity, uut.GetCapacity());
+    EXPECT_EQ(0u, uut.GetUsedBytes());
+
+    for (int i = 0; i < 10; i++) {
+        uut.Allocate(100, 8);
+    }
+    EXPECT_EQ(1u, uut.GetBlockCount());
+}
+
+TEST_F(FrameAllocatorTest, BacksStlContainers){
+    enginetool::FrameVector<int> values{ enginetool::FrameAllocator<int>(uut) };
+    for (int i = 0; i < 1000; i++) {
+        values.push_back(i);
+    }
+    EXPECT_EQ(999, values.back());
+    EXPECT_GE(uut.GetUsedBytes(), 1000 * sizeof(int));
+
+    enginetool::FrameStringStream text;
+    text << "HP " << 75 << "/" << 100;
+    EXPECT_EQ("HP 75/100", std::string(text.str().c_str()));
+}
+
+TEST_F(FrameAllocatorTest, ThreadArenasResetOnNextFrame){
+    enginetool::FrameArena* mainArena = &enginetool::GetFrameArena();
+    mainArena->Allocate(64, 8);
+    EXPECT_GT(mainArena->GetUsedBytes(), 0u);
+
+    enginetool::FrameArena* workerArena = nullptr;
+    std::thread worker([&workerArena]() { workerArena = &enginetool::GetFrameArena(); });
+    worker.join();
+    EXPECT_NE(mainArena, workerArena);
+
+    enginetool::NextFrame();
+    EXPECT_EQ(0u, enginetool::GetFrameArena().GetUsedBytes());
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "../puffinEngine/src/FrameAllocator.cpp"
+
+class FrameAllocatorTest : public ::testing::Test
+{
+public:
+    enginetool::FrameArena uut{ 256 };
+};
\ No newline at end of file
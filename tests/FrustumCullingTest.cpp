@@ -0,0 +1,105 @@
+#include <random>
+#include <vector>
+
+#include "FrustumCullingTest.hpp"
+
+namespace {
+    // Six arrays of boxes, laid out the way BoxArrays points into them
+    struct BoxStore {
+        explicit BoxStore(size_t count) : count(count), bounds(count * 6) {}
+
+        void Set(size_t i, float minX, float minY, float minZ, float maxX, float maxY, float maxZ) {
+            const float values[6] = { minX, minY, minZ, maxX, maxY, maxZ };
+            for (int bound = 0; bound < 6; bound++) bounds[bound * count + i] = values[bound];
+        }
+
+        enginetool::BoxArrays Arrays() const {
+            enginetool::BoxArrays arrays;
+            for (int axis = 0; axis < 3; axis++) {
+                arrays.min[axis] = &bounds[axis * count];
+                arrays.max[axis] = &bounds[(3 + axis) * count];
+            }
+            return arrays;
+        }
+
+        size_t count;
+        std::vector<float> bounds;
+    };
+
+    // Whether the point lands inside Vulkan's clip volume
+    bool InClipSpace(const float* viewProjection, const float* point) {
+        float clip[4];
+        for (int row = 0; row < 4; row++) {
+            clip[row] = viewProjection[row] * point[0] + viewProjection[4 + row] * point[1] + viewProjection[8 + row] * point[2] + viewProjection[12 + row];
+        }
+        return -clip[3] <= clip[0] && clip[0] <= clip[3] && -clip[3] <= clip[1] && clip[1] <= clip[3] && 0.0f <= clip[2] && clip[2] <= clip[3];
+    }
+}
+
+TEST_F(FrustumCullingTest, PlanesBoundClipSpace){
+    std::mt19937 random(25);
+    std::uniform_real_distribution<float> place(-120.0f, 120.0f);
+    int inside = 0;
+    for (int i = 0; i < 10000; i++) {
+        const float point[3] = { place(random), place(random), place(random) };
+        bool inFrustum = true;
+        for (const auto& plane : uut.planes) {
+            inFrustum = inFrustum && plane[0] * point[0] + plane[1] * point[1] + plane[2] * point[2] + plane[3] >= 0.0f;
+        }
+        EXPECT_EQ(InClipSpace(viewProjection, point), inFrustum) << point[0] << " " << point[1] << " " << point[2];
+        inside += inFrustum;
+    }
+    EXPECT_GT(inside, 100);
+}
+
+TEST_F(FrustumCullingTest, CullsBoxesOutsideAPlane){
+    BoxStore boxes(7);
+    boxes.Set(0, -1.0f, -1.0f, -11.0f, 1.0f, 1.0f, -9.0f); // ahead
+    boxes.Set(1, -1.0f, -1.0f, 9.0f, 1.0f, 1.0f, 11.0f); // behind
+    boxes.Set(2, -1.0f, -1.0f, -111.0f, 1.0f, 1.0f, -101.0f); // past the far plane
+    boxes.Set(3, -30.0f, -1.0f, -11.0f, -20.0f, 1.0f, -9.0f); // left of the view
+    boxes.Set(4, -1.0f, 20.0f, -11.0f, 1.0f, 30.0f, -9.0f); // above it
+    boxes.Set(5, -1.0f, -1.0f, -5.0f, 1.0f, 1.0f, 5.0f); // through the near plane, around the camera
+    boxes.Set(6, -5000.0f, -1.0f, -5000.0f, 5000.0f, 0.0f, 5000.0f); // a landscape under everything
+    std::vector<uint8_t> visible(7, 2);
+    enginetool::CullBoxes(enginetool::SimdLevel::Scalar, uut, boxes.Arrays(), 7, visible.data());
+    EXPECT_EQ((std::vector<uint8_t>{ 1, 0, 0, 0, 0, 1, 1 }), visible);
+}
+
+TEST_F(FrustumCullingTest, LevelsAgreeAndKeepBoxesWithAPointInside){
+    std::mt19937 random(4);
+    std::uniform_real_distribution<float> place(-120.0f, 120.0f);
+    std::uniform_real_distribution<float> size(0.0f, 30.0f);
+    // Not a multiple of eight or four, so every level finishes on a narrower one
+    const size_t count = 1003;
+    BoxStore boxes(count);
+    for (size_t i = 0; i < count; i++) {
+        const float x = place(random), y = place(random), z = place(random);
+        boxes.Set(i, x, y, z, x + size(random), y + size(random), z + size(random));
+    }
+
+    std::vector<uint8_t> expected(count);
+    enginetool::CullBoxes(enginetool::SimdLevel::Scalar, uut, boxes.Arrays(), count, expected.data());
+    for (int level = 0; level <= static_cast<int>(enginetool::GetSupportedSimdLevel()); level++) {
+        const auto simd = static_cast<enginetool::SimdLevel>(level);
+        std::vector<uint8_t> actual(count, 2);
+        enginetool::CullBoxes(simd, uut, boxes.Arrays(), count, actual.data());
+        EXPECT_EQ(expected, actual) << enginetool::GetSimdLevelName(simd);
+    }
+
+    int culled = 0;
+    for (size_t i = 0; i < count; i++) {
+        culled += expected[i] == 0;
+        if (expected[i] != 0) continue;
+        // A culled box has none of its corners or its center in view
+        const enginetool::BoxArrays arrays = boxes.Arrays();
+        for (int corner = 0; corner < 9; corner++) {
+            float point[3];
+            for (int axis = 0; axis < 3; axis++) {
+                point[axis] = (corner == 8) ? (arrays.min[axis][i] + arrays.max[axis][i]) * 0.5f : ((corner >> axis) & 1) ? arrays.max[axis][i] : arrays.min[axis][i];
+            }
+            EXPECT_FALSE(InClipSpace(viewProjection, point)) << "box " << i;
+        }
+    }
+    EXPECT_GT(culled, 500);
+}
\ No newline at end of file
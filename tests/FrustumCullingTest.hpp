@@ -0,0 +1,24 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "../puffinEngine/src/FrustumCulling.cpp"
+
+class FrustumCullingTest : public ::testing::Test
+{
+public:
+    // Camera at the origin looking down -z with a 90 degree field of view, near plane at 1 and far plane at 100: the
+    // column major projection glm::perspective gives for Vulkan's depth range, and an identity view
+    FrustumCullingTest() {
+        const float nearPlane = 1.0f, farPlane = 100.0f;
+        viewProjection[0] = 1.0f;
+        viewProjection[5] = 1.0f;
+        viewProjection[10] = farPlane / (nearPlane - farPlane);
+        viewProjection[11] = -1.0f;
+        viewProjection[14] = -(farPlane * nearPlane) / (farPlane - nearPlane);
+        uut = enginetool::ExtractFrustum(viewProjection);
+    }
+
+    float viewProjection[16] = {};
+    enginetool::Frustum uut;
+};
\ No newline at end of file
@@ -0,0 +1,41 @@
+#include "HandleTest.hpp"
+
+TEST_F(HandleTest, ResolvesTypedHandles){
+    Box box;
+    enginetool::Handle<Box> handle = uut.Insert(&box);
+    EXPECT_EQ(&box, uut.Get(handle));
+    EXPECT_EQ(3, uut.Get(handle)->side);
+
+    enginetool::Handle<Shape> base = handle;
+    EXPECT_EQ(static_cast<Shape*>(&box), uut.Get(base));
+    EXPECT_EQ(nullptr, uut.Get(enginetool::Handle<Box>()));
+}
+
+TEST_F(HandleTest, RemovedHandlesGoStale){
+    Box first, second;
+    enginetool::Handle<Box> stale = uut.Insert(&first);
+    EXPECT_TRUE(uut.Remove(stale));
+    EXPECT_FALSE(uut.Remove(stale));
+
+    // The slot is reused with a new generation, the old handle must not see the new object
+    enginetool::Handle<Box> fresh = uut.Insert(&second);
+    EXPECT_EQ(stale.index, fresh.index);
+    EXPECT_NE(stale, fresh);
+    EXPECT_EQ(nullptr, uut.Get(stale));
+    EXPECT_EQ(&second, uut.Get(fresh));
+    EXPECT_EQ(1u, uut.GetLiveCount());
+}
+
+TEST_F(HandleTest, ClearInvalidatesEverything){
+    Box boxes[4];
+    enginetool::Handle<Box> handles[4];
+    for (int i = 0; i < 4; i++) {
+        handles[i] = uut.Insert(&boxes[i]);
+    }
+
+    uut.Clear();
+    EXPECT_EQ(0u, uut.GetLiveCount());
+    for (const auto& handle : handles) {
+        EXPECT_EQ(nullptr, uut.Get(handle));
+    }
+}
\ No newline at end of file
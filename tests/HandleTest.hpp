@@ -0,0 +1,19 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "../puffinEngine/headers/Handle.hpp"
+
+struct Shape {
+    virtual ~Shape() = default;
+};
+
+struct Box : Shape {
+    int side = 3;
+};
+
+class HandleTest : public ::testing::Test
+{
+public:
+    enginetool::HandleTable<Shape> uut;
+};
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include <random>
+
+#include "HeightfieldTest.hpp"
+
+namespace {
+    struct Box {
+        float min[3];
+        float max[3];
+    };
+
+    // What a downward ray finds: the highest top of a box around the vertical line that does not start above the point
+    float ProbeDown(const std::vector<Box>& boxes, float x, float y, float z) {
+        float level = std::numeric_limits<float>::lowest();
+        for (const Box& box : boxes) {
+            if (box.min[0] < x && x < box.max[0] && box.min[2] < z && z < box.max[2] && box.min[1] <= y) {
+                level = std::max(level, box.max[1]);
+            }
+        }
+        return level;
+    }
+}
+
+TEST_F(HeightfieldTest, MatchesRayCastWhereItAnswers){
+    // Terraces of landscape planes and crates, like the test scene
+    std::mt19937 random(22);
+    std::uniform_real_distribution<float> place(-400.0f, 400.0f);
+    std::uniform_real_distribution<float> size(10.0f, 120.0f);
+    std::uniform_real_distribution<float> height(-20.0f, 40.0f);
+    std::vector<Box> boxes(60);
+    for (Box& box : boxes) {
+        box.min[0] = place(random);
+        box.min[1] = height(random);
+        box.min[2] = place(random);
+        box.max[0] = box.min[0] + size(random);
+        box.max[1] = box.min[1] + size(random) * 0.1f;
+        box.max[2] = box.min[2] + size(random);
+        uut.Insert(box.min, box.max);
+    }
+    uut.Build();
+    EXPECT_EQ(boxes.size(), uut.GetCount());
+
+    std::uniform_real_distribution<float> above(-30.0f, 100.0f);
+    size_t answered = 0;
+    for (int i = 0; i < 20000; i++) {
+        const float x = place(random) * 1.2f, y = above(random), z = place(random) * 1.2f;
+        float level = 0.0f;
+        if (uut.GroundLevel(x, y, z, level)) {
+            EXPECT_EQ(ProbeDown(boxes, x, y, z), level) << x << " " << y << " " << z;
+            answered++;
+        }
+    }
+    // Most of the ground is away from box edges and stacked boxes
+    EXPECT_GT(answered, 20000u * 3 / 4);
+}
+
+TEST_F(HeightfieldTest, LeavesEdgesAndOverhangsToRayCasts){
+    const Box floor = { { 0.0f, -1.0f, 0.0f }, { 64.0f, 0.0f, 64.0f } };
+    const Box roof = { { 16.0f, 30.0f, 16.0f }, { 32.0f, 31.0f, 32.0f } };
+    const Box crate = { { 44.0f, 0.0f, 44.0f }, { 50.0f, 6.0f, 50.0f } };
+    for (const Box& box : { floor, roof, crate }) uut.Insert(box.min, box.max);
+    uut.Build();
+
+    float level = 0.0f;
+    EXPECT_TRUE(uut.GroundLevel(4.0f, 10.0f, 4.0f, level));
+    EXPECT_EQ(0.0f, level);
+    // On the roof and under it
+    EXPECT_TRUE(uut.GroundLevel(20.0f, 40.0f, 20.0f, level));
+    EXPECT_EQ(31.0f, level);
+    EXPECT_FALSE(uut.GroundLevel(20.0f, 10.0f, 20.0f, level));
+    // The crate's edges cross its cells
+    EXPECT_FALSE(uut.GroundLevel(47.0f, 10.0f, 47.0f, level));
+    // Off the grid
+    EXPECT_TRUE(uut.GroundLevel(-100.0f, 10.0f, 4.0f, level));
+    EXPECT_EQ(std::numeric_limits<float>::lowest(), level);
+    EXPECT_FALSE(uut.GroundLevel(std::numeric_limits<float>::quiet_NaN(), 10.0f, 4.0f, level));
+}
+
+TEST_F(HeightfieldTest, GrowsCellsForFarApartBoxes){
+    const Box close = { { 0.0f, 0.0f, 0.0f }, { 16.0f, 1.0f, 16.0f } };
+    const Box distant = { { 1.0e6f, 0.0f, 1.0e6f }, { 1.0e6f + 16.0f, 1.0f, 1.0e6f + 16.0f } };
+    uut.Insert(close.min, close.max);
+    uut.Insert(distant.min, distant.max);
+    uut.Build();
+    EXPECT_GT(uut.GetCellSize(), 8.0f);
+
+    float level = 0.0f;
+    EXPECT_TRUE(uut.GroundLevel(5.0e5f, 10.0f, 5.0e5f, level));
+    EXPECT_EQ(std::numeric_limits<float>::lowest(), level);
+
+    uut.Clear();
+    uut.Build();
+    EXPECT_EQ(0u, uut.GetCount());
+    EXPECT_EQ(8.0f, uut.GetCellSize());
+    EXPECT_TRUE(uut.GroundLevel(5.0f, 10.0f, 5.0f, level));
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "../puffinEngine/src/Heightfield.cpp"
+
+class HeightfieldTest : public ::testing::Test
+{
+public:
+    enginetool::Heightfield uut{ 8.0f };
+};
\ No newline at end of file
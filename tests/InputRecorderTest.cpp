@@ -0,0 +1,107 @@
+#include <cstdio>
+#include <sstream>
+#include <vector>
+
+#include "InputRecorderTest.hpp"
+
+TEST_F(InputRecorderTest, RecordedFileReplaysEventsFrameByFrame){
+    const std::string path = "inputRecorderTest.bin";
+    enginetool::InputRecordingHeader header;
+    header.fixedTimeValue = 0.015;
+    header.width = 800;
+    header.height = 600;
+
+    enginetool::InputRecorder recorder;
+    ASSERT_TRUE(recorder.Open(path, header));
+    recorder.Record(MakeEvent(enginetool::InputEventType::CursorPosition, 0, 0, 0, 412.25, 300.5));
+    recorder.Record(MakeEvent(enginetool::InputEventType::MouseButton, 0, 0, 1, 0.0, 0.0));
+    recorder.Record(MakeFrame(3, 0.25f));
+    recorder.Record(MakeEvent(enginetool::InputEventType::Key, 3, 87, 1, 0.0, 0.0));
+    recorder.Record(MakeFrame(300, 0.5f));
+    recorder.Record(MakeEvent(enginetool::InputEventType::Key, 300, 87, 0, 0.0, 0.0));
+    recorder.Close(1000);
+
+    ASSERT_TRUE(uut.Load(path));
+    std::remove(path.c_str());
+    EXPECT_TRUE(uut.IsActive());
+    EXPECT_EQ(0.015, uut.GetHeader().fixedTimeValue);
+    EXPECT_EQ(800, uut.GetHeader().width);
+    ASSERT_EQ(6u, uut.GetEvents().size());
+
+    std::vector<enginetool::InputEvent> events;
+    enginetool::InputEvent frame;
+    ASSERT_TRUE(uut.NextFrame(events, frame));
+    ASSERT_EQ(2u, events.size());
+    EXPECT_EQ(enginetool::InputEventType::CursorPosition, events[0].type);
+    EXPECT_EQ(412.25, events[0].x);
+    EXPECT_EQ(300.5, events[0].y);
+    EXPECT_EQ(enginetool::InputEventType::MouseButton, events[1].type);
+    EXPECT_EQ(3u, frame.tick);
+    EXPECT_EQ(0.25f, frame.alpha);
+
+    ASSERT_TRUE(uut.NextFrame(events, frame));
+    ASSERT_EQ(1u, events.size());
+    EXPECT_EQ(87, events[0].code);
+    EXPECT_EQ(1, events[0].action);
+    EXPECT_EQ(300u, frame.tick);
+    EXPECT_FALSE(uut.IsFinished());
+
+    // Cut short after the last frame: the trailing event comes back without further ticks
+    ASSERT_TRUE(uut.NextFrame(events, frame));
+    ASSERT_EQ(1u, events.size());
+    EXPECT_EQ(0, events[0].action);
+    EXPECT_EQ(300u, frame.tick);
+    EXPECT_TRUE(uut.IsFinished());
+    EXPECT_FALSE(uut.NextFrame(events, frame));
+}
+
+TEST_F(InputRecorderTest, FramesWithoutTicksKeepTheirPicksApart){
+    // Two frames drawn between the same ticks at different alphas: a pick in each must be replayed after its own frame
+    std::stringstream stream;
+    enginetool::InputRecordingHeader header;
+    header.fixedTimeValue = 0.015;
+    enginetool::input::WriteHeader(stream, header);
+    uint64_t previousTick = 0;
+    const enginetool::InputEvent records[] = {
+        MakeFrame(10, 0.2f),
+        MakeEvent(enginetool::InputEventType::MouseButton, 10, 0, 1, 0.0, 0.0),
+        MakeFrame(10, 0.7f),
+        MakeEvent(enginetool::InputEventType::MouseButton, 10, 0, 1, 0.0, 0.0),
+        MakeFrame(11, 0.1f)
+    };
+    for (const enginetool::InputEvent& record : records) {
+        enginetool::input::WriteEvent(stream, record, previousTick);
+        previousTick = record.tick;
+    }
+    ASSERT_TRUE(uut.Load(stream));
+
+    std::vector<enginetool::InputEvent> events;
+    enginetool::InputEvent frame;
+    const float alphas[] = { 0.2f, 0.7f, 0.1f };
+    const size_t eventCounts[] = { 0, 1, 1 };
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(uut.NextFrame(events, frame));
+        EXPECT_EQ(eventCounts[i], events.size());
+        EXPECT_EQ(enginetool::InputEventType::Frame, frame.type);
+        EXPECT_EQ(alphas[i], frame.alpha);
+    }
+    EXPECT_EQ(11u, frame.tick);
+    EXPECT_TRUE(uut.IsFinished());
+}
+
+TEST_F(InputRecorderTest, EncodesTickDeltasCompactly){
+    std::stringstream stream;
+    enginetool::input::WriteEvent(stream, MakeEvent(enginetool::InputEventType::Key, 100, 32, 1, 0.0, 0.0), 90);
+    EXPECT_EQ(1u + 1u + 4u + 2u + 1u, stream.str().size());
+
+    enginetool::InputEvent event;
+    ASSERT_TRUE(enginetool::input::ReadEvent(stream, event, 90));
+    EXPECT_EQ(100u, event.tick);
+    EXPECT_EQ(32, event.code);
+}
+
+TEST_F(InputRecorderTest, RejectsForeignFiles){
+    std::stringstream stream("not a recording");
+    EXPECT_FALSE(uut.Load(stream));
+    EXPECT_FALSE(uut.IsActive());
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "../puffinEngine/src/InputRecorder.cpp"
+
+class InputRecorderTest : public ::testing::Test
+{
+public:
+    enginetool::InputEvent MakeEvent(enginetool::InputEventType type, uint64_t tick, int32_t code, int32_t action, double x, double y) {
+        enginetool::InputEvent event;
+        event.type = type;
+        event.tick = tick;
+        event.code = code;
+        event.action = action;
+        event.x = x;
+        event.y = y;
+        return event;
+    }
+
+    enginetool::InputEvent MakeFrame(uint64_t tick, float alpha) {
+        enginetool::InputEvent frame;
+        frame.type = enginetool::InputEventType::Frame;
+        frame.tick = tick;
+        frame.alpha = alpha;
+        return frame;
+    }
+
+    enginetool::InputReplay uut;
+};
\ No newline at end of file
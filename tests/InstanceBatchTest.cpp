@@ -0,0 +1,78 @@
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include "InstanceBatchTest.hpp"
+
+namespace {
+    std::string ReadFile(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+}
+
+TEST_F(InstanceBatchTest, SavedBatchesLoadBack){
+    const std::string path = "instanceBatchTest.pins";
+    std::vector<enginetool::InstanceBatch> saved;
+    saved.push_back(MakeBatch("human", "default", { { glm::vec3(0.0f, 0.0f, 1000.0f) }, { glm::vec3(0.0f, 0.0f, 2000.0f) } }));
+    saved.push_back(MakeBatch("box", "plastic", {}));
+    saved.push_back(MakeBatch("teapot", "chrome", { { glm::vec3(-7.0f, 0.5f, 20.0f) } }));
+    ASSERT_TRUE(enginetool::instancing::Save(path, saved));
+
+    ASSERT_TRUE(enginetool::instancing::Load(path, uut));
+    std::remove(path.c_str());
+    ASSERT_EQ(3u, uut.size());
+    for (size_t i = 0; i < uut.size(); i++) {
+        EXPECT_EQ(saved[i].meshName, uut[i].meshName);
+        EXPECT_EQ(saved[i].materialName, uut[i].materialName);
+        EXPECT_EQ(nullptr, uut[i].mesh);
+        ASSERT_EQ(saved[i].instances.size(), uut[i].instances.size());
+        for (size_t j = 0; j < uut[i].instances.size(); j++) {
+            EXPECT_EQ(saved[i].instances[j].pos, uut[i].instances[j].pos);
+        }
+    }
+}
+
+TEST_F(InstanceBatchTest, RejectsDamagedFiles){
+    const std::string path = "instanceBatchTest.pins";
+    std::vector<enginetool::InstanceBatch> saved;
+    saved.push_back(MakeBatch("human", "default", { { glm::vec3(1.0f) }, { glm::vec3(2.0f) }, { glm::vec3(3.0f) } }));
+    ASSERT_TRUE(enginetool::instancing::Save(path, saved));
+    const std::string file = ReadFile(path);
+    std::remove(path.c_str());
+
+    std::string wrongMagic(file);
+    wrongMagic[0] = 'X';
+    std::string wrongVersion(file);
+    wrongVersion[4] = static_cast<char>(enginetool::instancing::fileVersion + 1);
+    const std::string truncated(file, 0, file.size() - 4);
+    // A mesh name of 2^56 - 1 bytes with three bytes behind it
+    const std::string hugeName("PINS\x01\x00\x01\xff\xff\xff\xff\xff\xff\xff\x7f" "abc", 18);
+
+    for (const std::string& damaged : { wrongMagic, wrongVersion, truncated, hugeName }) {
+        uut.push_back(saved[0]);
+        std::istringstream stream(damaged);
+        EXPECT_FALSE(enginetool::instancing::Load(stream, uut));
+        EXPECT_TRUE(uut.empty());
+    }
+
+    std::istringstream intact(file);
+    EXPECT_TRUE(enginetool::instancing::Load(intact, uut));
+}
+
+TEST_F(InstanceBatchTest, AddGrowsBoundsByTheMesh){
+    enginetool::InstanceBatch batch = MakeBatch("human", "default", { { glm::vec3(10.0f, 0.0f, 0.0f) } });
+    EXPECT_EQ(glm::vec3(9.0f, 0.0f, -1.0f), batch.bounds.min);
+    EXPECT_EQ(glm::vec3(11.0f, 2.0f, 1.0f), batch.bounds.max);
+
+    batch.Add(nullptr, 0);
+    EXPECT_EQ(1u, batch.instances.size());
+    EXPECT_EQ(glm::vec3(9.0f, 0.0f, -1.0f), batch.bounds.min);
+
+    const enginetool::InstanceLayout more[] = { { glm::vec3(-5.0f, 3.0f, 0.0f) }, { glm::vec3(0.0f, 0.0f, 40.0f) } };
+    batch.Add(more, 2);
+    EXPECT_EQ(3u, batch.instances.size());
+    EXPECT_EQ(glm::vec3(-6.0f, 0.0f, -1.0f), batch.bounds.min);
+    EXPECT_EQ(glm::vec3(11.0f, 5.0f, 41.0f), batch.bounds.max);
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../puffinEngine/src/InstanceBatch.cpp"
+
+class InstanceBatchTest : public ::testing::Test
+{
+public:
+    InstanceBatchTest() {
+        mesh.aabb.min = glm::vec3(-1.0f, 0.0f, -1.0f);
+        mesh.aabb.max = glm::vec3(1.0f, 2.0f, 1.0f);
+    }
+
+    enginetool::InstanceBatch MakeBatch(const std::string& meshName, const std::string& materialName, const std::vector<enginetool::InstanceLayout>& instances) {
+        enginetool::InstanceBatch batch;
+        batch.meshName = meshName;
+        batch.materialName = materialName;
+        batch.mesh = &mesh;
+        batch.Add(instances.data(), instances.size());
+        return batch;
+    }
+
+    enginetool::ScenePart mesh;
+    std::vector<enginetool::InstanceBatch> uut;
+};
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "MotionKernelsTest.hpp"
+
+TEST_F(MotionKernelsTest, ApproachesGoalByAtMostStep){
+    float positions[] = { 0.0f, 0.0f, 0.0f };
+    float movements[] = { 0.0f, 5.0f, 1.0f };
+    const float goals[] = { 10.0f, -10.0f, 1.5f };
+
+    enginetool::ApproachAndIntegrate(uut, positions, movements, goals, 3, 2.0f, 0.5f);
+
+    EXPECT_FLOAT_EQ(2.0f, movements[0]);
+    EXPECT_FLOAT_EQ(3.0f, movements[1]);
+    EXPECT_FLOAT_EQ(1.5f, movements[2]);
+    EXPECT_FLOAT_EQ(1.0f, positions[0]);
+    EXPECT_FLOAT_EQ(1.5f, positions[1]);
+    EXPECT_FLOAT_EQ(0.75f, positions[2]);
+}
+
+TEST_F(MotionKernelsTest, EveryLevelMatchesScalarBitForBit){
+    // An odd actor count leaves a tail for the scalar loop after the vector iterations.
+    const size_t count = 3 * 1001;
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+    std::vector<float> positions(count), movements(count), goals(count);
+    for (size_t i = 0; i < count; i++) {
+        positions[i] = distribution(generator);
+        movements[i] = distribution(generator);
+        goals[i] = distribution(generator);
+    }
+
+    std::vector<float> expectedPositions = positions, expectedMovements = movements;
+    for (int tick = 0; tick < 10; tick++) {
+        enginetool::ApproachAndIntegrate(enginetool::SimdLevel::Scalar, expectedPositions.data(), expectedMovements.data(), goals.data(), count, 16.6f, 1.0f / 60.0f);
+    }
+
+    for (int level = 0; level <= static_cast<int>(uut); level++) {
+        std::vector<float> actualPositions = positions, actualMovements = movements;
+        for (int tick = 0; tick < 10; tick++) {
+            enginetool::ApproachAndIntegrate(static_cast<enginetool::SimdLevel>(level), actualPositions.data(), actualMovements.data(), goals.data(), count, 16.6f, 1.0f / 60.0f);
+        }
+        EXPECT_EQ(0, std::memcmp(expectedPositions.data(), actualPositions.data(), count * sizeof(float))) << enginetool::GetSimdLevelName(static_cast<enginetool::SimdLevel>(level));
+        EXPECT_EQ(0, std::memcmp(expectedMovements.data(), actualMovements.data(), count * sizeof(float))) << enginetool::GetSimdLevelName(static_cast<enginetool::SimdLevel>(level));
+    }
+}
+
+TEST_F(MotionKernelsTest, SetSimdLevelClampsToSupported){
+    enginetool::SetSimdLevel(enginetool::SimdLevel::Scalar);
+    EXPECT_EQ(enginetool::SimdLevel::Scalar, enginetool::GetSimdLevel());
+
+    enginetool::SetSimdLevel(enginetool::SimdLevel::AVX2);
+    EXPECT_EQ(uut, enginetool::GetSimdLevel());
+}
\ No newline at end of file
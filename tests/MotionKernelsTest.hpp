@@ -0,0 +1,13 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "../puffinEngine/src/MotionKernels.cpp"
+
+class MotionKernelsTest : public ::testing::Test
+{
+public:
+    ~MotionKernelsTest() override { enginetool::SetSimdLevel(enginetool::GetSupportedSimdLevel()); }
+
+    enginetool::SimdLevel uut = enginetool::GetSupportedSimdLevel();
+};
\ No newline at end of file
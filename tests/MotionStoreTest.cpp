@@ -0,0 +1,131 @@
+#include "MotionStoreTest.hpp"
+
+TEST_F(MotionStoreTest, MixedAddsAndRemovesKeepEveryOwnerOnItsSlot){
+    for (int i = 0; i < 10; i++) {
+        Add(i);
+    }
+    ExpectOwnersFindTheirSlots();
+
+    Remove(3);
+    Remove(0);
+    Add(10);
+    Remove(10);
+    Remove(9);
+    Add(11);
+    Add(12);
+    Remove(5);
+    ExpectOwnersFindTheirSlots();
+
+    for (const int owner : std::vector<int>(live)) {
+        Remove(owner);
+        ExpectOwnersFindTheirSlots();
+    }
+    EXPECT_EQ(0u, uut.GetSize());
+    EXPECT_EQ(0u, uut.GetAwakeCount());
+}
+
+TEST_F(MotionStoreTest, RemoveMovesTheLastSlotIntoTheGap){
+    for (int i = 0; i < 4; i++) {
+        Add(i);
+    }
+    uut.movementGoals[slots[3]] = glm::vec3(1.0f, 2.0f, 3.0f);
+    uut.velocities[slots[3]] = glm::vec3(4.0f, 5.0f, 6.0f);
+
+    Remove(1);
+    EXPECT_EQ(1u, slots[3]);
+    EXPECT_EQ(glm::vec3(3.0f, 0.0f, 0.0f), uut.positions[1]);
+    EXPECT_EQ(glm::vec3(1.0f, 2.0f, 3.0f), uut.movementGoals[1]);
+    EXPECT_EQ(glm::vec3(4.0f, 5.0f, 6.0f), uut.velocities[1]);
+    EXPECT_EQ(0u, slots[0]);
+    EXPECT_EQ(2u, slots[2]);
+    ExpectOwnersFindTheirSlots();
+}
+
+TEST_F(MotionStoreTest, SleepMovesTheSlotPastTheAwakeOnesAndSettlesIt){
+    for (int i = 0; i < 5; i++) {
+        Add(i);
+    }
+    uut.positions[slots[1]] = glm::vec3(1.0f, 7.0f, 0.0f);
+    uut.aabbs[slots[1]] = { glm::vec3(1.0f, 6.0f, -1.0f), glm::vec3(2.0f, 8.0f, 1.0f) };
+
+    uut.Sleep(slots[1]);
+    EXPECT_EQ(4u, uut.GetAwakeCount());
+    EXPECT_EQ(4u, slots[1]);
+    EXPECT_FALSE(uut.IsAwake(slots[1]));
+    EXPECT_EQ(glm::vec3(1.0f, 7.0f, 0.0f), uut.positions[slots[1]]);
+    EXPECT_EQ(glm::vec3(1.0f, 7.0f, 0.0f), uut.previousPositions[slots[1]]);
+    EXPECT_EQ(glm::vec3(1.0f, 7.0f, 0.0f), uut.renderPositions[slots[1]]);
+    EXPECT_EQ(glm::vec3(2.0f, 8.0f, 1.0f), uut.aabbs[slots[1]].max);
+
+    // Sleeping again changes nothing, the others stay awake on their own data
+    uut.Sleep(slots[1]);
+    EXPECT_EQ(4u, uut.GetAwakeCount());
+    for (const int owner : { 0, 2, 3, 4 }) {
+        EXPECT_TRUE(uut.IsAwake(slots[owner]));
+        EXPECT_EQ(static_cast<float>(owner), uut.positions[slots[owner]].x);
+        EXPECT_EQ(static_cast<float>(owner), uut.aabbs[slots[owner]].min.x);
+    }
+}
+
+TEST_F(MotionStoreTest, WakeMovesTheSlotBackAmongTheAwakeOnes){
+    for (int i = 0; i < 6; i++) {
+        Add(i);
+    }
+    uut.Sleep(slots[0]);
+    uut.Sleep(slots[3]);
+    uut.Sleep(slots[5]);
+    EXPECT_EQ(3u, uut.GetAwakeCount());
+    ExpectOwnersFindTheirSlots();
+
+    // Only the first wake-up reports it, so the owner joins the wake queue once
+    EXPECT_TRUE(uut.Wake(slots[3]));
+    EXPECT_FALSE(uut.Wake(slots[3]));
+    EXPECT_FALSE(uut.Wake(slots[1]));
+    EXPECT_EQ(4u, uut.GetAwakeCount());
+    EXPECT_TRUE(uut.IsAwake(slots[3]));
+    EXPECT_FALSE(uut.IsAwake(slots[0]));
+    EXPECT_FALSE(uut.IsAwake(slots[5]));
+    ExpectOwnersFindTheirSlots();
+}
+
+TEST_F(MotionStoreTest, RemovingAnAwakeSlotKeepsTheSleepingOnes){
+    for (int i = 0; i < 6; i++) {
+        Add(i);
+    }
+    uut.Sleep(slots[4]);
+    uut.Sleep(slots[5]);
+
+    Remove(1);
+    EXPECT_EQ(3u, uut.GetAwakeCount());
+    EXPECT_FALSE(uut.IsAwake(slots[4]));
+    EXPECT_FALSE(uut.IsAwake(slots[5]));
+    ExpectOwnersFindTheirSlots();
+
+    Remove(5);
+    EXPECT_EQ(3u, uut.GetAwakeCount());
+    ExpectOwnersFindTheirSlots();
+}
+
+TEST_F(MotionStoreTest, SleepingPartOfABucketKeepsTheOthersOnTheirSlots){
+    std::vector<int> bucket;
+    for (int i = 0; i < 9; i++) {
+        Add(i);
+        bucket.push_back(i);
+    }
+
+    // Same erase as the end of Scene::UpdateBucket, every third owner keeps moving
+    bucket.erase(std::remove_if(bucket.begin(), bucket.end(), [this](int owner) {
+        if (owner % 3 == 1) {
+            return false;
+        }
+        uut.Sleep(slots[owner]);
+        return true;
+    }), bucket.end());
+
+    EXPECT_EQ(std::vector<int>({ 1, 4, 7 }), bucket);
+    EXPECT_EQ(3u, uut.GetAwakeCount());
+    for (const int owner : live) {
+        EXPECT_EQ(owner % 3 == 1, uut.IsAwake(slots[owner]));
+    }
+    ExpectOwnersFindTheirSlots();
+}
\ No newline at end of file
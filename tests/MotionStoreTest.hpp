@@ -0,0 +1,39 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../puffinEngine/src/MotionStore.cpp"
+
+class MotionStoreTest : public ::testing::Test
+{
+public:
+    // Owner i sits at x = i, so a slot tells whose data it holds
+    void Add(int owner) {
+        uut.Add(glm::vec3(static_cast<float>(owner), 0.0f, 0.0f), slots[owner]);
+        live.push_back(owner);
+    }
+
+    void Remove(int owner) {
+        uut.Remove(slots[owner]);
+        live.erase(std::find(live.begin(), live.end(), owner));
+    }
+
+    void ExpectOwnersFindTheirSlots() {
+        ASSERT_EQ(live.size(), uut.GetSize());
+        std::vector<bool> used(uut.GetSize(), false);
+        for (const int owner : live) {
+            ASSERT_LT(slots[owner], uut.GetSize());
+            EXPECT_FALSE(used[slots[owner]]);
+            used[slots[owner]] = true;
+            EXPECT_EQ(static_cast<float>(owner), uut.positions[slots[owner]].x);
+            EXPECT_EQ(static_cast<float>(owner), uut.aabbs[slots[owner]].min.x);
+        }
+    }
+
+    uint32_t slots[32] = {};
+    std::vector<int> live;
+    enginetool::MotionStore uut;
+};
\ No newline at end of file
@@ -0,0 +1,52 @@
+#include <cstdio>
+#include <sstream>
+
+#include "NameTableTest.hpp"
+
+TEST_F(NameTableTest, InternsEachStringOnce){
+    const enginetool::NameId teapot = uut.Intern("Test object amelinium teapot");
+    const enginetool::NameId plane = uut.Intern("I am simple plane, boring");
+
+    EXPECT_NE(teapot, plane);
+    EXPECT_EQ(teapot, uut.Intern(std::string("Test object amelinium teapot")));
+    EXPECT_EQ(0u, uut.Intern(""));
+    EXPECT_EQ(3u, uut.GetCount());
+    EXPECT_EQ("I am simple plane, boring", uut.Lookup(plane));
+    EXPECT_THROW(uut.Lookup(42), std::runtime_error);
+}
+
+TEST_F(NameTableTest, OpenedTableIsReadOnFirstUse){
+    const std::string path = "nameTableTest.bin";
+    enginetool::NameTable saved;
+    const enginetool::NameId hero = saved.Intern("Brave hero");
+    const enginetool::NameId sky = saved.Intern("Test skybox");
+    ASSERT_TRUE(saved.Save(path));
+
+    uut.Open(path);
+    EXPECT_EQ("Test skybox", uut.Lookup(sky));
+    std::remove(path.c_str());
+    EXPECT_EQ("Brave hero", uut.Lookup(hero));
+    EXPECT_EQ(hero, uut.Intern("Brave hero"));
+    EXPECT_EQ(3u, uut.GetCount());
+
+    uut.Open(path);
+    EXPECT_THROW(uut.GetCount(), std::runtime_error);
+}
+
+TEST_F(NameTableTest, RejectsCorruptStreams){
+    uut.Intern("kept only until the failed load");
+    std::istringstream wrongMagic("XNAM");
+    EXPECT_FALSE(uut.Load(wrongMagic));
+    EXPECT_EQ(1u, uut.GetCount());
+
+    std::string duplicates("PNAM\x01\x00\x03\x00\x01" "a" "\x01" "a", 13);
+    std::istringstream stream(duplicates);
+    EXPECT_FALSE(uut.Load(stream));
+    EXPECT_EQ(1u, uut.GetCount());
+
+    // A length of 2^56 - 1 with three bytes behind it fails at the end of the stream, not in the allocator
+    std::string hugeLength("PNAM\x01\x00\x02\x00\xff\xff\xff\xff\xff\xff\xff\x7f" "abc", 19);
+    std::istringstream truncated(hugeLength);
+    EXPECT_FALSE(uut.Load(truncated));
+    EXPECT_EQ(1u, uut.GetCount());
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "../puffinEngine/src/NameTable.cpp"
+
+class NameTableTest : public ::testing::Test
+{
+public:
+    enginetool::NameTable uut;
+};
\ No newline at end of file
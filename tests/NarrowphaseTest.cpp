@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <random>
+
+#include "NarrowphaseTest.hpp"
+
+namespace {
+    using Contacts = std::vector<enginetool::Narrowphase::Contact>;
+
+    // Six floats per box: characters of the test scene in a crowd, some of them overlapping, and two large landscape planes
+    std::vector<float> Crowd(uint32_t seed, size_t count) {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> place(-1500.0f, 1500.0f);
+        std::vector<float> boxes;
+        for (size_t i = 0; i < count; i++) {
+            const float x = place(random), z = place(random);
+            boxes.insert(boxes.end(), { x - 10.0f, 0.0f, z - 10.0f, x + 10.0f, 71.0f, z + 10.0f });
+        }
+        boxes.insert(boxes.end(), { -2000.0f, -5.0f, -2000.0f, 2000.0f, 0.0f, 2000.0f });
+        boxes.insert(boxes.end(), { -100.0f, 0.0f, -100.0f, 100.0f, 0.0f, 100.0f });
+        return boxes;
+    }
+
+    void Fill(enginetool::SpatialHash& broadphase, const std::vector<float>& boxes) {
+        broadphase.Clear();
+        for (size_t i = 0; i < boxes.size() / 6; i++) {
+            broadphase.Insert(static_cast<uint32_t>(i), &boxes[i * 6], &boxes[i * 6 + 3]);
+        }
+        broadphase.Build();
+    }
+}
+
+TEST_F(NarrowphaseTest, FindsEveryOverlappingPairOnce){
+    const std::vector<float> boxes = Crowd(24, 3000);
+    enginetool::SpatialHash broadphase(64.0f);
+    Fill(broadphase, boxes);
+
+    Contacts contacts;
+    uut.FindContacts(nullptr, broadphase, boxes.data(), contacts);
+    std::sort(contacts.begin(), contacts.end());
+
+    Contacts expected;
+    const size_t count = boxes.size() / 6;
+    for (uint32_t a = 0; a < count; a++) {
+        for (uint32_t b = a + 1; b < count; b++) {
+            bool overlap = true;
+            for (int axis = 0; axis < 3; axis++) {
+                overlap = overlap && boxes[a * 6 + 3 + axis] >= boxes[b * 6 + axis] && boxes[a * 6 + axis] <= boxes[b * 6 + 3 + axis];
+            }
+            if (overlap) expected.emplace_back(a, b);
+        }
+    }
+    EXPECT_GT(expected.size(), count);
+    EXPECT_EQ(expected, contacts);
+}
+
+TEST_F(NarrowphaseTest, SameContactsForAnyThreadCount){
+    const std::vector<float> boxes = Crowd(9, 5000);
+    enginetool::SpatialHash broadphase(64.0f);
+    Fill(broadphase, boxes);
+    Contacts pairs;
+    broadphase.FindPairs(pairs);
+
+    Contacts serial, serialFromPairs;
+    uut.FindContacts(nullptr, broadphase, boxes.data(), serial);
+    uut.FindContacts(nullptr, pairs, boxes.data(), serialFromPairs);
+    for (uint32_t threads : { 1u, 2u, 4u, 7u }) {
+        enginetool::ThreadPool pool;
+        pool.SetThreadCount(threads);
+        enginetool::Narrowphase narrowphase;
+        Contacts parallel, parallelFromPairs;
+        narrowphase.FindContacts(&pool, broadphase, boxes.data(), parallel);
+        narrowphase.FindContacts(&pool, pairs, boxes.data(), parallelFromPairs);
+        EXPECT_EQ(serial, parallel) << threads << " threads";
+        EXPECT_EQ(serialFromPairs, parallelFromPairs) << threads << " threads";
+    }
+}
+
+TEST_F(NarrowphaseTest, PairListKeepsOrderAndAppends){
+    // Box 1 touches box 0 on a face, box 2 is apart from both
+    const std::vector<float> boxes = {
+        0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f,
+        1.0f, 0.0f, 0.0f, 2.0f, 1.0f, 1.0f,
+        5.0f, 5.0f, 5.0f, 6.0f, 6.0f, 6.0f };
+    Contacts pairs;
+    for (int i = 0; i < 3000; i++) {
+        pairs.emplace_back(1, 0);
+        pairs.emplace_back(0, 2);
+        pairs.emplace_back(0, 1);
+    }
+
+    Contacts contacts = { { 7, 8 } };
+    uut.FindContacts(nullptr, pairs, boxes.data(), contacts);
+    ASSERT_EQ(6001u, contacts.size());
+    EXPECT_EQ(enginetool::Narrowphase::Contact(7, 8), contacts[0]);
+    for (size_t i = 1; i < contacts.size(); i += 2) {
+        EXPECT_EQ(enginetool::Narrowphase::Contact(1, 0), contacts[i]);
+        EXPECT_EQ(enginetool::Narrowphase::Contact(0, 1), contacts[i + 1]);
+    }
+}
\ No newline at end of file
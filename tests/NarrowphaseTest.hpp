@@ -0,0 +1,11 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "../puffinEngine/src/Narrowphase.cpp"
+
+class NarrowphaseTest : public ::testing::Test
+{
+public:
+    enginetool::Narrowphase uut;
+};
\ No newline at end of file
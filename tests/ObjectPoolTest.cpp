@@ -0,0 +1,49 @@
+#include <vector>
+
+#include "ObjectPoolTest.hpp"
+
+TEST_F(ObjectPoolTest, ReusesFreedSlots){
+    Pooled* first = uut.Create("first", alive);
+    Pooled* second = uut.Create("second", alive);
+    EXPECT_EQ(2, alive);
+    EXPECT_EQ(2u, uut.GetLiveCount());
+
+    uut.Destroy(first);
+    EXPECT_EQ(1, alive);
+    Pooled* third = uut.Create("third", alive);
+    EXPECT_EQ(first, third);
+    EXPECT_EQ("third", third->name);
+
+    uut.Destroy(second);
+    uut.Destroy(third);
+    EXPECT_EQ(0u, uut.GetLiveCount());
+    EXPECT_EQ(4u, uut.GetCapacity());
+}
+
+TEST_F(ObjectPoolTest, GrowsWithoutMovingObjects){
+    std::vector<Pooled*> objects;
+    for (int i = 0; i < 10; i++) {
+        objects.push_back(uut.Create(std::to_string(i), alive));
+    }
+    EXPECT_GE(uut.GetCapacity(), 10u);
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(std::to_string(i), objects[i]->name);
+        uut.Destroy(objects[i]);
+    }
+    EXPECT_EQ(0, alive);
+}
+
+TEST_F(ObjectPoolTest, SharedOwnersReturnSlotsToThePool){
+    uut.Reserve(100);
+    const size_t capacity = uut.GetCapacity();
+    {
+        std::vector<std::shared_ptr<Pooled>> owners;
+        for (int i = 0; i < 100; i++) {
+            owners.push_back(uut.MakeShared("shared", alive));
+        }
+        EXPECT_EQ(100, alive);
+        EXPECT_EQ(capacity, uut.GetCapacity());
+    }
+    EXPECT_EQ(0, alive);
+    EXPECT_EQ(0u, uut.GetLiveCount());
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "../puffinEngine/headers/ObjectPool.hpp"
+
+struct Pooled {
+    Pooled(std::string name, int& alive) : name(name), alive(alive) { alive++; }
+    ~Pooled() { alive--; }
+
+    std::string name;
+    int& alive;
+};
+
+class ObjectPoolTest : public ::testing::Test
+{
+public:
+    int alive = 0;
+    enginetool::ObjectPool<Pooled> uut{ 4 };
+};
\ No newline at end of file
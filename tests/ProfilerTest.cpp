@@ -0,0 +1,39 @@
+#include <sstream>
+#include <thread>
+
+#include "ProfilerTest.hpp"
+
+TEST_F(ProfilerTest, WritesZonesCountersAndFramesAsChromeTrace){
+    enginetool::profiler::Frame("Frame");
+    {
+        enginetool::profiler::Zone zone("Outer \"zone\"");
+        enginetool::profiler::Counter("Ticks per frame", 3);
+    }
+    std::thread worker([]() {
+        enginetool::profiler::SetThreadName("Worker 0");
+        enginetool::profiler::Zone zone("Job");
+    });
+    worker.join();
+
+    std::stringstream stream;
+    enginetool::profiler::WriteChromeTrace(stream);
+    const std::string trace = stream.str();
+
+    EXPECT_EQ(0u, trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+    EXPECT_NE(std::string::npos, trace.find("\"name\":\"Outer \\\"zone\\\"\""));
+    EXPECT_NE(std::string::npos, trace.find("\"ph\":\"X\""));
+    EXPECT_NE(std::string::npos, trace.find("\"ph\":\"C\",\"args\":{\"value\":3}"));
+    EXPECT_NE(std::string::npos, trace.find("\"ph\":\"i\""));
+    EXPECT_NE(std::string::npos, trace.find("\"args\":{\"name\":\"Worker 0\"}"));
+}
+
+TEST_F(ProfilerTest, KeepsOnlyNewestEventsPerThread){
+    for (int i = 0; i < (1 << 16) + 10; i++) {
+        enginetool::profiler::Counter("Counter", i);
+    }
+
+    std::stringstream stream;
+    enginetool::profiler::WriteChromeTrace(stream);
+    EXPECT_EQ(std::string::npos, stream.str().find("{\"value\":9}"));
+    EXPECT_NE(std::string::npos, stream.str().find("{\"value\":65545}"));
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "../puffinEngine/src/Profiler.cpp"
+
+class ProfilerTest : public ::testing::Test
+{
+public:
+    void SetUp() override {
+        enginetool::profiler::Clear();
+    }
+};
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "RayKernelsTest.hpp"
+
+namespace {
+    // Six arrays of boxes, laid out the way BoxArrays points into them
+    struct BoxStore {
+        explicit BoxStore(size_t count) : count(count), bounds(count * 6) {}
+
+        void Set(size_t i, float minX, float minY, float minZ, float maxX, float maxY, float maxZ) {
+            const float values[6] = { minX, minY, minZ, maxX, maxY, maxZ };
+            for (int bound = 0; bound < 6; bound++) bounds[bound * count + i] = values[bound];
+        }
+
+        enginetool::BoxArrays Arrays() const {
+            enginetool::BoxArrays arrays;
+            for (int axis = 0; axis < 3; axis++) {
+                arrays.min[axis] = bounds.data() + axis * count;
+                arrays.max[axis] = bounds.data() + (3 + axis) * count;
+            }
+            return arrays;
+        }
+
+        size_t count;
+        std::vector<float> bounds;
+    };
+
+    // Rays often run along an axis in the scene, so a third of the direction components are zero and give infinite dirFracs
+    void RandomRay(std::mt19937& random, float* origin, float* dirFrac) {
+        std::uniform_real_distribution<float> place(-120.0f, 120.0f);
+        std::uniform_real_distribution<float> turn(-1.0f, 1.0f);
+        for (int axis = 0; axis < 3; axis++) {
+            origin[axis] = place(random);
+            const float direction = (random() % 3 == 0) ? 0.0f : turn(random);
+            dirFrac[axis] = 1.0f / direction;
+        }
+    }
+
+    BoxStore RandomBoxes(std::mt19937& random, size_t count) {
+        std::uniform_real_distribution<float> place(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> size(0.0f, 30.0f);
+        BoxStore boxes(count);
+        for (size_t i = 0; i < count; i++) {
+            const float x = place(random), y = place(random), z = place(random);
+            boxes.Set(i, x, y, z, x + size(random), y + size(random), z + size(random));
+        }
+        return boxes;
+    }
+}
+
+TEST_F(RayKernelsTest, FindsNearestBoxAlongTheRay){
+    // Along +x: a box behind the origin, one around it, two the same distance ahead and one past maxDistance
+    BoxStore boxes(5);
+    boxes.Set(0, -30.0f, -1.0f, -1.0f, -20.0f, 1.0f, 1.0f);
+    boxes.Set(1, 40.0f, -1.0f, -1.0f, 50.0f, 1.0f, 1.0f);
+    boxes.Set(2, 10.0f, -1.0f, -1.0f, 20.0f, 1.0f, 1.0f);
+    boxes.Set(3, 10.0f, -5.0f, -5.0f, 12.0f, 5.0f, 5.0f);
+    boxes.Set(4, 500.0f, -1.0f, -1.0f, 510.0f, 1.0f, 1.0f);
+    const float origin[3] = { 0.0f, 0.0f, 0.0f };
+    const float dirFrac[3] = { 1.0f, 1.0f / 0.0f, 1.0f / 0.0f };
+
+    float distances[5];
+    enginetool::IntersectRayBoxes(uut, origin, dirFrac, boxes.Arrays(), 5, distances);
+    EXPECT_EQ(std::numeric_limits<float>::infinity(), distances[0]);
+    EXPECT_EQ(40.0f, distances[1]);
+    EXPECT_EQ(10.0f, distances[2]);
+    EXPECT_EQ(10.0f, distances[3]);
+    EXPECT_EQ(500.0f, distances[4]);
+
+    float distance = -1.0f;
+    EXPECT_EQ(2u, enginetool::NearestRayBox(uut, origin, dirFrac, boxes.Arrays(), 5, 100.0f, distance));
+    EXPECT_EQ(10.0f, distance);
+    EXPECT_EQ(5u, enginetool::NearestRayBox(uut, origin, dirFrac, boxes.Arrays(), 5, 9.0f, distance));
+    EXPECT_EQ(10.0f, distance);
+
+    // Starting inside a box enters it behind the origin
+    boxes.Set(4, -5.0f, -1.0f, -1.0f, 5.0f, 1.0f, 1.0f);
+    EXPECT_EQ(4u, enginetool::NearestRayBox(uut, origin, dirFrac, boxes.Arrays(), 5, std::numeric_limits<float>::infinity(), distance));
+    EXPECT_EQ(-5.0f, distance);
+}
+
+TEST_F(RayKernelsTest, EveryLevelMatchesScalarBitForBit){
+    // Counts that leave tails for the narrower paths after the vector iterations
+    std::mt19937 random(21);
+    for (size_t count : { 0u, 3u, 4u, 13u, 1001u }) {
+        const BoxStore boxes = RandomBoxes(random, count);
+        for (int ray = 0; ray < 200; ray++) {
+            float origin[3], dirFrac[3];
+            RandomRay(random, origin, dirFrac);
+            const float maxDistance = (ray % 2 == 0) ? std::numeric_limits<float>::max() : 80.0f;
+
+            std::vector<float> expected(count);
+            enginetool::IntersectRayBoxes(enginetool::SimdLevel::Scalar, origin, dirFrac, boxes.Arrays(), count, expected.data());
+            float expectedDistance = 0.0f;
+            const size_t expectedNearest = enginetool::NearestRayBox(enginetool::SimdLevel::Scalar, origin, dirFrac, boxes.Arrays(), count, maxDistance, expectedDistance);
+
+            for (int level = 1; level <= static_cast<int>(uut); level++) {
+                const auto simd = static_cast<enginetool::SimdLevel>(level);
+                std::vector<float> actual(count);
+                enginetool::IntersectRayBoxes(simd, origin, dirFrac, boxes.Arrays(), count, actual.data());
+                if (count > 0) {
+                    EXPECT_EQ(0, std::memcmp(expected.data(), actual.data(), count * sizeof(float))) << enginetool::GetSimdLevelName(simd);
+                }
+
+                float actualDistance = 0.0f;
+                EXPECT_EQ(expectedNearest, enginetool::NearestRayBox(simd, origin, dirFrac, boxes.Arrays(), count, maxDistance, actualDistance)) << enginetool::GetSimdLevelName(simd);
+                EXPECT_EQ(expectedDistance, actualDistance) << enginetool::GetSimdLevelName(simd);
+            }
+        }
+    }
+}
+
+TEST_F(RayKernelsTest, PacketMatchesOneRayAtATime){
+    std::mt19937 random(22);
+    const size_t count = 1003;
+    std::vector<float> rays(count * 6);
+    for (size_t i = 0; i < count; i++) {
+        float origin[3], dirFrac[3];
+        RandomRay(random, origin, dirFrac);
+        for (int axis = 0; axis < 3; axis++) {
+            rays[axis * count + i] = origin[axis];
+            rays[(3 + axis) * count + i] = dirFrac[axis];
+        }
+    }
+    enginetool::RayArrays packet;
+    for (int axis = 0; axis < 3; axis++) {
+        packet.origin[axis] = rays.data() + axis * count;
+        packet.dirFrac[axis] = rays.data() + (3 + axis) * count;
+    }
+    const BoxStore box = RandomBoxes(random, 1);
+    const float min[3] = { box.bounds[0], box.bounds[1], box.bounds[2] };
+    const float max[3] = { box.bounds[3], box.bounds[4], box.bounds[5] };
+
+    std::vector<float> expected(count);
+    for (size_t i = 0; i < count; i++) {
+        const float origin[3] = { packet.origin[0][i], packet.origin[1][i], packet.origin[2][i] };
+        const float dirFrac[3] = { packet.dirFrac[0][i], packet.dirFrac[1][i], packet.dirFrac[2][i] };
+        enginetool::IntersectRayBoxes(enginetool::SimdLevel::Scalar, origin, dirFrac, box.Arrays(), 1, &expected[i]);
+    }
+    for (int level = 0; level <= static_cast<int>(uut); level++) {
+        const auto simd = static_cast<enginetool::SimdLevel>(level);
+        std::vector<float> actual(count);
+        enginetool::IntersectRaysBox(simd, packet, count, min, max, actual.data());
+        EXPECT_EQ(0, std::memcmp(expected.data(), actual.data(), count * sizeof(float))) << enginetool::GetSimdLevelName(simd);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "../puffinEngine/src/RayKernels.cpp"
+
+class RayKernelsTest : public ::testing::Test
+{
+public:
+    enginetool::SimdLevel uut = enginetool::GetSupportedSimdLevel();
+};
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include <cstdio>
+#include <fstream>
+
+#include "SceneSnapshotTest.hpp"
+
+namespace {
+    enginetool::snapshot::ActorRecord MakeActor(enginetool::SceneSnapshotWriter& writer, const std::string& name, float z) {
+        enginetool::snapshot::ActorRecord actor = {};
+        actor.type = 1;
+        actor.name = writer.AddString(name);
+        actor.description = writer.AddString("I am simple plane, boring");
+        actor.mesh = writer.AddString("plane");
+        actor.material = writer.AddString("default");
+        actor.position[2] = z;
+        actor.maxHealth = 1000;
+        actor.currentHealth = 1000;
+        return actor;
+    }
+}
+
+TEST_F(SceneSnapshotTest, ReadsSavedSceneInPlace){
+    const std::string path = "sceneSnapshotTest.pscn";
+    enginetool::SceneSnapshotWriter writer;
+    writer.AddActor(MakeActor(writer, "Test object plane2", 0.0f));
+    writer.AddActor(MakeActor(writer, "Test object plane3", 40.0f));
+    writer.SetSceneLight(1);
+    const float posts[] = { 0.0f, 0.0f, 1000.0f, 0.0f, 0.0f, 2000.0f };
+    writer.AddBatch("human", "default", posts, 2);
+    ASSERT_TRUE(writer.Save(path));
+
+    ASSERT_TRUE(uut.Open(path));
+    const enginetool::snapshot::Header& header = uut.GetHeader();
+    ASSERT_EQ(2u, header.actorCount);
+    EXPECT_EQ(1u, header.sceneLight);
+    EXPECT_STREQ("Test object plane3", uut.GetString(uut.GetActors()[1].name));
+    EXPECT_EQ(uut.GetActors()[0].description, uut.GetActors()[1].description);
+    EXPECT_EQ(40.0f, uut.GetActors()[1].position[2]);
+
+    ASSERT_EQ(1u, header.batchCount);
+    const enginetool::snapshot::BatchRecord& batch = uut.GetBatches()[0];
+    EXPECT_STREQ("human", uut.GetString(batch.mesh));
+    EXPECT_EQ(uut.GetActors()[0].material, batch.material);
+    EXPECT_EQ(2u, batch.instanceCount);
+    EXPECT_EQ(2000.0f, uut.GetInstancePositions()[(batch.firstInstance + 1) * 3 + 2]);
+
+    uut.Close();
+    EXPECT_FALSE(uut.IsOpen());
+    std::remove(path.c_str());
+}
+
+TEST_F(SceneSnapshotTest, EmptySceneRoundTrips){
+    const std::string path = "sceneSnapshotTest.pscn";
+    ASSERT_TRUE(enginetool::SceneSnapshotWriter().Save(path));
+
+    ASSERT_TRUE(uut.Open(path));
+    EXPECT_EQ(0u, uut.GetHeader().actorCount);
+    EXPECT_EQ(0u, uut.GetHeader().batchCount);
+    EXPECT_EQ(enginetool::snapshot::none, uut.GetHeader().sceneLight);
+    std::remove(path.c_str());
+}
+
+TEST_F(SceneSnapshotTest, RejectsDamagedFiles){
+    const std::string path = "sceneSnapshotTest.pscn";
+    EXPECT_FALSE(uut.Open(path));
+
+    enginetool::SceneSnapshotWriter writer;
+    writer.AddActor(MakeActor(writer, "Test object plane", -20.0f));
+    ASSERT_TRUE(writer.Save(path));
+    std::string bytes;
+    {
+        std::ifstream file(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // cut into the string block
+    std::ofstream(path, std::ios::binary | std::ios::trunc).write(bytes.data(), bytes.size() - 4);
+    EXPECT_FALSE(uut.Open(path));
+
+    // name offset past the end of the string block
+    std::string badName(bytes);
+    badName[sizeof(enginetool::snapshot::Header) + offsetof(enginetool::snapshot::ActorRecord, name)] = '\x7f';
+    std::ofstream(path, std::ios::binary | std::ios::trunc).write(badName.data(), badName.size());
+    EXPECT_FALSE(uut.Open(path));
+    EXPECT_FALSE(uut.IsOpen());
+
+    std::string wrongMagic(bytes);
+    wrongMagic[0] = 'X';
+    std::ofstream(path, std::ios::binary | std::ios::trunc).write(wrongMagic.data(), wrongMagic.size());
+    EXPECT_FALSE(uut.Open(path));
+
+    std::ofstream(path, std::ios::binary | std::ios::trunc).write(bytes.data(), bytes.size());
+    EXPECT_TRUE(uut.Open(path));
+    std::remove(path.c_str());
+}
\ No newline at end of file
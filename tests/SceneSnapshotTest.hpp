@@ -0,0 +1,11 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "../puffinEngine/src/SceneSnapshot.cpp"
+
+class SceneSnapshotTest : public ::testing::Test
+{
+public:
+    enginetool::SceneSnapshot uut;
+};
\ No newline at end of file
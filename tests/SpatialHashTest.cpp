@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <limits>
+#include <random>
+
+#include "SpatialHashTest.hpp"
+
+namespace {
+    struct Box {
+        float min[3];
+        float max[3];
+    };
+
+    bool Overlaps(const Box& a, const Box& b) {
+        for (int axis = 0; axis < 3; axis++) {
+            if (a.max[axis] < b.min[axis] || b.max[axis] < a.min[axis]) return false;
+        }
+        return true;
+    }
+
+    // A character of the test scene, 20 x 71 x 20 with its origin at the feet
+    Box Character(float x, float y, float z) {
+        return { { x - 10.0f, y, z - 10.0f }, { x + 10.0f, y + 71.0f, z + 10.0f } };
+    }
+}
+
+TEST_F(SpatialHashTest, QueryFindsEachBoxOnce){
+    uut.Insert(7, Character(0.0f, 0.0f, 0.0f).min, Character(0.0f, 0.0f, 0.0f).max);
+    uut.Insert(8, Character(60.0f, 0.0f, 60.0f).min, Character(60.0f, 0.0f, 60.0f).max);
+    uut.Insert(9, Character(1000.0f, 0.0f, 0.0f).min, Character(1000.0f, 0.0f, 0.0f).max);
+    const Box plane = { { -500.0f, 0.0f, -500.0f }, { 500.0f, 0.0f, 500.0f } };
+    uut.Insert(10, plane.min, plane.max);
+    uut.Build();
+
+    std::vector<uint32_t> candidates;
+    const Box around = { { -30.0f, -30.0f, -30.0f }, { 130.0f, 130.0f, 130.0f } };
+    uut.Query(around.min, around.max, candidates);
+    std::sort(candidates.begin(), candidates.end());
+    EXPECT_EQ((std::vector<uint32_t>{ 7, 8, 10 }), candidates);
+
+    candidates.clear();
+    uut.Query(Character(1000.0f, 0.0f, 0.0f).min, Character(1000.0f, 0.0f, 0.0f).max, candidates);
+    EXPECT_EQ((std::vector<uint32_t>{ 9 }), candidates);
+
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;
+    uut.FindPairs(pairs);
+    std::sort(pairs.begin(), pairs.end());
+    EXPECT_EQ((std::vector<std::pair<uint32_t, uint32_t>>{ { 7, 8 }, { 7, 10 }, { 8, 10 } }), pairs);
+}
+
+TEST_F(SpatialHashTest, TenThousandMovingCharactersMatchBruteForce){
+    const size_t count = 10000;
+    std::mt19937 random(19);
+    std::uniform_real_distribution<float> place(-2000.0f, 2000.0f);
+    std::uniform_real_distribution<float> step(-15.0f, 15.0f);
+    std::vector<Box> boxes(count);
+    std::vector<float> x(count), z(count);
+    for (size_t i = 0; i < count; i++) {
+        x[i] = place(random);
+        z[i] = place(random);
+    }
+
+    for (int tick = 0; tick < 3; tick++) {
+        uut.Clear();
+        for (size_t i = 0; i < count; i++) {
+            x[i] += step(random);
+            z[i] += step(random);
+            boxes[i] = Character(x[i], 0.0f, z[i]);
+            uut.Insert(static_cast<uint32_t>(i), boxes[i].min, boxes[i].max);
+        }
+        uut.Build();
+
+        std::vector<std::pair<uint32_t, uint32_t>> expected;
+        for (uint32_t a = 0; a < count; a++) {
+            for (uint32_t b = a + 1; b < count; b++) {
+                if (Overlaps(boxes[a], boxes[b])) expected.emplace_back(a, b);
+            }
+        }
+        ASSERT_FALSE(expected.empty());
+
+        std::vector<std::pair<uint32_t, uint32_t>> candidates, found;
+        uut.FindPairs(candidates);
+        for (const auto& pair : candidates) {
+            if (Overlaps(boxes[pair.first], boxes[pair.second])) found.push_back(pair);
+        }
+        std::sort(found.begin(), found.end());
+        EXPECT_EQ(expected, found);
+        EXPECT_LT(candidates.size(), count * 4);
+
+        // What Actor::CheckCollisions asks for: everything one character touches
+        std::vector<uint32_t> touching;
+        for (uint32_t i = 0; i < count; i += 97) {
+            touching.clear();
+            uut.Query(boxes[i].min, boxes[i].max, touching);
+            const size_t hits = std::count_if(touching.begin(), touching.end(), [&](uint32_t other) { return other != i && Overlaps(boxes[i], boxes[other]); });
+            const size_t expectedHits = std::count_if(expected.begin(), expected.end(), [i](const std::pair<uint32_t, uint32_t>& pair) { return pair.first == i || pair.second == i; });
+            EXPECT_EQ(expectedHits, hits);
+        }
+    }
+}
+
+TEST_F(SpatialHashTest, SurvivesDegenerateBoxes){
+    const float inf = std::numeric_limits<float>::infinity();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const Box everything = { { -inf, -inf, -inf }, { inf, inf, inf } };
+    const Box broken = { { nan, 0.0f, 0.0f }, { nan, 1.0f, 1.0f } };
+    uut.Insert(1, everything.min, everything.max);
+    uut.Insert(2, broken.min, broken.max);
+    uut.Insert(3, Character(0.0f, 0.0f, 0.0f).min, Character(0.0f, 0.0f, 0.0f).max);
+    uut.Build();
+
+    std::vector<uint32_t> candidates;
+    uut.Query(Character(0.0f, 0.0f, 0.0f).min, Character(0.0f, 0.0f, 0.0f).max, candidates);
+    std::sort(candidates.begin(), candidates.end());
+    EXPECT_EQ((std::vector<uint32_t>{ 1, 3 }), candidates);
+
+    uut.Clear();
+    uut.Build();
+    candidates.clear();
+    uut.Query(everything.min, everything.max, candidates);
+    EXPECT_TRUE(candidates.empty());
+    EXPECT_EQ(0u, uut.GetCount());
+}
\ No newline at end of file
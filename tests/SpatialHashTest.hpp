@@ -0,0 +1,11 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "../puffinEngine/src/SpatialHash.cpp"
+
+class SpatialHashTest : public ::testing::Test
+{
+public:
+    enginetool::SpatialHash uut{ 64.0f };
+};
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include <cstdlib>
+#include <new>
+#include <sstream>
+
+#include "TaskGraphTest.hpp"
+
+namespace {
+    std::atomic<size_t> allocations{ 0 };
+}
+
+// Counts every allocation of the test binary, so a test can check that a stretch of code does not allocate
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+// GCC takes the new and delete expressions it inlines these into for a mismatched pair
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpragmas"
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+TEST_F(TaskGraphTest, DependenciesFollowDeclaredResources){
+    uut.AddTask("positions", []() {}, {}, {"actors", "camera"});
+    uut.AddTask("skybox", []() {}, {"camera"}, {"uboSkybox"});
+    uut.AddTask("parameters", []() {}, {"actors"}, {"uboParameters"});
+    uut.AddTask("dynamic", []() {}, {}, {"uboDynamic"});
+    uut.AddTask("move camera", []() {}, {}, {"camera"});
+
+    EXPECT_EQ(std::vector<uint32_t>({0}), uut.GetDependencies(1));
+    EXPECT_EQ(std::vector<uint32_t>({0}), uut.GetDependencies(2));
+    EXPECT_TRUE(uut.GetDependencies(3).empty());
+    EXPECT_EQ(std::vector<uint32_t>({0, 1}), uut.GetDependencies(4));
+}
+
+TEST_F(TaskGraphTest, RunsDependentTasksInOrder){
+    threadPool.SetThreadCount(4);
+    std::atomic<int> written{ 0 };
+    std::atomic<int> seen{ -1 };
+    std::atomic<int> independent{ 0 };
+
+    uut.AddTask("write", [&written]() { std::this_thread::sleep_for(std::chrono::milliseconds(5)); written = 42; }, {}, {"value"});
+    for (int i = 0; i < 8; i++) {
+        uut.AddTask("other", [&independent]() { independent++; }, {}, {});
+    }
+    uut.AddTask("read", [&written, &seen]() { seen = written.load(); }, {"value"}, {});
+
+    for (int frame = 0; frame < 3; frame++) {
+        written = 0;
+        uut.Run(&threadPool);
+        EXPECT_EQ(42, seen.load());
+    }
+    EXPECT_EQ(24, independent.load());
+}
+
+TEST_F(TaskGraphTest, RunningAGraphDoesNotAllocate){
+    threadPool.SetThreadCount(4);
+    std::atomic<int> ran{ 0 };
+    // A chain whose successors are submitted from workers, and a fan out after it. The chain takes long enough for the
+    // workers to wake up and run it, instead of the thread waiting for the graph.
+    for (int i = 0; i < 8; i++) {
+        uut.AddTask("chain", [&ran]() { ran++; std::this_thread::sleep_for(std::chrono::microseconds(50)); }, {"chain"}, {"chain"});
+    }
+    for (int i = 0; i < 32; i++) {
+        uut.AddTask("fan", [&ran]() { ran++; }, {"chain"}, {});
+    }
+    uut.Run(&threadPool);
+
+    const size_t before = allocations.load();
+    for (int frame = 0; frame < 10; frame++) {
+        uut.Run(&threadPool);
+    }
+    EXPECT_EQ(before, allocations.load());
+    EXPECT_EQ(11 * 40, ran.load());
+}
+
+TEST_F(TaskGraphTest, RunsSeriallyWithoutPool){
+    std::vector<int> order;
+    uut.AddTask("a", [&order]() { order.push_back(0); }, {}, {"x"});
+    uut.AddTask("b", [&order]() { order.push_back(1); }, {"x"}, {});
+    uut.Run(nullptr);
+    EXPECT_EQ(std::vector<int>({0, 1}), order);
+}
+
+TEST_F(TaskGraphTest, DumpsGraphviz){
+    uut.AddTask("a", []() {}, {}, {"x"});
+    uut.AddTask("b", []() {}, {"x"}, {});
+    std::stringstream stream;
+    uut.DumpGraphviz(stream);
+    EXPECT_NE(std::string::npos, stream.str().find("t0 -> t1 [label=\"x\"]"));
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "../puffinEngine/src/TaskGraph.cpp"
+
+class TaskGraphTest : public ::testing::Test
+{
+public:
+    enginetool::ThreadPool threadPool;
+    enginetool::TaskGraph uut;
+};
\ No newline at end of file
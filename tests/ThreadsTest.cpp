@@ -0,0 +1,118 @@
+#include "ThreadsTest.hpp"
+
+TEST_F(ThreadsTest, RunsInlineWithoutWorkers){
+    int counter = 0;
+    uut.Submit([&counter]() { counter++; });
+    EXPECT_EQ(1, counter);
+}
+
+TEST_F(ThreadsTest, CounterWaitsForAllJobs){
+    uut.SetThreadCount(4);
+    std::atomic<int> counter{ 0 };
+    enginetool::JobCounter jobs;
+    for (int i = 0; i < 1000; i++) {
+        uut.Submit([&counter]() { counter++; }, jobs);
+    }
+    uut.Wait(jobs);
+    EXPECT_TRUE(jobs.IsDone());
+    EXPECT_EQ(1000, counter.load());
+}
+
+TEST_F(ThreadsTest, NestedJobsAreStolen){
+    uut.SetThreadCount(4);
+    std::atomic<int> counter{ 0 };
+    enginetool::JobCounter jobs;
+    for (int i = 0; i < 16; i++) {
+        uut.Submit([this, &counter, &jobs]() {
+            for (int j = 0; j < 16; j++) {
+                uut.Submit([&counter]() { counter++; }, jobs);
+            }
+        }, jobs);
+    }
+    uut.Wait(jobs);
+    EXPECT_EQ(256, counter.load());
+}
+
+TEST_F(ThreadsTest, LegacyAddJobAndHold){
+    uut.SetThreadCount(2);
+    std::atomic<int> counter{ 0 };
+    for (const std::unique_ptr<enginetool::Thread>& thread : uut.threads) {
+        thread->AddJob([&counter]() { counter++; });
+        thread->AddJob([&counter]() { counter++; });
+    }
+    uut.Hold();
+    EXPECT_EQ(4, counter.load());
+}
+
+TEST_F(ThreadsTest, ParallelForCoversRangeOnce){
+    std::vector<int> visits(10000, 0);
+    auto body = [&visits](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) visits[i]++;
+    };
+
+    enginetool::ParallelFor(&uut, 0, visits.size(), 64, body);
+    uut.SetThreadCount(4);
+    enginetool::ParallelFor(&uut, 0, visits.size(), 64, body);
+    enginetool::ParallelFor(nullptr, 0, visits.size(), 64, body);
+
+    for (const int count : visits) {
+        ASSERT_EQ(3, count);
+    }
+}
+
+TEST_F(ThreadsTest, ParallelForChunksDoNotDependOnThreadCount){
+    auto chunks = [this](uint32_t threadCount) {
+        uut.SetThreadCount(threadCount);
+        std::vector<size_t> chunkEnds(1000, 0);
+        enginetool::ParallelFor(&uut, 0, chunkEnds.size(), 37, [&chunkEnds](size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) chunkEnds[i] = last;
+        });
+        return chunkEnds;
+    };
+
+    EXPECT_EQ(chunks(1), chunks(3));
+    EXPECT_EQ(chunks(1), chunks(8));
+}
+
+TEST_F(ThreadsTest, BoundedQueueIsFifoAndRejectsWhenFull){
+    enginetool::BoundedQueue<int> queue(4);
+    for (int i = 0; i < 4; i++) {
+        int value = i;
+        EXPECT_TRUE(queue.TryPush(std::move(value)));
+    }
+    int extra = 4;
+    EXPECT_FALSE(queue.TryPush(std::move(extra)));
+
+    int value = -1;
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(queue.TryPop(value));
+        EXPECT_EQ(i, value);
+    }
+    EXPECT_FALSE(queue.TryPop(value));
+}
+
+TEST_F(ThreadsTest, AddJobRunsInlineWhenQueueIsFull){
+    uut.SetThreadCount(1);
+    std::atomic<int> counter{ 0 };
+    for (int i = 0; i < 5000; i++) {
+        uut.threads[0]->AddJob([&counter]() { counter++; });
+    }
+    uut.threads[0]->Wait();
+    EXPECT_EQ(5000, counter.load());
+}
+
+TEST_F(ThreadsTest, DequeOwnerPopsNewestAndThievesStealOldest){
+    enginetool::WorkStealingDeque<int> deque(4);
+    int values[5] = { 0, 1, 2, 3, 4 };
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(deque.TryPush(&values[i]));
+    }
+    EXPECT_FALSE(deque.TryPush(&values[4]));
+
+    EXPECT_EQ(&values[3], deque.TryPop());
+    EXPECT_EQ(&values[0], deque.TrySteal());
+    EXPECT_EQ(&values[2], deque.TryPop());
+    EXPECT_EQ(&values[1], deque.TrySteal());
+    EXPECT_EQ(nullptr, deque.TryPop());
+    EXPECT_EQ(nullptr, deque.TrySteal());
+}
\ No newline at end of file
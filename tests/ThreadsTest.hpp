@@ -0,0 +1,11 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "../puffinEngine/src/Threads.cpp"
+
+class ThreadsTest : public ::testing::Test
+{
+public:
+    enginetool::ThreadPool uut;
+};
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include <cstdio>
+#include <iterator>
+#include <random>
+
+#include "TriangleBvhTest.hpp"
+
+namespace {
+    // Positions with a padding float after each, like a vertex buffer with more than positions in it
+    struct Soup {
+        std::vector<float> vertices;
+        std::vector<uint32_t> indices;
+        static constexpr size_t stride = 4 * sizeof(float);
+    };
+
+    Soup RandomSoup(uint32_t seed, size_t triangleCount) {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> place(-50.0f, 50.0f);
+        std::uniform_real_distribution<float> offset(-4.0f, 4.0f);
+        Soup soup;
+        for (size_t i = 0; i < triangleCount; i++) {
+            const float center[3] = { place(random), place(random), place(random) };
+            for (int corner = 0; corner < 3; corner++) {
+                for (int axis = 0; axis < 3; axis++) soup.vertices.push_back(center[axis] + offset(random));
+                soup.vertices.push_back(0.0f);
+                soup.indices.push_back(static_cast<uint32_t>(soup.indices.size()));
+            }
+        }
+        // Indices in a shuffled order, so triangles are not just the vertices in a row
+        std::shuffle(soup.indices.begin(), soup.indices.end(), random);
+        return soup;
+    }
+
+    bool BruteForce(const Soup& soup, const float* origin, const float* direction, float minDistance, float maxDistance, float& distance) {
+        enginetool::TriangleBvh single;
+        bool found = false;
+        for (size_t i = 0; i < soup.indices.size(); i += 3) {
+            single.Build(soup.vertices.data(), Soup::stride, &soup.indices[i], 3);
+            float t;
+            if (single.Raycast(origin, direction, minDistance, maxDistance, t)) {
+                maxDistance = t;
+                found = true;
+            }
+        }
+        if (found) distance = maxDistance;
+        return found;
+    }
+}
+
+TEST_F(TriangleBvhTest, NearestHitMatchesBruteForce){
+    const Soup soup = RandomSoup(23, 300);
+    uut.Build(soup.vertices.data(), Soup::stride, soup.indices.data(), soup.indices.size());
+    ASSERT_EQ(300u, uut.GetTriangleCount());
+
+    std::mt19937 random(5);
+    std::uniform_real_distribution<float> place(-80.0f, 80.0f);
+    int hits = 0;
+    for (int i = 0; i < 500; i++) {
+        const float origin[3] = { place(random), place(random), place(random) };
+        const float direction[3] = { place(random), place(random), place(random) };
+        float expected = 0.0f, distance = 0.0f;
+        const bool expectedHit = BruteForce(soup, origin, direction, 0.0f, 1.0f, expected);
+        ASSERT_EQ(expectedHit, uut.Raycast(origin, direction, 0.0f, 1.0f, distance));
+        if (expectedHit) {
+            EXPECT_EQ(expected, distance);
+            hits++;
+        }
+    }
+    EXPECT_GT(hits, 50);
+}
+
+TEST_F(TriangleBvhTest, KeepsToDistanceWindow){
+    // Two floors, at heights 0 and 10, each of two triangles over x and z in [-1, 1]
+    const std::vector<float> vertices = {
+        -1.0f, 0.0f, -1.0f, 1.0f, 0.0f, -1.0f, 1.0f, 0.0f, 1.0f, -1.0f, 0.0f, 1.0f,
+        -1.0f, 10.0f, -1.0f, 1.0f, 10.0f, -1.0f, 1.0f, 10.0f, 1.0f, -1.0f, 10.0f, 1.0f };
+    const std::vector<uint32_t> indices = { 0, 1, 2, 0, 2, 3, 4, 6, 5, 4, 7, 6 };
+    uut.Build(vertices.data(), 3 * sizeof(float), indices.data(), indices.size());
+
+    const float origin[3] = { 0.25f, 5.0f, 0.5f };
+    const float down[3] = { 0.0f, -1.0f, 0.0f };
+    float distance = 0.0f;
+    ASSERT_TRUE(uut.Raycast(origin, down, 0.0f, 100.0f, distance));
+    EXPECT_FLOAT_EQ(5.0f, distance);
+    // Both faces count, and a negative start reaches the floor above
+    ASSERT_TRUE(uut.Raycast(origin, down, -100.0f, 100.0f, distance));
+    EXPECT_FLOAT_EQ(-5.0f, distance);
+    EXPECT_FALSE(uut.Raycast(origin, down, 0.0f, 4.0f, distance));
+    EXPECT_FALSE(uut.Raycast(origin, down, 5.5f, 100.0f, distance));
+
+    const float beside[3] = { 1.5f, 5.0f, 0.0f };
+    EXPECT_FALSE(uut.Raycast(beside, down, -100.0f, 100.0f, distance));
+}
+
+TEST_F(TriangleBvhTest, CacheOnlyLoadsForSameTriangles){
+    const std::string path = "triangleBvhTest.bvh";
+    const Soup soup = RandomSoup(7, 100);
+    uut.Build(soup.vertices.data(), Soup::stride, soup.indices.data(), soup.indices.size());
+    ASSERT_TRUE(uut.Save(path));
+
+    enginetool::TriangleBvh loaded;
+    ASSERT_TRUE(loaded.Load(path, soup.vertices.data(), Soup::stride, soup.indices.data(), soup.indices.size()));
+    EXPECT_EQ(uut.GetNodeCount(), loaded.GetNodeCount());
+    const float origin[3] = { -60.0f, 1.0f, 2.0f };
+    const float direction[3] = { 1.0f, 0.0f, 0.0f };
+    float expected = 0.0f, distance = 0.0f;
+    ASSERT_EQ(uut.Raycast(origin, direction, 0.0f, 200.0f, expected), loaded.Raycast(origin, direction, 0.0f, 200.0f, distance));
+    EXPECT_EQ(expected, distance);
+
+    // An edited mesh does not get the old hierarchy
+    Soup edited = soup;
+    edited.vertices[5] += 1.0f;
+    EXPECT_FALSE(loaded.Load(path, edited.vertices.data(), Soup::stride, edited.indices.data(), edited.indices.size()));
+
+    // Nor does a cut off file
+    std::vector<char> bytes;
+    {
+        std::ifstream file(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    ASSERT_GT(bytes.size(), 4u);
+    std::ofstream(path, std::ios::binary | std::ios::trunc).write(bytes.data(), bytes.size() - 4);
+    EXPECT_FALSE(loaded.Load(path, soup.vertices.data(), Soup::stride, soup.indices.data(), soup.indices.size()));
+    std::remove(path.c_str());
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "../puffinEngine/src/TriangleBvh.cpp"
+
+class TriangleBvhTest : public ::testing::Test
+{
+public:
+    enginetool::TriangleBvh uut;
+};
\ No newline at end of file